@@ -96,6 +96,7 @@ elseif(${CMAKE_CXX_COMPILER_ID} STREQUAL MSVC)
     #############################
     "/wd4061" # Enumerator 'identifier' in switch of enum 'enumeration' is not explicitly handled by a case label
     "/wd4265" # 'Class' : class has virtual functions, but destructor is not virtual
+    "/wd4324" # 'Struct': structure was padded due to alignment specifier, which is intended for cache line alignment
     "/wd4350" # Behavior change: 'member1' called instead of 'member2'
     "/wd4355" # 'This' : used in base member initializer list
     "/wd4365" # 'Action': conversion from 'type_1' to 'type_2', signed/unsigned mismatch
@@ -24,7 +24,6 @@
 #include <ableton/LinkAudio.hpp>
 #include <ableton/link_audio/Buffer.hpp>
 #include <ableton/link_audio/Queue.hpp>
-#include <ableton/util/FloatIntConversion.hpp>
 
 namespace ableton
 {
@@ -86,14 +85,9 @@ public:
   {
     // We can only send audio if the sink can provide a buffer to write to
     auto buffer = LinkAudioSink::BufferHandle(mSink);
-    if (buffer)
+    // The sink expects 16 bit integers so the doubles have to be converted
+    if (buffer && buffer.writeInterleaved(pSamples, numFrames, 1))
     {
-      // The sink expects 16 bit integers so the doubles have to be converted
-      for (auto i = 0u; i < numFrames; ++i)
-      {
-        buffer.samples[i] = ableton::util::floatToInt16(pSamples[i]);
-      }
-
       // The buffer is commited to Link Audio with the required timing information
       const auto beatsAtBufferBegin = sessionState.beatAtTime(hostTime, quantum);
       buffer.commit(sessionState,
@@ -357,11 +351,9 @@ public:
       buffer.mInfo = bufferHandle.info;
       buffer.mInfo.numChannels = 1;
 
-      for (auto i = 0u; i < bufferHandle.info.numFrames; ++i)
-      {
-        buffer.mSamples[i] = util::int16ToFloat<double>(
-          bufferHandle.samples[i * bufferHandle.info.numChannels]);
-      }
+      // Only the first channel is played
+      auto pSamples = buffer.mSamples.data();
+      bufferHandle.readPlanar(&pSamples, 1);
 
       mpQueueWriter->releaseSlot();
     }
@@ -42,6 +42,7 @@ struct State
   ableton::LinkAudio link;
   ableton::linkaudio::AudioPlatform<ableton::LinkAudio> audioPlatform;
   ableton::link::platform::ThreadPriority threadPriority;
+  ableton::link::platform::ThreadPriority audioThreadPriority;
 
   State(std::string name)
     : running(true)
@@ -244,11 +245,13 @@ void input(State& state)
       if (!state.link.isLinkAudioEnabled())
       {
         state.link.callOnLinkThread([&]() { state.threadPriority.setHigh(); });
+        state.link.callOnLinkAudioThread([&]() { state.audioThreadPriority.setHigh(); });
         state.link.enableLinkAudio(true);
       }
       else
       {
         state.link.callOnLinkThread([&]() { state.threadPriority.reset(); });
+        state.link.callOnLinkAudioThread([&]() { state.audioThreadPriority.reset(); });
         state.link.enableLinkAudio(false);
       }
       break;
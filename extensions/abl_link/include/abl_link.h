@@ -379,6 +379,17 @@ extern "C"
    */
   void abl_link_audio_set_peer_name(struct abl_link link, const char *name);
 
+  /*! @brief Call a function on the Link Audio thread.
+   *  Thread-safe: yes
+   *  Realtime-safe: no
+   *
+   *  @discussion The function will be called once on the Link Audio thread, which sends
+   *  and receives the audio channels. This is useful for setting the thread priority for
+   *  example.
+   */
+  void abl_link_audio_call_on_link_audio_thread(
+    struct abl_link link, void (*callback)(void *context), void *context);
+
   /*! @brief Identifier for Link Audio channels/peers/sessions. */
   struct abl_link_audio_channel_id
   {
@@ -424,6 +435,35 @@ extern "C"
   /*! @brief Free a channel list returned by abl_link_audio_get_channels. */
   void abl_link_audio_free_channel_list(struct abl_link_audio_channel_list list);
 
+  /*! @brief Network statistics of the connection to a peer that announces channels.
+   *
+   *  @discussion The round trip time is the mean of recent round trips, the jitter
+   *  their standard deviation.
+   */
+  struct abl_link_audio_peer_stats
+  {
+    struct abl_link_audio_peer_id peer_id;
+    int64_t round_trip_time_micros;
+    int64_t jitter_micros;
+  };
+
+  /*! @brief A list of Link Audio peer statistics. */
+  struct abl_link_audio_peer_stats_list
+  {
+    struct abl_link_audio_peer_stats *peers;
+    size_t count;
+  };
+
+  /*! @brief Get the network statistics of the peers providing channels.
+   *  Thread-safe: yes
+   *  Realtime-safe: no
+   */
+  struct abl_link_audio_peer_stats_list abl_link_audio_get_peer_stats(
+    struct abl_link link);
+
+  /*! @brief Free a list returned by abl_link_audio_get_peer_stats. */
+  void abl_link_audio_free_peer_stats_list(struct abl_link_audio_peer_stats_list list);
+
   /*! @brief Register a callback to be notified when the set of available
    *  audio channels changes. This will be called when channels are discovered or
    *  disappear and when names change.
@@ -482,6 +522,74 @@ extern "C"
    */
   size_t abl_link_audio_sink_max_num_samples(struct abl_link_audio_sink sink);
 
+  /*! @brief Set the maximum size in bytes of the network packets used to send audio.
+   *  The size is clamped to [576, 1200]. Larger packets reduce the packet rate. By
+   *  default sinks with up to 8 channels use 576 bytes and wider sinks 1200 bytes,
+   *  since a 576 byte packet holds only 3 frames of 64 channels.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  void abl_link_audio_sink_set_max_packet_size(
+    struct abl_link_audio_sink sink, size_t num_bytes);
+
+  /*! @brief Get the maximum size in bytes of the network packets used to send audio.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  size_t abl_link_audio_sink_max_packet_size(struct abl_link_audio_sink sink);
+
+  /*! @brief Enable sending the sink's audio to a multicast group. Subscribers that
+   *  can join the group receive it from there, so every packet is sent only once.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  void abl_link_audio_sink_set_multicast_enabled(
+    struct abl_link_audio_sink sink, bool is_enabled);
+
+  /*! @brief Whether the sink's audio is sent to a multicast group.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_sink_is_multicast_enabled(struct abl_link_audio_sink sink);
+
+  /*! @brief Send the audio of every commit right away instead of collecting it until
+   *  it fills a packet. This lowers latency at the cost of more and smaller packets.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  void abl_link_audio_sink_set_low_latency_enabled(
+    struct abl_link_audio_sink sink, bool is_enabled);
+
+  /*! @brief Whether the audio of every commit is sent right away.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_sink_is_low_latency_enabled(struct abl_link_audio_sink sink);
+
+  /*! @brief Counters of a sink since it was created.
+   *
+   *  @discussion Each counter is read atomically, but they are not a consistent
+   *  snapshot of one moment.
+   */
+  struct abl_link_audio_sink_stats
+  {
+    uint64_t num_committed_buffers;
+    uint64_t num_dropped_buffers; /*!< Retains that failed on a full queue. */
+    size_t max_num_queued_buffers;
+    uint64_t num_packets_sent;
+    uint64_t num_bytes_sent;
+    size_t num_receivers;
+    size_t num_multicast_receivers;
+    int64_t encode_time_nanos;
+  };
+
+  /*! @brief Get the counters of the sink.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  struct abl_link_audio_sink_stats abl_link_audio_sink_get_stats(
+    struct abl_link_audio_sink sink);
+
   /*! @brief Handle to a buffer for writing audio samples. */
   struct abl_link_audio_sink_buffer_handle
   {
@@ -505,6 +613,31 @@ extern "C"
   bool abl_link_audio_sink_buffer_is_valid(
     const struct abl_link_audio_sink_buffer_handle *handle);
 
+  /*! @brief Convert interleaved float samples in the range [-1, 1] to 16 bit and write
+   *  them to the buffer. num_frames * num_channels must not exceed max_num_samples.
+   *  Returns false if the handle is invalid or the samples don't fit.
+   *  Thread-safe: no
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_sink_buffer_write_interleaved_float(
+    struct abl_link_audio_sink_buffer_handle *handle,
+    const float *samples,
+    size_t num_frames,
+    size_t num_channels);
+
+  /*! @brief Convert planar float samples in the range [-1, 1] to 16 bit and write them
+   *  interleaved to the buffer. channels holds one pointer to num_frames samples per
+   *  channel. num_frames * num_channels must not exceed max_num_samples. Returns false
+   *  if the handle is invalid or the samples don't fit.
+   *  Thread-safe: no
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_sink_buffer_write_planar_float(
+    struct abl_link_audio_sink_buffer_handle *handle,
+    const float *const *channels,
+    size_t num_frames,
+    size_t num_channels);
+
   /*! @brief Commit a buffer after writing samples. The handle is invalid after this.
    *  num_frames * num_channels must not exceed max_num_samples. The session state,
    *  quantum, and beats_at_buffer_begin must match those used for rendering.
@@ -566,6 +699,34 @@ extern "C"
     struct abl_link_audio_source_buffer_info info;
   };
 
+  /*! @brief Convert channels of a received buffer to interleaved float samples.
+   *  samples receives info.num_frames * num_channels samples. source_channels optionally
+   *  holds the index of the received channel for each of the num_channels channels,
+   *  otherwise the first num_channels channels are converted. Returns false if the
+   *  buffer doesn't have the requested channels.
+   *  Thread-safe: no
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_source_buffer_read_interleaved_float(
+    const struct abl_link_audio_source_buffer *buffer,
+    float *samples,
+    size_t num_channels,
+    const size_t *source_channels);
+
+  /*! @brief Convert channels of a received buffer to separate float buffers. channels
+   *  holds one pointer to info.num_frames samples per channel. source_channels
+   *  optionally holds the index of the received channel for each of the num_channels
+   *  channels, otherwise the first num_channels channels are converted. Returns false
+   *  if the buffer doesn't have the requested channels.
+   *  Thread-safe: no
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_source_buffer_read_planar_float(
+    const struct abl_link_audio_source_buffer *buffer,
+    float *const *channels,
+    size_t num_channels,
+    const size_t *source_channels);
+
   /*! @brief The representation of an abl_link_audio_source instance */
   struct abl_link_audio_source
   {
@@ -582,9 +743,77 @@ extern "C"
     void (*callback)(const struct abl_link_audio_source_buffer *buffer, void *context),
     void *context);
 
+  /*! @brief Construct a Link Audio source that buffers the received audio for
+   *  abl_link_audio_source_read_interleaved_float and
+   *  abl_link_audio_source_read_planar_float instead of calling back.
+   *
+   *  @discussion The buffer holds 2^18 samples, which is about 2.7 seconds of stereo
+   *  audio at 48 kHz.
+   */
+  struct abl_link_audio_source abl_link_audio_source_create_playout(
+    struct abl_link link, struct abl_link_audio_channel_id channel_id);
+
   /*! @brief Destroy a Link Audio source. */
   void abl_link_audio_source_destroy(struct abl_link_audio_source source);
 
+  /*! @brief Set how far behind the session the audio read from a playout source is, in
+   *  beats. The default is 0, so it always has to be set.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  void abl_link_audio_source_set_playout_latency_beats(
+    struct abl_link_audio_source source, double beats);
+
+  /*! @brief Set how far behind the session the audio read from a playout source is, in
+   *  microseconds. Replaces a latency set in beats.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  void abl_link_audio_source_set_playout_latency_micros(
+    struct abl_link_audio_source source, int64_t latency_micros);
+
+  /*! @brief Render the audio of a playout source for an audio buffer of the
+   *  application. samples receives num_frames * num_channels interleaved samples.
+   *  source_channels optionally holds the index of the received channel for each of
+   *  the num_channels channels, otherwise the received channels are used in order.
+   *  Returns false and fills samples with silence if the audio isn't buffered or the
+   *  source was not created with abl_link_audio_source_create_playout.
+   *  Thread-safe: only one thread may read at a time
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_source_read_interleaved_float(struct abl_link_audio_source source,
+    abl_link_session_state session_state,
+    double quantum,
+    int64_t host_time_micros,
+    size_t num_frames,
+    size_t num_channels,
+    double sample_rate,
+    float *samples,
+    const size_t *source_channels);
+
+  /*! @brief Like abl_link_audio_source_read_interleaved_float, but channels holds one
+   *  pointer to num_frames samples per channel.
+   *  Thread-safe: only one thread may read at a time
+   *  Realtime-safe: yes
+   */
+  bool abl_link_audio_source_read_planar_float(struct abl_link_audio_source source,
+    abl_link_session_state session_state,
+    double quantum,
+    int64_t host_time_micros,
+    size_t num_frames,
+    size_t num_channels,
+    double sample_rate,
+    float *const *channels,
+    const size_t *source_channels);
+
+  /*! @brief The duration of the audio a playout source buffered ahead of the last read,
+   *  in microseconds.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  int64_t abl_link_audio_source_playout_buffered_time_micros(
+    struct abl_link_audio_source source);
+
   /*! @brief Get the channel ID of the corresponding source.
    *  Thread-safe: yes
    *  Realtime-safe: yes
@@ -592,6 +821,76 @@ extern "C"
   struct abl_link_audio_channel_id abl_link_audio_source_id(
     struct abl_link_audio_source source);
 
+  /*! @brief Counters of a source since it was created.
+   *
+   *  @discussion Each counter is read atomically, but they are not a consistent
+   *  snapshot of one moment. The decode time doesn't include the time spent in the
+   *  callback.
+   */
+  struct abl_link_audio_source_stats
+  {
+    uint64_t num_packets_received;
+    uint64_t num_bytes_received;
+    uint64_t num_parity_packets_received;
+    uint64_t num_recovered_buffers;
+    uint64_t num_lost_buffers;
+    uint64_t num_dropped_buffers; /*!< Duplicate or late buffers dropped. */
+    int64_t decode_time_nanos;
+  };
+
+  /*! @brief Get the counters of the source.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  struct abl_link_audio_source_stats abl_link_audio_source_get_stats(
+    struct abl_link_audio_source source);
+
+#define ABL_LINK_AUDIO_NUM_LATENCY_BINS 16
+
+  /*! @brief Histograms of the latencies of the audio received by a source.
+   *
+   *  @discussion Latencies are measured in the ghost time of the session. Bin i counts
+   *  the latencies below abl_link_audio_latency_bin_limit_micros(i) that don't fit into
+   *  bin i - 1, the last bin counts all longer latencies.
+   */
+  struct abl_link_audio_source_latencies
+  {
+    uint64_t commit_to_send[ABL_LINK_AUDIO_NUM_LATENCY_BINS];
+    uint64_t send_to_receive[ABL_LINK_AUDIO_NUM_LATENCY_BINS];
+    uint64_t receive_to_deliver[ABL_LINK_AUDIO_NUM_LATENCY_BINS];
+    uint64_t commit_to_deliver[ABL_LINK_AUDIO_NUM_LATENCY_BINS];
+  };
+
+  /*! @brief Get the histograms of the latencies of the audio received by the source.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  struct abl_link_audio_source_latencies abl_link_audio_source_get_latencies(
+    struct abl_link_audio_source source);
+
+  /*! @brief The exclusive upper limit of a latency bin in microseconds.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  int64_t abl_link_audio_latency_bin_limit_micros(size_t bin);
+
+  /*! @brief The playout latency recommended for the source from the measured delay and
+   *  jitter of its audio, in microseconds.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion It is 0 while nothing has been measured yet.
+   */
+  int64_t abl_link_audio_source_recommended_playout_latency_micros(
+    struct abl_link_audio_source source);
+
+  /*! @brief The recommended playout latency in beats at the tempo of the session state.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  double abl_link_audio_source_recommended_playout_latency_beats(
+    struct abl_link_audio_source source, abl_link_session_state session_state);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
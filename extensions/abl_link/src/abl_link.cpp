@@ -298,6 +298,13 @@ extern "C"
     reinterpret_cast<ableton::LinkAudio *>(link.impl)->setPeerName(name);
   }
 
+  void abl_link_audio_call_on_link_audio_thread(
+    struct abl_link link, void (*callback)(void *context), void *context)
+  {
+    reinterpret_cast<ableton::LinkAudio *>(link.impl)->callOnLinkAudioThread(
+      [callback, context]() { (*callback)(context); });
+  }
+
   struct abl_link_audio_channel_list abl_link_audio_get_channels(struct abl_link link)
   {
     struct abl_link_audio_channel_list result{};
@@ -342,6 +349,40 @@ extern "C"
     std::free(list.channels);
   }
 
+  struct abl_link_audio_peer_stats_list abl_link_audio_get_peer_stats(
+    struct abl_link link)
+  {
+    struct abl_link_audio_peer_stats_list result{};
+    const auto stats = reinterpret_cast<ableton::LinkAudio *>(link.impl)->peerStats();
+    result.count = stats.size();
+    if (result.count == 0)
+    {
+      return result;
+    }
+
+    result.peers = static_cast<struct abl_link_audio_peer_stats *>(
+      std::calloc(result.count, sizeof(struct abl_link_audio_peer_stats)));
+    if (!result.peers)
+    {
+      result.count = 0;
+      return result;
+    }
+
+    for (size_t i = 0; i < result.count; ++i)
+    {
+      result.peers[i].peer_id = toPeerId(stats[i].peerId);
+      result.peers[i].round_trip_time_micros = stats[i].roundTripTime.count();
+      result.peers[i].jitter_micros = stats[i].jitter.count();
+    }
+
+    return result;
+  }
+
+  void abl_link_audio_free_peer_stats_list(struct abl_link_audio_peer_stats_list list)
+  {
+    std::free(list.peers);
+  }
+
   void abl_link_audio_set_channels_changed_callback(
     struct abl_link link, void (*callback)(void *context), void *context)
   {
@@ -391,6 +432,57 @@ extern "C"
     return reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->maxNumSamples();
   }
 
+  void abl_link_audio_sink_set_max_packet_size(
+    struct abl_link_audio_sink sink, size_t num_bytes)
+  {
+    reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->setMaxPacketSize(num_bytes);
+  }
+
+  size_t abl_link_audio_sink_max_packet_size(struct abl_link_audio_sink sink)
+  {
+    return reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->maxPacketSize();
+  }
+
+  void abl_link_audio_sink_set_multicast_enabled(
+    struct abl_link_audio_sink sink, bool is_enabled)
+  {
+    reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->setMulticastEnabled(
+      is_enabled);
+  }
+
+  bool abl_link_audio_sink_is_multicast_enabled(struct abl_link_audio_sink sink)
+  {
+    return reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->isMulticastEnabled();
+  }
+
+  void abl_link_audio_sink_set_low_latency_enabled(
+    struct abl_link_audio_sink sink, bool is_enabled)
+  {
+    reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->setLowLatencyEnabled(
+      is_enabled);
+  }
+
+  bool abl_link_audio_sink_is_low_latency_enabled(struct abl_link_audio_sink sink)
+  {
+    return reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->isLowLatencyEnabled();
+  }
+
+  struct abl_link_audio_sink_stats abl_link_audio_sink_get_stats(
+    struct abl_link_audio_sink sink)
+  {
+    const auto stats = reinterpret_cast<ableton::LinkAudioSink *>(sink.impl)->stats();
+    struct abl_link_audio_sink_stats result{};
+    result.num_committed_buffers = stats.numCommittedBuffers;
+    result.num_dropped_buffers = stats.numDroppedBuffers;
+    result.max_num_queued_buffers = stats.maxNumQueuedBuffers;
+    result.num_packets_sent = stats.numPacketsSent;
+    result.num_bytes_sent = stats.numBytesSent;
+    result.num_receivers = stats.numReceivers;
+    result.num_multicast_receivers = stats.numMulticastReceivers;
+    result.encode_time_nanos = stats.encodeTime.count();
+    return result;
+  }
+
   struct abl_link_audio_sink_buffer_handle abl_link_audio_sink_retain_buffer(
     struct abl_link_audio_sink sink)
   {
@@ -415,6 +507,36 @@ extern "C"
     return static_cast<bool>(*cppHandle);
   }
 
+  bool abl_link_audio_sink_buffer_write_interleaved_float(
+    struct abl_link_audio_sink_buffer_handle *handle,
+    const float *samples,
+    size_t num_frames,
+    size_t num_channels)
+  {
+    if (!handle || !handle->impl || !samples)
+    {
+      return false;
+    }
+    auto *cppHandle =
+      reinterpret_cast<ableton::LinkAudioSink::BufferHandle *>(handle->impl);
+    return cppHandle->writeInterleaved(samples, num_frames, num_channels);
+  }
+
+  bool abl_link_audio_sink_buffer_write_planar_float(
+    struct abl_link_audio_sink_buffer_handle *handle,
+    const float *const *channels,
+    size_t num_frames,
+    size_t num_channels)
+  {
+    if (!handle || !handle->impl || !channels)
+    {
+      return false;
+    }
+    auto *cppHandle =
+      reinterpret_cast<ableton::LinkAudioSink::BufferHandle *>(handle->impl);
+    return cppHandle->writePlanar(channels, num_frames, num_channels);
+  }
+
   bool abl_link_audio_sink_buffer_commit(struct abl_link_audio_sink_buffer_handle *handle,
     abl_link_session_state session_state,
     double beats_at_buffer_begin,
@@ -521,6 +643,40 @@ extern "C"
     return true;
   }
 
+  bool abl_link_audio_source_buffer_read_interleaved_float(
+    const struct abl_link_audio_source_buffer *buffer,
+    float *samples,
+    size_t num_channels,
+    const size_t *source_channels)
+  {
+    if (!buffer || !buffer->samples || !samples)
+    {
+      return false;
+    }
+    auto cppHandle = ableton::LinkAudioSource::BufferHandle{};
+    cppHandle.samples = buffer->samples;
+    cppHandle.info.numChannels = buffer->info.num_channels;
+    cppHandle.info.numFrames = buffer->info.num_frames;
+    return cppHandle.readInterleaved(samples, num_channels, source_channels);
+  }
+
+  bool abl_link_audio_source_buffer_read_planar_float(
+    const struct abl_link_audio_source_buffer *buffer,
+    float *const *channels,
+    size_t num_channels,
+    const size_t *source_channels)
+  {
+    if (!buffer || !buffer->samples || !channels)
+    {
+      return false;
+    }
+    auto cppHandle = ableton::LinkAudioSource::BufferHandle{};
+    cppHandle.samples = buffer->samples;
+    cppHandle.info.numChannels = buffer->info.num_channels;
+    cppHandle.info.numFrames = buffer->info.num_frames;
+    return cppHandle.readPlanar(channels, num_channels, source_channels);
+  }
+
   struct abl_link_audio_source abl_link_audio_source_create(struct abl_link link,
     struct abl_link_audio_channel_id channel_id,
     void (*callback)(const struct abl_link_audio_source_buffer *buffer, void *context),
@@ -548,11 +704,106 @@ extern "C"
       }))};
   }
 
+  struct abl_link_audio_source abl_link_audio_source_create_playout(
+    struct abl_link link, struct abl_link_audio_channel_id channel_id)
+  {
+    auto *cppLink = reinterpret_cast<ableton::LinkAudio *>(link.impl);
+    return {reinterpret_cast<void *>(
+      new ableton::LinkAudioSource(*cppLink, toCppChannelId(channel_id)))};
+  }
+
   void abl_link_audio_source_destroy(struct abl_link_audio_source source)
   {
     delete reinterpret_cast<ableton::LinkAudioSource *>(source.impl);
   }
 
+  void abl_link_audio_source_set_playout_latency_beats(
+    struct abl_link_audio_source source, double beats)
+  {
+    if (source.impl)
+    {
+      reinterpret_cast<ableton::LinkAudioSource *>(source.impl)
+        ->setPlayoutLatencyInBeats(beats);
+    }
+  }
+
+  void abl_link_audio_source_set_playout_latency_micros(
+    struct abl_link_audio_source source, int64_t latency_micros)
+  {
+    if (source.impl)
+    {
+      reinterpret_cast<ableton::LinkAudioSource *>(source.impl)
+        ->setPlayoutLatency(std::chrono::microseconds{latency_micros});
+    }
+  }
+
+  bool abl_link_audio_source_read_interleaved_float(struct abl_link_audio_source source,
+    abl_link_session_state session_state,
+    double quantum,
+    int64_t host_time_micros,
+    size_t num_frames,
+    size_t num_channels,
+    double sample_rate,
+    float *samples,
+    const size_t *source_channels)
+  {
+    if (!source.impl)
+    {
+      std::fill_n(samples, num_frames * num_channels, 0.f);
+      return false;
+    }
+    return reinterpret_cast<ableton::LinkAudioSource *>(source.impl)
+      ->read(*reinterpret_cast<ableton::Link::SessionState *>(session_state.impl),
+        quantum,
+        std::chrono::microseconds{host_time_micros},
+        num_frames,
+        num_channels,
+        sample_rate,
+        samples,
+        source_channels);
+  }
+
+  bool abl_link_audio_source_read_planar_float(struct abl_link_audio_source source,
+    abl_link_session_state session_state,
+    double quantum,
+    int64_t host_time_micros,
+    size_t num_frames,
+    size_t num_channels,
+    double sample_rate,
+    float *const *channels,
+    const size_t *source_channels)
+  {
+    if (!source.impl)
+    {
+      for (size_t i = 0; i < num_channels; ++i)
+      {
+        std::fill_n(channels[i], num_frames, 0.f);
+      }
+      return false;
+    }
+    return reinterpret_cast<ableton::LinkAudioSource *>(source.impl)
+      ->readPlanar(*reinterpret_cast<ableton::Link::SessionState *>(session_state.impl),
+        quantum,
+        std::chrono::microseconds{host_time_micros},
+        num_frames,
+        num_channels,
+        sample_rate,
+        channels,
+        source_channels);
+  }
+
+  int64_t abl_link_audio_source_playout_buffered_time_micros(
+    struct abl_link_audio_source source)
+  {
+    if (!source.impl)
+    {
+      return 0;
+    }
+    return reinterpret_cast<ableton::LinkAudioSource *>(source.impl)
+      ->playoutBufferedTime()
+      .count();
+  }
+
   struct abl_link_audio_channel_id abl_link_audio_source_id(
     struct abl_link_audio_source source)
   {
@@ -563,4 +814,82 @@ extern "C"
     }
     return toChannelId(reinterpret_cast<ableton::LinkAudioSource *>(source.impl)->id());
   }
+
+  struct abl_link_audio_source_stats abl_link_audio_source_get_stats(
+    struct abl_link_audio_source source)
+  {
+    struct abl_link_audio_source_stats result{};
+    if (!source.impl)
+    {
+      return result;
+    }
+    const auto stats =
+      reinterpret_cast<ableton::LinkAudioSource *>(source.impl)->stats();
+    result.num_packets_received = stats.numPacketsReceived;
+    result.num_bytes_received = stats.numBytesReceived;
+    result.num_parity_packets_received = stats.numParityPacketsReceived;
+    result.num_recovered_buffers = stats.numRecoveredBuffers;
+    result.num_lost_buffers = stats.numLostBuffers;
+    result.num_dropped_buffers = stats.numDroppedBuffers;
+    result.decode_time_nanos = stats.decodeTime.count();
+    return result;
+  }
+
+  struct abl_link_audio_source_latencies abl_link_audio_source_get_latencies(
+    struct abl_link_audio_source source)
+  {
+    static_assert(ABL_LINK_AUDIO_NUM_LATENCY_BINS
+                    == ableton::LinkAudioSource::Latencies::kNumBins,
+                  "Unexpected number of latency bins");
+
+    struct abl_link_audio_source_latencies result{};
+    if (!source.impl)
+    {
+      return result;
+    }
+    const auto latencies =
+      reinterpret_cast<ableton::LinkAudioSource *>(source.impl)->latencies();
+    std::copy(latencies.commitToSend.begin(),
+              latencies.commitToSend.end(),
+              result.commit_to_send);
+    std::copy(latencies.sendToReceive.begin(),
+              latencies.sendToReceive.end(),
+              result.send_to_receive);
+    std::copy(latencies.receiveToDeliver.begin(),
+              latencies.receiveToDeliver.end(),
+              result.receive_to_deliver);
+    std::copy(latencies.commitToDeliver.begin(),
+              latencies.commitToDeliver.end(),
+              result.commit_to_deliver);
+    return result;
+  }
+
+  int64_t abl_link_audio_latency_bin_limit_micros(size_t bin)
+  {
+    return ableton::LinkAudioSource::Latencies::binLimit(bin).count();
+  }
+
+  int64_t abl_link_audio_source_recommended_playout_latency_micros(
+    struct abl_link_audio_source source)
+  {
+    if (!source.impl)
+    {
+      return 0;
+    }
+    return reinterpret_cast<ableton::LinkAudioSource *>(source.impl)
+      ->recommendedPlayoutLatency()
+      .count();
+  }
+
+  double abl_link_audio_source_recommended_playout_latency_beats(
+    struct abl_link_audio_source source, abl_link_session_state session_state)
+  {
+    if (!source.impl)
+    {
+      return 0.;
+    }
+    return reinterpret_cast<ableton::LinkAudioSource *>(source.impl)
+      ->recommendedPlayoutLatencyInBeats(
+        *reinterpret_cast<ableton::Link::SessionState *>(session_state.impl));
+  }
 }
@@ -26,6 +26,8 @@
 
 #include <ableton/link_audio/ApiConfig.hpp>
 
+#include <array>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <string>
@@ -119,6 +121,25 @@ public:
    */
   std::vector<Channel> channels() const;
 
+  /*! @struct PeerStats
+   *  @brief Network statistics of the connection to a peer that announces channels.
+   */
+  struct PeerStats
+  {
+    PeerId peerId;                           /*!< Identifier of the peer. */
+    std::chrono::microseconds roundTripTime; /*!< Mean of recent round trip times. */
+    std::chrono::microseconds jitter;        /*!< Deviation of recent round trip times. */
+  };
+
+  /*! @brief Get the network statistics of the peers providing channels.
+   *  Thread-safe: yes
+   *  Realtime-safe: no
+   *
+   *  @discussion The statistics are measured on the connection audio from a peer is
+   *  received on. They stay zero until the first round trips have been measured.
+   */
+  std::vector<PeerStats> peerStats() const;
+
   /*! @brief Call a function on the Link thread.
    *  Thread-safe: yes
    *  Realtime-safe: no
@@ -130,6 +151,18 @@ public:
   template <typename Function>
   void callOnLinkThread(Function func);
 
+  /*! @brief Call a function on the Link Audio thread.
+   *  Thread-safe: yes
+   *  Realtime-safe: no
+   *
+   *  @discussion The function will be called on the Link Audio thread, which is managed
+   *  by the LinkAudio instance and sends and receives the audio channels. This is useful
+   *  for setting the thread priority for example.
+   *  @param func The function signature is: void ()
+   */
+  template <typename Function>
+  void callOnLinkAudioThread(Function func);
+
 private:
   using Controller = ableton::link::ApiController<Clock>;
 
@@ -166,9 +199,15 @@ public:
    *  channel, and the maximum buffer size in samples. This buffer size should account for
    *  the number of channels times the number of samples per channel in one audio
    *  callback. Names longer than 256 characters will be truncated.
+   *
+   *  @discussion Committed buffers wait in a queue of queueDepth buffers until they are
+   *  sent. Memory for the queue is only allocated while peers receive the channel.
    */
   template <typename LinkAudio>
-  LinkAudioSink(LinkAudio& link, std::string name, size_t maxNumSamples);
+  LinkAudioSink(LinkAudio& link,
+                std::string name,
+                size_t maxNumSamples,
+                size_t queueDepth = link_audio::kDefaultSinkQueueDepth);
 
   LinkAudioSink(const LinkAudioSink&) = default;
   LinkAudioSink& operator=(const LinkAudioSink&) = default;
@@ -194,7 +233,8 @@ public:
    *
    *  @discussion Increase the number of samples retained buffer handles can hold. If the
    *  requested number of samples is smaller than the current maximum number of samples
-   *  this is a no-op.
+   *  this is a no-op. While peers receive the channel, the queue is reallocated, so one
+   *  buffer handle may be invalid.
    */
   void requestMaxNumSamples(size_t numSamples);
 
@@ -204,6 +244,109 @@ public:
    */
   size_t maxNumSamples() const;
 
+  /*! @brief Set the maximum size of the network packets used to send audio.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion The size in bytes covers the whole Link Audio message. It is clamped
+   *  to the range [576, 1200]. By default packets of sinks with up to 8 channels are
+   *  limited to 576 bytes, which every IPv4 node must be able to handle. Packets of
+   *  wider sinks use 1200 bytes by default: a 576 byte packet holds only 3 frames of
+   *  64 channels, a 1200 byte packet 8. Larger packets reduce the packet rate and
+   *  header overhead. Packets of up to 1200 bytes fit into the minimum MTU of IPv6
+   *  and into standard ethernet frames, so they are not fragmented on typical local
+   *  networks. Setting a size overrides the default for any number of channels.
+   */
+  void setMaxPacketSize(size_t numBytes);
+
+  /*! @brief Get the maximum size of the network packets used to send audio.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  size_t maxPacketSize() const;
+
+  /*! @brief Enable sending this sink's audio to a multicast group.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion By default a sink sends a copy of every packet to each subscribed
+   *  source. With multicast enabled, the sink announces an IPv4 multicast group for
+   *  its channel. Sources that are able to join the group receive the audio from it, so
+   *  the sink sends every packet only once per network interface, regardless of the
+   *  number of subscribers. Sources that can't join the group, and peers that don't
+   *  support multicast, keep receiving unicast packets.
+   */
+  void setMulticastEnabled(bool isEnabled);
+
+  /*! @brief Whether this sink's audio is sent to a multicast group.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  bool isMulticastEnabled() const;
+
+  /*! @brief Protect this sink's audio with forward error correction.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion After every groupSize packets, the sink sends one parity packet. A
+   *  source that misses a single packet of the group rebuilds it from the others,
+   *  without waiting for a retransmission. This costs 1 / groupSize of additional
+   *  bandwidth. A rebuilt packet is delivered once the parity arrives, which is up to
+   *  groupSize packets late. The group size is clamped to [2, 16]. A group size of zero
+   *  disables forward error correction, which is the default. Audio packets get
+   *  smaller by a few bytes per group member, so that parity packets don't exceed the
+   *  maximum packet size either.
+   */
+  void setFecGroupSize(size_t groupSize);
+
+  /*! @brief The number of packets protected by one parity packet, or zero.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  size_t fecGroupSize() const;
+
+  /*! @brief Send every committed buffer right away.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion By default committed audio is collected until it fills a packet, which
+   *  delays it by up to one packet's worth of audio. With low latency enabled, the
+   *  audio of each commit is sent as soon as the Link thread picks it up, with the last
+   *  packet only partially filled. This suits live monitoring, at the cost of more and
+   *  smaller packets, especially for small buffer sizes.
+   */
+  void setLowLatencyEnabled(bool isEnabled);
+
+  /*! @brief Whether every committed buffer is sent right away.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  bool isLowLatencyEnabled() const;
+
+  /*! @struct Stats
+   *  @brief Counters of a sink since it was created.
+   */
+  struct Stats
+  {
+    uint64_t numCommittedBuffers;        /*!< Buffers committed by the audio thread. */
+    uint64_t numDroppedBuffers;          /*!< Retains that failed on a full queue. */
+    size_t maxNumQueuedBuffers;          /*!< Most buffers queued at once. */
+    uint64_t numPacketsSent;             /*!< Datagrams sent to all receivers. */
+    uint64_t numBytesSent;               /*!< Bytes of the datagrams sent. */
+    size_t numReceivers;                 /*!< Peers currently receiving the channel. */
+    size_t numMulticastReceivers;        /*!< Receivers sharing multicast datagrams. */
+    std::chrono::nanoseconds encodeTime; /*!< Time spent encoding committed buffers. */
+  };
+
+  /*! @brief Get the counters of the sink.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion Each counter is read atomically, but they are not a consistent
+   *  snapshot of one moment.
+   */
+  Stats stats() const;
+
   /*! @struct BufferHandle
    *  @brief Handle to a buffer for writing audio samples.
    */
@@ -235,6 +378,39 @@ public:
     int16_t* samples;     /*!< Pointer to the buffer for writing samples. */
     size_t maxNumSamples; /*!< Maximum number of samples that can be written. */
 
+    /*! @brief Convert interleaved floating point samples in the range [-1, 1] and write
+     *  them to the buffer. Samples outside of this range are clipped.
+     *  @param pSamples Interleaved float or double samples.
+     *  @param numFrames Number of frames to write. numFrames * numChannels may not
+     *  exceed maxNumSamples.
+     *  @param numChannels Number of interleaved channels.
+     *  @return True if the samples were written.
+     *
+     *  Thread-safe: no
+     *  Realtime-safe: yes
+     *
+     *  @discussion The conversion uses vector instructions where available. The same
+     *  numFrames and numChannels have to be passed to commit.
+     */
+    template <typename T>
+    bool writeInterleaved(const T* pSamples, size_t numFrames, size_t numChannels);
+
+    /*! @brief Convert planar floating point samples in the range [-1, 1] and write them
+     *  interleaved to the buffer. Samples outside of this range are clipped.
+     *  @param ppChannels One pointer per channel to numFrames float or double samples.
+     *  @param numFrames Number of frames to write. numFrames * numChannels may not
+     *  exceed maxNumSamples.
+     *  @param numChannels Number of channels.
+     *  @return True if the samples were written.
+     *
+     *  Thread-safe: no
+     *  Realtime-safe: yes
+     *
+     *  @discussion The conversion uses vector instructions where available. The same
+     *  numFrames and numChannels have to be passed to commit.
+     */
+    template <typename T>
+    bool writePlanar(const T* const* ppChannels, size_t numFrames, size_t numChannels);
 
     /*! @brief Commit the buffer after writing samples. After this the buffer the object
      *  should not be used anymore.
@@ -243,7 +419,7 @@ public:
      *  @param quantum Quantum value for beat mapping.
      *  @param numFrames Number of frames written. numFrames * numChannels may not exceed
      *  maxNumSamples.
-     *  @param numChannels Number of channels. Can be 1 for mono or 2 for stereo.
+     *  @param numChannels Number of channels, from 1 up to 64.
      *  @param sampleRate Sample rate in Hz.
      *  @return True if the buffer was successfully committed.
      *
@@ -253,6 +429,9 @@ public:
      *  @discussion The Link session state, the quantum, and the beats at buffer begin
      *  must be same as used for rendering the audio locally. Changes to the Link session
      *  state should always be made before rendering and eventually writing the buffer.
+     *  All channels of a sink share the packets they are sent in, so a multichannel sink
+     *  costs less bandwidth and bookkeeping than a mono sink per channel. As every packet
+     *  holds fewer frames of many channels, a larger maximum packet size is worthwhile.
      */
     template <typename SessionState>
     bool commit(const SessionState&,
@@ -264,7 +443,7 @@ public:
 
   private:
     std::weak_ptr<link_audio::Sink> mpSink;
-    link_audio::Buffer<int16_t>* mpBuffer;
+    link_audio::Sink::SinkBuffer* mpBuffer;
   };
 
 private:
@@ -293,6 +472,18 @@ public:
   template <typename LinkAudio, typename Callback>
   LinkAudioSource(LinkAudio& link, ChannelId id, Callback callback);
 
+  /*! @brief Construct a LinkAudioSource that buffers the received audio for read().
+   *  @param link The LinkAudio instance.
+   *  @param id The ID of the channel to be received.
+   *
+   *  @discussion Received audio is written to a lock-free buffer on the Link thread
+   *  without calling back into the application. The buffer holds 2^18 samples, which
+   *  is about 2.7 seconds of stereo audio at 48 kHz, proportionally less with more
+   *  channels or higher sample rates.
+   */
+  template <typename LinkAudio>
+  LinkAudioSource(LinkAudio& link, ChannelId id);
+
   LinkAudioSource(const LinkAudioSource&) = default;
   LinkAudioSource& operator=(const LinkAudioSource&) = default;
   LinkAudioSource(LinkAudioSource&&) = default;
@@ -306,6 +497,233 @@ public:
    */
   ChannelId id() const;
 
+  /*! @brief Receive the channel at a quarter of the bandwidth.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion Audio is sent with lossy 4 bit ADPCM in packets that hold four times
+   *  as many frames, which adds latency accordingly. This suits weak network links
+   *  where an exact copy of the audio is not required, e.g. for monitoring. By default
+   *  audio is received as uncompressed PCM. Sinks that don't support ADPCM keep
+   *  sending PCM. Takes precedence over lossless compression. Sources of the same
+   *  channel share one stream, which is only sent with ADPCM if all of them enable
+   *  low bandwidth.
+   */
+  void setLowBandwidthEnabled(bool isEnabled);
+
+  /*! @brief Whether the channel is received at a quarter of the bandwidth.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  bool isLowBandwidthEnabled() const;
+
+  /*! @brief Receive the channel with lossless compression.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion Audio is sent with lossless LPC coding, which typically needs about
+   *  half the bandwidth of PCM. Packets collect up to twice as many frames, which adds
+   *  up to one packet of latency, and the sink spends time encoding. By default audio
+   *  is received as uncompressed PCM. Sinks that don't support LPC keep sending PCM.
+   *  Sources of the same channel share one stream, which is sent as PCM if any of them
+   *  receives PCM.
+   */
+  void setLosslessCompressionEnabled(bool isEnabled);
+
+  /*! @brief Whether the channel is received with lossless compression.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  bool isLosslessCompressionEnabled() const;
+
+  /*! @brief Replace lost buffers with concealment audio.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion Buffers are always delivered in order of their count, duplicates are
+   *  dropped and buffers that never arrive are counted as lost. With concealment
+   *  enabled every lost buffer is replaced by one of about the same duration, which
+   *  continues the waveform before the gap and crossfades into the audio after it.
+   *  Concealed buffers are marked in their Info. By default lost buffers are skipped.
+   *  Other sources of the same channel don't receive the concealed buffers unless
+   *  they enable concealment too.
+   */
+  void setLossConcealmentEnabled(bool isEnabled);
+
+  /*! @brief Whether lost buffers are replaced with concealment audio.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  bool isLossConcealmentEnabled() const;
+
+  /*! @brief The number of buffers that were lost since the source was created.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  uint64_t numLostBuffers() const;
+
+  /*! @struct Stats
+   *  @brief Counters of a source since it was created.
+   */
+  struct Stats
+  {
+    uint64_t numPacketsReceived;               /*!< Audio and parity packets received. */
+    uint64_t numBytesReceived;                 /*!< Payload bytes of those packets. */
+    uint64_t numParityPacketsReceived;         /*!< Parity packets received. */
+    uint64_t numRecoveredBuffers;              /*!< Buffers rebuilt from parity. */
+    uint64_t numLostBuffers;                   /*!< Buffers that never arrived. */
+    uint64_t numDroppedBuffers;                /*!< Duplicate or late buffers dropped. */
+    std::chrono::nanoseconds decodeTime;       /*!< Time spent decoding received audio. */
+    std::chrono::microseconds maxBufferedTime; /*!< Most audio buffered for read(). */
+  };
+
+  /*! @brief Get the counters of the source.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion Each counter is read atomically, but they are not a consistent
+   *  snapshot of one moment. The decode time doesn't include the time spent in the
+   *  callback. The buffered time is only measured for sources without a callback.
+   */
+  Stats stats() const;
+
+  /*! @struct Latencies
+   *  @brief Histograms of the latencies of the received audio.
+   *
+   *  @discussion Latencies are measured in the ghost time of the session, which all
+   *  peers share, so they include the stages on the sending peer. Bin i counts the
+   *  latencies below binLimit(i) that don't fit into bin i - 1. The first bin ends at
+   *  125 microseconds and every further bin is twice as wide as the one before. The
+   *  last bin counts all longer latencies.
+   */
+  struct Latencies
+  {
+    static constexpr size_t kNumBins = 16;
+    using Counts = std::array<uint64_t, kNumBins>;
+
+    Counts commitToSend;     /*!< From the commit of a buffer to sending it. */
+    Counts sendToReceive;    /*!< From sending to receiving it. */
+    Counts receiveToDeliver; /*!< From receiving to the callback or playout buffer. */
+    Counts commitToDeliver;  /*!< From the commit to the callback or playout buffer. */
+
+    /*! @brief The exclusive upper limit of a bin. */
+    static std::chrono::microseconds binLimit(size_t bin);
+  };
+
+  /*! @brief Get the histograms of the latencies of the received audio.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion Only buffers whose sink is on a peer that supports measuring latency
+   *  are counted. The commit time of audio that spans several commits is the one of
+   *  the last commit. Each count is read atomically, but the histograms are not a
+   *  consistent snapshot of one moment.
+   */
+  Latencies latencies() const;
+
+  /*! @brief The playout latency recommended for the source from the measured delay and
+   *  jitter of its audio.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion The delay and jitter from the commit of the audio on the sending peer
+   *  to its arrival here are estimated with every received buffer. The recommendation
+   *  covers the delay plus four times its jitter, plus the time buffers that arrive
+   *  after a lost one are held back to wait for it. Until buffers with timing arrive it
+   *  is estimated from the round trip times to the sending peer, which don't cover its
+   *  buffering. It is 0 while nothing has been measured yet. Applications that read
+   *  from the playout buffer have to add the time between calling read() and the host
+   *  time they pass to it, plus the duration of their buffer.
+   */
+  std::chrono::microseconds recommendedPlayoutLatency() const;
+
+  /*! @brief The recommended playout latency in beats at the tempo of the session state.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  template <typename SessionState>
+  double recommendedPlayoutLatencyInBeats(const SessionState& sessionState) const;
+
+  /*! @brief Set how far behind the session the audio returned by read() is, in beats.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion The latency has to cover the time audio takes from the sending peer
+   *  to this one, including the buffering on both ends. Audio that arrives later than
+   *  that is not played. The default is 0, so it always has to be set.
+   */
+  void setPlayoutLatencyInBeats(double beats);
+
+  /*! @brief Set how far behind the session the audio returned by read() is, in time.
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   *
+   *  @discussion Replaces a latency set in beats. Unlike a latency in beats, it
+   *  doesn't change with the tempo.
+   */
+  void setPlayoutLatency(std::chrono::microseconds latency);
+
+  /*! @brief Render the received audio for an audio buffer of the application.
+   *  Thread-safe: only one thread may read at a time
+   *  Realtime-safe: yes
+   *
+   *  @param sessionState The current Link session state.
+   *  @param quantum Quantum value for beat mapping.
+   *  @param hostTime The host time at the begin of the buffer.
+   *  @param numFrames The number of frames to render.
+   *  @param numChannels The number of interleaved channels of pOut. Mono audio is
+   *  copied to all channels, additional channels of the audio are left out.
+   *  @param sampleRate The sample rate of the application.
+   *  @param pOut Receives numFrames * numChannels samples.
+   *  @param pChannels Optional index of the received channel for each of the
+   *  numChannels channels of pOut, e.g. to pick a pair of a multichannel stream. By
+   *  default the received channels are used in order.
+   *  @return Whether audio was rendered. If the audio for the beat range of the buffer
+   *  isn't buffered, pOut is filled with silence.
+   *
+   *  @discussion Only available for sources constructed without a callback. The audio
+   *  of the beat range the buffer spans, delayed by the playout latency, is resampled
+   *  to fill the buffer. This follows tempo changes and differences in sample rate.
+   *  Reading is wait-free and doesn't allocate memory. Indices past the last received
+   *  channel use the last one.
+   */
+  template <typename SessionState>
+  bool read(const SessionState& sessionState,
+            double quantum,
+            std::chrono::microseconds hostTime,
+            size_t numFrames,
+            size_t numChannels,
+            double sampleRate,
+            float* pOut,
+            const size_t* pChannels = nullptr);
+
+  /*! @brief Render the received audio to separate channel buffers.
+   *  Thread-safe: only one thread may read at a time
+   *  Realtime-safe: yes
+   *
+   *  @param ppOut One buffer of numFrames samples for each of the numChannels
+   *  channels.
+   *  @param pChannels Optional index of the received channel for each buffer of ppOut.
+   *  By default the received channels are used in order.
+   *
+   *  @discussion Like read(), but without interleaving the output.
+   */
+  template <typename SessionState>
+  bool readPlanar(const SessionState& sessionState,
+                  double quantum,
+                  std::chrono::microseconds hostTime,
+                  size_t numFrames,
+                  size_t numChannels,
+                  double sampleRate,
+                  float* const* ppOut,
+                  const size_t* pChannels = nullptr);
+
+  /*! @brief The duration of the audio buffered ahead of the last read().
+   *  Thread-safe: yes
+   *  Realtime-safe: yes
+   */
+  std::chrono::microseconds playoutBufferedTime() const;
+
   /*! @struct BufferHandle
    *  @brief Handle to a buffer containing received audio samples.
    */
@@ -323,6 +741,7 @@ public:
       double sessionBeatTime; /*!< Use beginBeats() to map this to local beat time. */
       double tempo;           /*!< Tempo in beats per minute. */
       SessionId sessionId;    /*!< ID of the session the buffer belongs to. */
+      bool isConcealed;       /*!< Whether the buffer replaces a lost one. */
 
       /*! @brief Map the beat time at the begin of the buffer to the local Link session
        *  state.
@@ -345,11 +764,53 @@ public:
       std::optional<double> endBeats(const SessionState&, double quantum) const;
     };
 
-    int16_t* samples; /*!< Pointer to the buffer of received samples. */
+    /*! @brief Convert channels of the buffer to interleaved floating point samples.
+     *  @param pOut Receives info.numFrames * numChannels float or double samples.
+     *  @param numChannels Number of channels to write to pOut.
+     *  @param pChannels Optional index of the received channel for each channel of
+     *  pOut. By default the first numChannels channels are converted.
+     *  @return False if the buffer doesn't have the requested channels.
+     *
+     *  Thread-safe: no
+     *  Realtime-safe: yes
+     */
+    template <typename T>
+    bool readInterleaved(T* pOut,
+                         size_t numChannels,
+                         const size_t* pChannels = nullptr) const;
+
+    /*! @brief Convert channels of the buffer to separate floating point buffers.
+     *  @param ppOut One buffer of info.numFrames float or double samples for each of
+     *  the numChannels channels.
+     *  @param numChannels Number of channel buffers in ppOut.
+     *  @param pChannels Optional index of the received channel for each buffer of
+     *  ppOut. By default the first numChannels channels are converted.
+     *  @return False if the buffer doesn't have the requested channels.
+     *
+     *  Thread-safe: no
+     *  Realtime-safe: yes
+     */
+    template <typename T>
+    bool readPlanar(T* const* ppOut,
+                    size_t numChannels,
+                    const size_t* pChannels = nullptr) const;
+
+    int16_t* samples; /*!< Pointer to the interleaved received samples. */
     Info info;        /*!< Information about the buffer. */
+
+  private:
+    bool hasChannels(size_t numChannels, const size_t* pChannels) const;
   };
 
 private:
+  template <typename SessionState>
+  bool render(const SessionState& sessionState,
+              double quantum,
+              std::chrono::microseconds hostTime,
+              size_t numFrames,
+              double sampleRate,
+              const link_audio::PlayoutBuffer::Output& output);
+
   std::shared_ptr<link_audio::Source> mpImpl;
 };
 
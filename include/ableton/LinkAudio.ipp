@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <ableton/util/FloatIntConversion.hpp>
+#include <algorithm>
 #include <string>
 
 namespace ableton
@@ -94,6 +96,21 @@ inline std::vector<typename BasicLinkAudio<Clock>::Channel> BasicLinkAudio<
   return result;
 }
 
+template <typename Clock>
+inline std::vector<typename BasicLinkAudio<Clock>::PeerStats> BasicLinkAudio<
+  Clock>::peerStats() const
+{
+  auto stats = this->mController.peerNetworkStats();
+  auto result = std::vector<typename BasicLinkAudio<Clock>::PeerStats>{};
+  result.reserve(stats.size());
+  for (auto& peer : stats)
+  {
+    result.push_back(typename BasicLinkAudio<Clock>::PeerStats{
+      peer.peerId, peer.roundTripTime, peer.jitter});
+  }
+  return result;
+}
+
 template <typename Clock>
 template <typename Function>
 inline void BasicLinkAudio<Clock>::callOnLinkThread(Function func)
@@ -101,14 +118,23 @@ inline void BasicLinkAudio<Clock>::callOnLinkThread(Function func)
   this->mController.callOnLinkThread(std::move(func));
 }
 
+template <typename Clock>
+template <typename Function>
+inline void BasicLinkAudio<Clock>::callOnLinkAudioThread(Function func)
+{
+  this->mController.callOnLinkAudioThread(std::move(func));
+}
+
 template <typename LinkAudio>
 inline LinkAudioSink::LinkAudioSink(LinkAudio& link,
                                     std::string name,
-                                    size_t maxNumSamples)
+                                    size_t maxNumSamples,
+                                    size_t queueDepth)
   : mpImpl{link.mController.addSink(name.size() > link_audio::v1::kMaxNameSize
                                       ? name.substr(0, link_audio::v1::kMaxNameSize)
                                       : std::move(name),
-                                    maxNumSamples)}
+                                    maxNumSamples,
+                                    queueDepth)}
 {
 }
 
@@ -159,6 +185,35 @@ inline LinkAudioSink::BufferHandle::operator bool() const
   return mpBuffer != nullptr;
 }
 
+template <typename T>
+inline bool LinkAudioSink::BufferHandle::writeInterleaved(const T* pSamples,
+                                                          const size_t numFrames,
+                                                          const size_t numChannels)
+{
+  const auto numSamples = numFrames * numChannels;
+  if (!*this || numSamples > maxNumSamples)
+  {
+    return false;
+  }
+
+  util::floatToInt16(pSamples, samples, numSamples);
+  return true;
+}
+
+template <typename T>
+inline bool LinkAudioSink::BufferHandle::writePlanar(const T* const* ppChannels,
+                                                     const size_t numFrames,
+                                                     const size_t numChannels)
+{
+  if (!*this || numFrames * numChannels > maxNumSamples)
+  {
+    return false;
+  }
+
+  util::planarFloatToInterleavedInt16(ppChannels, samples, numFrames, numChannels);
+  return true;
+}
+
 template <typename SessionState>
 inline bool LinkAudioSink::BufferHandle::commit(const SessionState& sessionState,
                                                 const double beatsAtBufferBegin,
@@ -167,7 +222,8 @@ inline bool LinkAudioSink::BufferHandle::commit(const SessionState& sessionState
                                                 const size_t numChannels,
                                                 const uint32_t sampleRate)
 {
-  const auto result = static_cast<bool>(*this) && (numChannels == 1 || numChannels == 2)
+  const auto result = static_cast<bool>(*this) && numChannels >= 1
+                      && numChannels <= link_audio::v1::kMaxNumChannels
                       && maxNumSamples >= numFrames * numChannels;
 
   if (result && mpBuffer)
@@ -224,6 +280,61 @@ inline std::optional<double> LinkAudioSource::BufferHandle::Info::endBeats(
 }
 
 
+inline bool LinkAudioSource::BufferHandle::hasChannels(const size_t numChannels,
+                                                       const size_t* pChannels) const
+{
+  if (!pChannels)
+  {
+    return numChannels <= info.numChannels;
+  }
+  return std::all_of(pChannels,
+                     pChannels + numChannels,
+                     [&](const size_t channel) { return channel < info.numChannels; });
+}
+
+template <typename T>
+inline bool LinkAudioSource::BufferHandle::readInterleaved(T* pOut,
+                                                           const size_t numChannels,
+                                                           const size_t* pChannels) const
+{
+  if (!hasChannels(numChannels, pChannels))
+  {
+    return false;
+  }
+
+  if (!pChannels && numChannels == info.numChannels)
+  {
+    util::int16ToFloat(samples, pOut, info.numFrames * numChannels);
+    return true;
+  }
+
+  for (auto frame = size_t{0}; frame < info.numFrames; ++frame)
+  {
+    for (auto channel = size_t{0}; channel < numChannels; ++channel)
+    {
+      const auto sourceChannel = pChannels ? pChannels[channel] : channel;
+      *pOut++ =
+        util::int16ToFloat<T>(samples[frame * info.numChannels + sourceChannel]);
+    }
+  }
+  return true;
+}
+
+template <typename T>
+inline bool LinkAudioSource::BufferHandle::readPlanar(T* const* ppOut,
+                                                      const size_t numChannels,
+                                                      const size_t* pChannels) const
+{
+  if (!hasChannels(numChannels, pChannels))
+  {
+    return false;
+  }
+
+  util::interleavedInt16ToPlanarFloat(
+    samples, ppOut, info.numFrames, info.numChannels, pChannels, numChannels);
+  return true;
+}
+
 template <typename LinkAudio, typename Callback>
 inline LinkAudioSource::LinkAudioSource(LinkAudio& link, ChannelId id, Callback callback)
   : mpImpl{link.mController.addSource(
@@ -238,12 +349,19 @@ inline LinkAudioSource::LinkAudioSource(LinkAudio& link, ChannelId id, Callback
         info.sessionBeatTime = handle.mBuffer.mBeginBeats.floating();
         info.tempo = handle.mBuffer.mTempo.bpm();
         info.sessionId = handle.mBuffer.mSessionId;
+        info.isConcealed = handle.mBuffer.mIsConcealed;
 
         callback(LinkAudioSource::BufferHandle{handle.mpSamples, info});
       })}
 {
 }
 
+template <typename LinkAudio>
+inline LinkAudioSource::LinkAudioSource(LinkAudio& link, ChannelId id)
+  : mpImpl{link.mController.addSource(std::move(id), nullptr)}
+{
+}
+
 inline LinkAudioSource::~LinkAudioSource()
 {
   mpImpl->setCallback([](auto) {});
@@ -259,9 +377,236 @@ inline size_t LinkAudioSink::maxNumSamples() const
   return mpImpl->maxNumSamples();
 }
 
+inline void LinkAudioSink::setMaxPacketSize(size_t numBytes)
+{
+  mpImpl->setMaxMessageSize(numBytes);
+}
+
+inline size_t LinkAudioSink::maxPacketSize() const
+{
+  return mpImpl->maxMessageSize();
+}
+
+inline void LinkAudioSink::setMulticastEnabled(bool isEnabled)
+{
+  mpImpl->setMulticastEnabled(isEnabled);
+}
+
+inline bool LinkAudioSink::isMulticastEnabled() const
+{
+  return mpImpl->isMulticastEnabled();
+}
+
+inline void LinkAudioSink::setFecGroupSize(size_t groupSize)
+{
+  mpImpl->setFecGroupSize(groupSize);
+}
+
+inline size_t LinkAudioSink::fecGroupSize() const
+{
+  return mpImpl->fecGroupSize();
+}
+
+inline void LinkAudioSink::setLowLatencyEnabled(bool isEnabled)
+{
+  mpImpl->setLowLatencyEnabled(isEnabled);
+}
+
+inline bool LinkAudioSink::isLowLatencyEnabled() const
+{
+  return mpImpl->isLowLatencyEnabled();
+}
+
+inline LinkAudioSink::Stats LinkAudioSink::stats() const
+{
+  const auto stats = mpImpl->stats();
+  return {stats.numCommittedBuffers,
+          stats.numDroppedBuffers,
+          stats.maxNumQueuedBuffers,
+          stats.numPacketsSent,
+          stats.numBytesSent,
+          stats.numReceivers,
+          stats.numMulticastReceivers,
+          stats.encodeTime};
+}
+
 inline ChannelId LinkAudioSource::id() const
 {
   return mpImpl->id();
 }
 
+inline void LinkAudioSource::setLowBandwidthEnabled(bool isEnabled)
+{
+  mpImpl->setLowBandwidthEnabled(isEnabled);
+}
+
+inline bool LinkAudioSource::isLowBandwidthEnabled() const
+{
+  return mpImpl->isLowBandwidthEnabled();
+}
+
+inline void LinkAudioSource::setLosslessCompressionEnabled(bool isEnabled)
+{
+  mpImpl->setLosslessCompressionEnabled(isEnabled);
+}
+
+inline bool LinkAudioSource::isLosslessCompressionEnabled() const
+{
+  return mpImpl->isLosslessCompressionEnabled();
+}
+
+inline void LinkAudioSource::setLossConcealmentEnabled(bool isEnabled)
+{
+  mpImpl->setLossConcealmentEnabled(isEnabled);
+}
+
+inline bool LinkAudioSource::isLossConcealmentEnabled() const
+{
+  return mpImpl->isLossConcealmentEnabled();
+}
+
+inline uint64_t LinkAudioSource::numLostBuffers() const
+{
+  return mpImpl->numLostBuffers();
+}
+
+inline LinkAudioSource::Stats LinkAudioSource::stats() const
+{
+  const auto stats = mpImpl->stats();
+  return {stats.numPacketsReceived,
+          stats.numBytesReceived,
+          stats.numParityPacketsReceived,
+          stats.numRecoveredBuffers,
+          stats.numLostBuffers,
+          stats.numDroppedBuffers,
+          stats.decodeTime,
+          stats.maxBufferedTime};
+}
+
+inline std::chrono::microseconds LinkAudioSource::Latencies::binLimit(size_t bin)
+{
+  return link_audio::LatencyHistogram::binLimit(bin);
+}
+
+inline LinkAudioSource::Latencies LinkAudioSource::latencies() const
+{
+  static_assert(Latencies::kNumBins == link_audio::LatencyHistogram::kNumBins);
+
+  const auto latencies = mpImpl->latencies();
+  return {latencies.commitToSend,
+          latencies.sendToReceive,
+          latencies.receiveToDeliver,
+          latencies.commitToDeliver};
+}
+
+inline std::chrono::microseconds LinkAudioSource::recommendedPlayoutLatency() const
+{
+  return mpImpl->recommendedPlayoutLatency();
+}
+
+template <typename SessionState>
+inline double LinkAudioSource::recommendedPlayoutLatencyInBeats(
+  const SessionState& sessionState) const
+{
+  return detail::linkApiState(sessionState)
+    .timeline.tempo.microsToBeats(recommendedPlayoutLatency())
+    .floating();
+}
+
+inline void LinkAudioSource::setPlayoutLatencyInBeats(double beats)
+{
+  if (const auto pPlayoutBuffer = mpImpl->playoutBuffer())
+  {
+    pPlayoutBuffer->setLatency(link::Beats{beats});
+  }
+}
+
+inline void LinkAudioSource::setPlayoutLatency(std::chrono::microseconds latency)
+{
+  if (const auto pPlayoutBuffer = mpImpl->playoutBuffer())
+  {
+    pPlayoutBuffer->setLatency(latency);
+  }
+}
+
+template <typename SessionState>
+inline bool LinkAudioSource::read(const SessionState& sessionState,
+                                  const double quantum,
+                                  const std::chrono::microseconds hostTime,
+                                  const size_t numFrames,
+                                  const size_t numChannels,
+                                  const double sampleRate,
+                                  float* pOut,
+                                  const size_t* pChannels)
+{
+  return render(sessionState,
+                quantum,
+                hostTime,
+                numFrames,
+                sampleRate,
+                link_audio::PlayoutBuffer::Output{
+                  numChannels, pOut, nullptr, pChannels});
+}
+
+template <typename SessionState>
+inline bool LinkAudioSource::readPlanar(const SessionState& sessionState,
+                                        const double quantum,
+                                        const std::chrono::microseconds hostTime,
+                                        const size_t numFrames,
+                                        const size_t numChannels,
+                                        const double sampleRate,
+                                        float* const* ppOut,
+                                        const size_t* pChannels)
+{
+  return render(sessionState,
+                quantum,
+                hostTime,
+                numFrames,
+                sampleRate,
+                link_audio::PlayoutBuffer::Output{
+                  numChannels, nullptr, ppOut, pChannels});
+}
+
+template <typename SessionState>
+inline bool LinkAudioSource::render(const SessionState& sessionState,
+                                    const double quantum,
+                                    const std::chrono::microseconds hostTime,
+                                    const size_t numFrames,
+                                    const double sampleRate,
+                                    const link_audio::PlayoutBuffer::Output& output)
+{
+  const auto pPlayoutBuffer = mpImpl->playoutBuffer();
+  if (!pPlayoutBuffer)
+  {
+    output.clear(numFrames);
+    return false;
+  }
+
+  const auto& state = detail::linkApiState(sessionState);
+  const auto latency = pPlayoutBuffer->latency(state.timeline.tempo);
+  const auto endTime =
+    hostTime
+    + std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double>(static_cast<double>(numFrames) / sampleRate));
+  const auto beatsAt = [&](const std::chrono::microseconds time)
+  {
+    return link_audio::globalBeatAtBeat(
+      state.timeline,
+      link::Beats{sessionState.beatAtTime(time, quantum)} - latency,
+      link::Beats{quantum});
+  };
+
+  return pPlayoutBuffer->read(state.timelineSessionId,
+                              beatsAt(hostTime),
+                              beatsAt(endTime),
+                              numFrames,
+                              output);
+}
+
+inline std::chrono::microseconds LinkAudioSource::playoutBufferedTime() const
+{
+  const auto pPlayoutBuffer = mpImpl->playoutBuffer();
+  return pPlayoutBuffer ? pPlayoutBuffer->bufferedTime() : std::chrono::microseconds{0};
+}
+
 } // namespace ableton
@@ -32,6 +32,14 @@ using IpAddressV6 = LINK_ASIO_NAMESPACE::ip::address_v6;
 using UdpSocket = LINK_ASIO_NAMESPACE::ip::udp::socket;
 using UdpEndpoint = LINK_ASIO_NAMESPACE::ip::udp::endpoint;
 
+// A datagram that is sent as part of a batch. The data is not owned.
+struct UdpDatagram
+{
+  const uint8_t* pData;
+  std::size_t numBytes;
+  UdpEndpoint to;
+};
+
 template <typename... Args>
 inline IpAddress makeAddress(Args&&... args)
 {
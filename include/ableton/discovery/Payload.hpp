@@ -76,7 +76,9 @@ struct PayloadEntry
 
   friend std::uint32_t sizeInByteStream(const PayloadEntry& entry)
   {
-    return sizeInByteStream(entry.header) + sizeInByteStream(entry.value);
+    // Entries of size zero are not serialized, see below
+    const auto valueSize = sizeInByteStream(entry.value);
+    return valueSize == 0 ? 0 : sizeInByteStream(entry.header) + valueSize;
   }
 
   template <typename It>
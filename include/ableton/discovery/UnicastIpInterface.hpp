@@ -20,9 +20,14 @@
 #pragma once
 
 #include <ableton/discovery/AsioTypes.hpp>
+#include <ableton/discovery/IpInterface.hpp>
 #include <ableton/util/Injected.hpp>
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace ableton
 {
@@ -36,7 +41,8 @@ public:
   using Socket = typename util::Injected<IoContext>::type::template Socket<MaxPacketSize>;
 
   UnicastIpInterface(util::Injected<IoContext> io, const discovery::IpAddress& addr)
-    : mSocket(io->template openUnicastSocket<MaxPacketSize>(addr))
+    : mIo(std::move(io))
+    , mSocket(mIo->template openUnicastSocket<MaxPacketSize>(addr))
   {
   }
 
@@ -44,7 +50,11 @@ public:
   UnicastIpInterface& operator=(const UnicastIpInterface&) = delete;
 
   UnicastIpInterface(UnicastIpInterface&& rhs)
-    : mSocket(std::move(rhs.mSocket))
+    : mIo(std::move(rhs.mIo))
+    , mSocket(std::move(rhs.mSocket))
+    , mpMulticastSocket(std::move(rhs.mpMulticastSocket))
+    , mMemberships(std::move(rhs.mMemberships))
+    , mReceiveMulticast(std::move(rhs.mReceiveMulticast))
   {
   }
 
@@ -55,16 +65,91 @@ public:
     return mSocket.send(pData, numBytes, to);
   }
 
+  std::size_t send(const discovery::UdpDatagram* pDatagrams, const size_t numDatagrams)
+  {
+    return mSocket.send(pDatagrams, numDatagrams);
+  }
+
   template <typename Handler>
   void receive(Handler handler)
   {
     mSocket.receive(SocketReceiver<Handler>(std::move(handler)));
   }
 
+  // Receive the next datagram sent to one of the joined multicast groups. If no group
+  // has been joined yet, receiving starts with the first join.
+  template <typename Handler>
+  void receive(Handler handler, discovery::MulticastTag)
+  {
+    auto receiveMulticast = [handler = std::move(handler)](Socket& socket)
+    { socket.receive(SocketReceiver<Handler, discovery::MulticastTag>(handler)); };
+
+    if (mpMulticastSocket)
+    {
+      receiveMulticast(*mpMulticastSocket);
+    }
+    else
+    {
+      mReceiveMulticast = std::move(receiveMulticast);
+    }
+  }
+
+  // Memberships are counted, a group is left when it has been left as often as it has
+  // been joined. Throws if the membership can't be changed.
+  void joinMulticastGroup(const discovery::UdpEndpoint& group)
+  {
+    const auto it = findMembership(group);
+    if (it != mMemberships.end())
+    {
+      ++it->second;
+      return;
+    }
+
+    if (!mpMulticastSocket)
+    {
+      mpMulticastSocket = std::make_unique<Socket>(
+        mIo->template openMulticastGroupSocket<MaxPacketSize>(endpoint().address(),
+                                                              group.port()));
+      if (mReceiveMulticast)
+      {
+        mReceiveMulticast(*mpMulticastSocket);
+        mReceiveMulticast = nullptr;
+      }
+    }
+    else if (mpMulticastSocket->endpoint().port() != group.port())
+    {
+      throw std::runtime_error("Multicast groups must share the same port");
+    }
+
+    mpMulticastSocket->joinMulticastGroup(group.address(), endpoint().address());
+    mMemberships.emplace_back(group, 1);
+  }
+
+  void leaveMulticastGroup(const discovery::UdpEndpoint& group)
+  {
+    const auto it = findMembership(group);
+    if (it != mMemberships.end() && --it->second == 0)
+    {
+      mMemberships.erase(it);
+      mpMulticastSocket->leaveMulticastGroup(group.address(), endpoint().address());
+    }
+  }
+
   discovery::UdpEndpoint endpoint() const { return mSocket.endpoint(); }
 
 private:
-  template <typename Handler>
+  using Membership = std::pair<discovery::UdpEndpoint, std::size_t>;
+
+  typename std::vector<Membership>::iterator findMembership(
+    const discovery::UdpEndpoint& group)
+  {
+    return std::find_if(mMemberships.begin(),
+                        mMemberships.end(),
+                        [&](const auto& membership)
+                        { return membership.first == group; });
+  }
+
+  template <typename Handler, typename... Tag>
   struct SocketReceiver
   {
     SocketReceiver(Handler handler)
@@ -77,13 +162,17 @@ private:
                     const It messageBegin,
                     const It messageEnd)
     {
-      mHandler(from, messageBegin, messageEnd);
+      mHandler(Tag{}..., from, messageBegin, messageEnd);
     }
 
     Handler mHandler;
   };
 
+  util::Injected<IoContext> mIo;
   Socket mSocket;
+  std::unique_ptr<Socket> mpMulticastSocket;
+  std::vector<Membership> mMemberships;
+  std::function<void(Socket&)> mReceiveMulticast;
 };
 
 template <std::size_t MaxPacketSize, typename IoContext>
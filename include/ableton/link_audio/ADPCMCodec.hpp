@@ -0,0 +1,258 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/link_audio/AudioBuffer.hpp>
+#include <ableton/link_audio/CompressedEncoder.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace detail
+{
+
+// IMA ADPCM with four bits per sample. Every packet starts with a header per channel
+// holding the first sample and the initial step index, so packets decode on their own.
+// The remaining samples follow in groups of eight frames, each holding four bytes per
+// channel with the earlier sample in the low nibble. A group of one channel is a single
+// 32 bit word, so channels can be processed in parallel lanes. The last group is padded.
+//
+//   header per channel: first sample (16 bits) | step index (8 bits) | reserved (8 bits)
+
+constexpr uint32_t kADPCMHeaderSize = 4;
+constexpr uint32_t kADPCMGroupSize = 8;
+constexpr uint8_t kADPCMMaxStepIndex = 88;
+
+constexpr std::array<int16_t, kADPCMMaxStepIndex + 1> kADPCMSteps = {
+  {7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,
+   21,    23,    25,    28,    31,    34,    37,    41,    45,    50,    55,
+   60,    66,    73,    80,    88,    97,    107,   118,   130,   143,   157,
+   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,
+   494,   544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,
+   1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,  3660,
+   4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442,
+   11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+   32767}};
+
+constexpr std::array<int8_t, 16> kADPCMStepIndexAdjustments = {
+  {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8}};
+
+constexpr size_t adpcmSize(const uint32_t numFrames, const uint32_t numChannels)
+{
+  // The first frame is part of the header
+  const auto numGroups =
+    numFrames > 0 ? (numFrames - 1 + kADPCMGroupSize - 1) / kADPCMGroupSize : 0;
+  return size_t{numChannels} * (kADPCMHeaderSize + numGroups * kADPCMGroupSize / 2);
+}
+
+struct ADPCMState
+{
+  // Returns the reconstructed sample
+  int16_t decode(const uint8_t nibble)
+  {
+    const auto step = int32_t{kADPCMSteps[stepIndex]};
+    auto delta = step >> 3;
+    if (nibble & 4)
+    {
+      delta += step;
+    }
+    if (nibble & 2)
+    {
+      delta += step >> 1;
+    }
+    if (nibble & 1)
+    {
+      delta += step >> 2;
+    }
+    predictor = std::clamp(
+      (nibble & 8) ? predictor - delta : predictor + delta, -32768, 32767);
+    stepIndex = static_cast<uint8_t>(std::clamp(
+      stepIndex + kADPCMStepIndexAdjustments[nibble], 0, int{kADPCMMaxStepIndex}));
+    return static_cast<int16_t>(predictor);
+  }
+
+  uint8_t encode(const int16_t sample)
+  {
+    auto diff = int32_t{sample} - predictor;
+    auto nibble = uint8_t{0};
+    if (diff < 0)
+    {
+      nibble = 8;
+      diff = -diff;
+    }
+    auto step = int32_t{kADPCMSteps[stepIndex]};
+    for (auto bit = uint8_t{4}; bit > 0; bit >>= 1)
+    {
+      if (diff >= step)
+      {
+        nibble |= bit;
+        diff -= step;
+      }
+      step >>= 1;
+    }
+    // Update the state exactly like the decoder does
+    decode(nibble);
+    return nibble;
+  }
+
+  int32_t predictor;
+  uint8_t stepIndex;
+};
+
+// The smallest step index that covers the first difference of a channel
+inline uint8_t adpcmInitialStepIndex(const int16_t* pChannel,
+                                     const size_t stride,
+                                     const uint32_t numFrames)
+{
+  if (numFrames < 2)
+  {
+    return 0;
+  }
+  const auto diff = std::abs(int32_t{pChannel[stride]} - int32_t{pChannel[0]});
+  const auto it = std::lower_bound(kADPCMSteps.begin(), kADPCMSteps.end(), diff);
+  return static_cast<uint8_t>(
+    std::min(std::distance(kADPCMSteps.begin(), it), std::ptrdiff_t{kADPCMMaxStepIndex}));
+}
+
+// Encode interleaved samples. Returns the end of the encoded bytes or nullptr if they
+// don't fit into [pOut, pEnd).
+inline uint8_t* adpcmEncode(const int16_t* pSamples,
+                            const uint32_t numFrames,
+                            const uint32_t numChannels,
+                            uint8_t* pOut,
+                            uint8_t* pEnd)
+{
+  if (numFrames == 0
+      || adpcmSize(numFrames, numChannels) > static_cast<size_t>(pEnd - pOut))
+  {
+    return nullptr;
+  }
+
+  auto states = std::array<ADPCMState, 256>{};
+  for (auto channel = uint32_t{0}; channel < numChannels; ++channel)
+  {
+    const auto first = pSamples[channel];
+    auto& state = states[channel];
+    state.predictor = first;
+    state.stepIndex = adpcmInitialStepIndex(pSamples + channel, numChannels, numFrames);
+    *pOut++ = static_cast<uint8_t>(static_cast<uint16_t>(first) >> 8);
+    *pOut++ = static_cast<uint8_t>(first);
+    *pOut++ = state.stepIndex;
+    *pOut++ = 0;
+  }
+
+  for (auto begin = uint32_t{1}; begin < numFrames; begin += kADPCMGroupSize)
+  {
+    const auto end = std::min(begin + kADPCMGroupSize, numFrames);
+    for (auto channel = uint32_t{0}; channel < numChannels; ++channel)
+    {
+      auto& state = states[channel];
+      auto nibbles = std::array<uint8_t, kADPCMGroupSize>{};
+      for (auto i = begin; i < end; ++i)
+      {
+        nibbles[i - begin] = state.encode(pSamples[i * numChannels + channel]);
+      }
+      for (auto i = size_t{0}; i < kADPCMGroupSize; i += 2)
+      {
+        *pOut++ = static_cast<uint8_t>(nibbles[i] | (nibbles[i + 1] << 4));
+      }
+    }
+  }
+  return pOut;
+}
+
+// Decode into interleaved samples. Throws std::range_error if the bytes are malformed.
+inline void adpcmDecode(const uint8_t* pBegin,
+                        const uint8_t* pEnd,
+                        const uint32_t numFrames,
+                        const uint32_t numChannels,
+                        int16_t* pSamples)
+{
+  if (numFrames == 0
+      || adpcmSize(numFrames, numChannels) != static_cast<size_t>(pEnd - pBegin))
+  {
+    throw std::range_error("Byte count / frame count mismatch.");
+  }
+
+  auto states = std::array<ADPCMState, 256>{};
+  for (auto channel = uint32_t{0}; channel < numChannels; ++channel)
+  {
+    auto& state = states[channel];
+    const auto first = static_cast<int16_t>((pBegin[0] << 8) | pBegin[1]);
+    state.predictor = first;
+    state.stepIndex = pBegin[2];
+    if (state.stepIndex > kADPCMMaxStepIndex)
+    {
+      throw std::range_error("Invalid ADPCM step index");
+    }
+    pSamples[channel] = first;
+    pBegin += kADPCMHeaderSize;
+  }
+
+  for (auto begin = uint32_t{1}; begin < numFrames; begin += kADPCMGroupSize)
+  {
+    const auto end = std::min(begin + kADPCMGroupSize, numFrames);
+    for (auto channel = uint32_t{0}; channel < numChannels; ++channel)
+    {
+      auto& state = states[channel];
+      for (auto i = begin; i < end; ++i)
+      {
+        const auto byte = pBegin[(i - begin) / 2];
+        const auto nibble =
+          static_cast<uint8_t>((i - begin) % 2 == 0 ? byte & 0xf : byte >> 4);
+        pSamples[i * numChannels + channel] = state.decode(nibble);
+      }
+      pBegin += kADPCMGroupSize / 2;
+    }
+  }
+}
+
+} // namespace detail
+
+// Lossy compression to a quarter of the PCM size for the CompressedEncoder. Packets
+// collect four times the frames of a PCM packet, so the packet rate drops along with
+// the size.
+struct ADPCMCompression
+{
+  static constexpr Codec kCodec = Codec::kADPCM_i4;
+  static constexpr bool kIsLossless = false;
+  static constexpr uint32_t kMaxExpansion = 4;
+
+  static uint8_t* encode(const int16_t* pSamples,
+                         const uint32_t numFrames,
+                         const uint32_t numChannels,
+                         uint8_t* pOut,
+                         uint8_t* pEnd)
+  {
+    return detail::adpcmEncode(pSamples, numFrames, numChannels, pOut, pEnd);
+  }
+};
+
+template <typename Sender>
+using ADPCMEncoder = CompressedEncoder<Sender, ADPCMCompression>;
+
+} // namespace link_audio
+} // namespace ableton
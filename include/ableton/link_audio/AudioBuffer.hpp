@@ -26,7 +26,9 @@
 #include <ableton/link_audio/v1/Messages.hpp>
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <numeric>
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -42,13 +44,54 @@ enum Codec : uint8_t
 {
   kInvalid = 0,
   kPCM_i16 = 1,
+  kLPC_i16 = 2,
+  kADPCM_i4 = 3,
 };
+
+struct AudioBufferView;
+
+// When the first chunk of an audio buffer was committed by the sending application and
+// when its packet was sent, in the ghost time of the session. It follows the audio bytes
+// of buffers sent to peers that accept it, which is why older peers never see it.
+struct AudioBufferTiming
+{
+  static constexpr std::uint32_t kSize = 16;
+
+  // Model the NetworkByteStreamSerializable concept
+  friend std::uint32_t sizeInByteStream(const AudioBufferTiming&) { return kSize; }
+
+  template <typename It>
+  friend It toNetworkByteStream(const AudioBufferTiming& timing, It out)
+  {
+    return discovery::toNetworkByteStream(
+      static_cast<int64_t>(timing.sendTime.count()),
+      discovery::toNetworkByteStream(static_cast<int64_t>(timing.commitTime.count()),
+                                     std::move(out)));
+  }
+
+  template <typename It>
+  static std::pair<AudioBufferTiming, It> fromNetworkByteStream(It begin, It end)
+  {
+    auto [commitTime, commitTimeEnd] =
+      discovery::Deserialize<int64_t>::fromNetworkByteStream(std::move(begin), end);
+    auto [sendTime, sendTimeEnd] =
+      discovery::Deserialize<int64_t>::fromNetworkByteStream(commitTimeEnd, end);
+    return std::make_pair(AudioBufferTiming{std::chrono::microseconds{commitTime},
+                                            std::chrono::microseconds{sendTime}},
+                          sendTimeEnd);
+  }
+
+  std::chrono::microseconds commitTime;
+  std::chrono::microseconds sendTime;
+};
+
 struct AudioBuffer
 {
   static constexpr std::int32_t key = '_abu';
   static_assert(key == 0x5f616275, "Unexpected byte order");
 
-  static constexpr std::uint32_t kNonAudioBytes = 50;
+  // Serialized size of an AudioBuffer with a single chunk and no audio bytes
+  static constexpr std::uint32_t kNonAudioBytes = 54;
   static constexpr uint32_t kMaxAudioBytes = v1::kMaxPayloadSize - kNonAudioBytes;
 
   struct Chunk
@@ -103,7 +146,7 @@ struct AudioBuffer
   using Chunks = std::vector<Chunk>;
   using Bytes = std::array<uint8_t, kMaxAudioBytes>;
 
-  uint32_t numFrames() const
+  static uint32_t numFrames(const Chunks& chunks)
   {
     return std::accumulate(chunks.begin(),
                            chunks.end(),
@@ -112,6 +155,8 @@ struct AudioBuffer
                            { return sum + chunk.numFrames; });
   }
 
+  uint32_t numFrames() const { return numFrames(chunks); }
+
   // Model the NetworkByteStreamSerializable concept
   friend std::uint32_t sizeInByteStream(const AudioBuffer& buffer)
   {
@@ -122,7 +167,8 @@ struct AudioBuffer
            + discovery::sizeInByteStream(static_cast<uint32_t>(buffer.sampleRate))
            + discovery::sizeInByteStream(static_cast<int8_t>(buffer.numChannels))
            + discovery::sizeInByteStream(static_cast<int16_t>(buffer.numBytes))
-           + static_cast<uint32_t>(buffer.numBytes);
+           + static_cast<uint32_t>(buffer.numBytes)
+           + (buffer.timing ? AudioBufferTiming::kSize : 0);
   }
 
   template <typename It>
@@ -144,34 +190,120 @@ struct AudioBuffer
                 buffer.sessionId,
                 discovery::toNetworkByteStream(buffer.channelId, out)))))));
 
-    return std::copy_n(buffer.bytes.begin(), buffer.numBytes, out);
+    out = std::copy_n(buffer.bytes.begin(), buffer.numBytes, out);
+    return buffer.timing ? toNetworkByteStream(*buffer.timing, std::move(out)) : out;
   }
 
+  // Copies the audio bytes. Requires contiguous iterators.
   template <typename It>
-  static It fromNetworkByteStream(AudioBuffer& audioBuffer, It begin, It end)
+  static It fromNetworkByteStream(AudioBuffer& audioBuffer, It begin, It end);
+
+  void assign(const AudioBufferView& view);
+
+  friend bool operator==(const AudioBuffer& lhs, const AudioBuffer& rhs)
+  {
+    return std::tie(lhs.channelId,
+                    lhs.sessionId,
+                    lhs.sampleRate,
+                    lhs.chunks,
+                    lhs.numChannels,
+                    lhs.numBytes)
+             == std::tie(rhs.channelId,
+                         rhs.sessionId,
+                         rhs.sampleRate,
+                         rhs.chunks,
+                         rhs.numChannels,
+                         rhs.numBytes)
+           && std::equal(lhs.bytes.begin(),
+                         lhs.bytes.begin() + lhs.numBytes,
+                         begin(rhs.bytes),
+                         begin(rhs.bytes) + rhs.numBytes);
+  }
+
+  friend bool operator!=(const AudioBuffer& lhs, const AudioBuffer& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  Id channelId;
+  Id sessionId;
+  Chunks chunks;
+  Codec codec;
+  uint32_t sampleRate;
+  uint8_t numChannels;
+  uint16_t numBytes;
+  Bytes bytes;
+  std::optional<AudioBufferTiming> timing = std::nullopt;
+};
+
+// Serializes an audio buffer followed by its timing without copying it
+struct TimedAudioBuffer
+{
+  // Model the NetworkByteStreamSerializable concept
+  friend std::uint32_t sizeInByteStream(const TimedAudioBuffer& timed)
+  {
+    return sizeInByteStream(timed.buffer) + sizeInByteStream(timed.timing);
+  }
+
+  template <typename It>
+  friend It toNetworkByteStream(const TimedAudioBuffer& timed, It out)
+  {
+    return toNetworkByteStream(timed.timing, toNetworkByteStream(timed.buffer, out));
+  }
+
+  const AudioBuffer& buffer;
+  AudioBufferTiming timing;
+};
+
+// Refers to the audio bytes of a serialized buffer in place instead of copying them,
+// e.g. to decode straight from a socket's receive buffer. Only valid as long as the
+// bytes it refers to.
+struct AudioBufferView
+{
+  AudioBufferView() = default;
+
+  AudioBufferView(const AudioBuffer& buffer)
+    : channelId(buffer.channelId)
+    , sessionId(buffer.sessionId)
+    , chunks(buffer.chunks)
+    , codec(buffer.codec)
+    , sampleRate(buffer.sampleRate)
+    , numChannels(buffer.numChannels)
+    , numBytes(buffer.numBytes)
+    , pBytes(buffer.bytes.data())
+    , timing(buffer.timing)
+  {
+  }
+
+  uint32_t numFrames() const { return AudioBuffer::numFrames(chunks); }
+
+  // Requires contiguous iterators
+  template <typename It>
+  static It fromNetworkByteStream(AudioBufferView& view, It begin, It end)
   {
     using namespace std;
 
     auto [channelId, channelIdEnd] =
       discovery::Deserialize<Id>::fromNetworkByteStream(begin, end);
-    audioBuffer.channelId = channelId;
+    view.channelId = channelId;
 
     auto [sessionId, sessionIdEnd] =
       discovery::Deserialize<Id>::fromNetworkByteStream(channelIdEnd, end);
-    audioBuffer.sessionId = sessionId;
+    view.sessionId = sessionId;
 
     auto [chunks, chunksEnd] =
-      discovery::Deserialize<Chunks>::fromNetworkByteStream(sessionIdEnd, end);
-    audioBuffer.chunks = chunks;
+      discovery::Deserialize<AudioBuffer::Chunks>::fromNetworkByteStream(sessionIdEnd,
+                                                                         end);
+    view.chunks = std::move(chunks);
 
-    if (chunks.empty())
+    if (view.chunks.empty())
     {
       throw runtime_error("Invalid audio buffer: no chunks.");
     }
 
     auto [codec, codecEnd] =
       discovery::Deserialize<uint8_t>::fromNetworkByteStream(chunksEnd, end);
-    audioBuffer.codec = static_cast<Codec>(codec);
+    view.codec = static_cast<Codec>(codec);
 
     if (codec == Codec::kInvalid)
     {
@@ -180,33 +312,48 @@ struct AudioBuffer
 
     auto [sampleRate, sampleRateEnd] =
       discovery::Deserialize<uint32_t>::fromNetworkByteStream(codecEnd, end);
-    audioBuffer.sampleRate = sampleRate;
+    view.sampleRate = sampleRate;
 
     auto [numChannels, numChannelsEnd] =
       discovery::Deserialize<uint8_t>::fromNetworkByteStream(sampleRateEnd, end);
-    audioBuffer.numChannels = numChannels;
+    view.numChannels = numChannels;
 
     auto [numBytes, numBytesEnd] =
       discovery::Deserialize<uint16_t>::fromNetworkByteStream(numChannelsEnd, end);
-    audioBuffer.numBytes = numBytes;
+    view.numBytes = numBytes;
 
     if (codec == Codec::kPCM_i16
-        && audioBuffer.numFrames() * numChannels * sizeof(int16_t) != numBytes)
+        && view.numFrames() * numChannels * sizeof(int16_t) != numBytes)
     {
       throw range_error("Byte count / frame count mismatch.");
     }
 
-    if (std::distance(numBytesEnd, end) > numBytes || numBytesEnd + numBytes > end)
+    // The audio bytes may be followed by the timing of the buffer
+    const auto numRemainingBytes = std::distance(numBytesEnd, end);
+    const auto hasTiming = numRemainingBytes
+                           == static_cast<decltype(numRemainingBytes)>(
+                             numBytes + AudioBufferTiming::kSize);
+    if (numBytes > AudioBuffer::kMaxAudioBytes
+        || (numRemainingBytes != numBytes && !hasTiming))
     {
       throw range_error("Invalid byte count.");
     }
 
-    std::copy_n(numBytesEnd, numBytes, audioBuffer.bytes.begin());
+    view.pBytes = &*begin + std::distance(begin, numBytesEnd);
+
+    view.timing = std::nullopt;
+    if (hasTiming)
+    {
+      auto [timing, timingEnd] =
+        AudioBufferTiming::fromNetworkByteStream(numBytesEnd + numBytes, end);
+      view.timing = timing;
+      return timingEnd;
+    }
 
     return numBytesEnd + numBytes;
   }
 
-  friend bool operator==(const AudioBuffer& lhs, const AudioBuffer& rhs)
+  friend bool operator==(const AudioBufferView& lhs, const AudioBufferView& rhs)
   {
     return std::tie(lhs.channelId,
                     lhs.sessionId,
@@ -220,26 +367,42 @@ struct AudioBuffer
                          rhs.chunks,
                          rhs.numChannels,
                          rhs.numBytes)
-           && std::equal(lhs.bytes.begin(),
-                         lhs.bytes.begin() + lhs.numBytes,
-                         begin(rhs.bytes),
-                         begin(rhs.bytes) + rhs.numBytes);
-  }
-
-  friend bool operator!=(const AudioBuffer& lhs, const AudioBuffer& rhs)
-  {
-    return !(lhs == rhs);
+           && std::equal(lhs.pBytes, lhs.pBytes + lhs.numBytes, rhs.pBytes);
   }
 
   Id channelId;
   Id sessionId;
-  Chunks chunks;
-  Codec codec;
-  uint32_t sampleRate;
-  uint8_t numChannels;
-  uint16_t numBytes;
-  Bytes bytes;
+  AudioBuffer::Chunks chunks;
+  Codec codec = Codec::kInvalid;
+  uint32_t sampleRate = 0;
+  uint8_t numChannels = 0;
+  uint16_t numBytes = 0;
+  const uint8_t* pBytes = nullptr;
+  std::optional<AudioBufferTiming> timing;
 };
 
+template <typename It>
+It AudioBuffer::fromNetworkByteStream(AudioBuffer& audioBuffer, It begin, It end)
+{
+  auto view = AudioBufferView{};
+  const auto viewEnd = AudioBufferView::fromNetworkByteStream(view, begin, end);
+  audioBuffer.assign(view);
+  return viewEnd;
+}
+
+// Only the valid audio bytes are copied
+inline void AudioBuffer::assign(const AudioBufferView& view)
+{
+  channelId = view.channelId;
+  sessionId = view.sessionId;
+  chunks = view.chunks;
+  codec = view.codec;
+  sampleRate = view.sampleRate;
+  numChannels = view.numChannels;
+  numBytes = view.numBytes;
+  std::copy_n(view.pBytes, view.numBytes, bytes.begin());
+  timing = view.timing;
+}
+
 } // namespace link_audio
 } // namespace ableton
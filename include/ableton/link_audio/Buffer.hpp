@@ -22,6 +22,9 @@
 #include <ableton/link/Beats.hpp>
 #include <ableton/link/Tempo.hpp>
 #include <ableton/link_audio/Id.hpp>
+#include <chrono>
+#include <cstddef>
+#include <optional>
 #include <vector>
 
 namespace ableton
@@ -29,11 +32,24 @@ namespace ableton
 namespace link_audio
 {
 
+// Samples that live in memory owned elsewhere, e.g. in an arena shared by many buffers
 template <typename SampleFormat>
+struct SampleSpan
+{
+  SampleFormat* data() const { return pData; }
+  size_t size() const { return numSamples; }
+
+  SampleFormat* pData = nullptr;
+  size_t numSamples = 0;
+};
+
+template <typename SampleFormat, typename SampleStorage = std::vector<SampleFormat>>
 struct Buffer
 {
   using SampleFormatType = SampleFormat;
-  using Samples = std::vector<SampleFormat>;
+  using Samples = SampleStorage;
+
+  Buffer() = default;
 
   Buffer(uint32_t numSamples)
     : mSamples(numSamples)
@@ -48,6 +64,9 @@ struct Buffer
   link::Tempo mTempo;
   uint64_t mCount;
   Id mSessionId;
+  bool mIsConcealed = false;
+  // Session ghost time at which the buffer was committed, if it is measured
+  std::optional<std::chrono::microseconds> mCommitTime;
 };
 
 template <typename Buffer>
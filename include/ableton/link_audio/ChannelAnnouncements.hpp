@@ -19,18 +19,39 @@
 
 #pragma once
 
+#include <ableton/discovery/AsioTypes.hpp>
 #include <ableton/discovery/NetworkByteStreamSerializable.hpp>
 #include <ableton/link_audio/Id.hpp>
+#include <optional>
 
 namespace ableton
 {
 namespace link_audio
 {
 
+// Port of the multicast groups that channels are sent to
+static constexpr std::uint16_t kMulticastGroupPort = 20809;
+
+// The IPv4 multicast group a sink sends a channel to when multicast is enabled. Groups
+// are taken from the organization-local scope (RFC 2365). Channels that map to the same
+// group are told apart by the channel id in their audio buffers.
+inline discovery::UdpEndpoint multicastGroup(const Id& channelId)
+{
+  auto bytes = std::array<std::uint8_t, 2>{};
+  for (auto i = std::size_t{0}; i < channelId.size(); ++i)
+  {
+    bytes[i % 2] ^= channelId[i];
+  }
+  return {discovery::IpAddressV4{{239, 192, bytes[0], bytes[1]}}, kMulticastGroupPort};
+}
+
 struct ChannelAnnouncement
 {
   std::string name;
   Id id;
+  // Not part of the serialized channel to stay compatible with peers that don't support
+  // multicast. It is sent in a separate ChannelMulticastGroups entry instead.
+  std::optional<discovery::UdpEndpoint> multicastGroup;
 
   // Model the NetworkByteStreamSerializable concept
   friend std::uint32_t sizeInByteStream(const ChannelAnnouncement& channel)
@@ -52,12 +73,13 @@ struct ChannelAnnouncement
     auto [name, nameEnd] =
       discovery::Deserialize<std::string>::fromNetworkByteStream(begin, end);
     auto [id, idEnd] = discovery::Deserialize<Id>::fromNetworkByteStream(nameEnd, end);
-    return std::make_pair(ChannelAnnouncement{std::move(name), std::move(id)}, idEnd);
+    return std::make_pair(ChannelAnnouncement{std::move(name), std::move(id), {}}, idEnd);
   }
 
   friend bool operator==(const ChannelAnnouncement& lhs, const ChannelAnnouncement& rhs)
   {
-    return std::tie(lhs.name, lhs.id) == std::tie(rhs.name, rhs.id);
+    return std::tie(lhs.name, lhs.id, lhs.multicastGroup)
+           == std::tie(rhs.name, rhs.id, rhs.multicastGroup);
   }
 };
 ;
@@ -102,6 +124,88 @@ struct ChannelAnnouncements
   }
 };
 
+struct ChannelMulticastGroup
+{
+  Id id;
+  discovery::UdpEndpoint group;
+
+  // Model the NetworkByteStreamSerializable concept
+  friend std::uint32_t sizeInByteStream(const ChannelMulticastGroup& channel)
+  {
+    return discovery::sizeInByteStream(channel.id)
+           + discovery::sizeInByteStream(
+             static_cast<std::uint32_t>(channel.group.address().to_v4().to_uint()))
+           + discovery::sizeInByteStream(channel.group.port());
+  }
+
+  template <typename It>
+  friend It toNetworkByteStream(const ChannelMulticastGroup& channel, It out)
+  {
+    return discovery::toNetworkByteStream(
+      channel.group.port(),
+      discovery::toNetworkByteStream(
+        static_cast<std::uint32_t>(channel.group.address().to_v4().to_uint()),
+        discovery::toNetworkByteStream(channel.id, std::move(out))));
+  }
+
+  template <typename It>
+  static std::pair<ChannelMulticastGroup, It> fromNetworkByteStream(It begin, It end)
+  {
+    auto [id, idEnd] =
+      discovery::Deserialize<Id>::fromNetworkByteStream(std::move(begin), end);
+    auto [addr, addrEnd] =
+      discovery::Deserialize<std::uint32_t>::fromNetworkByteStream(idEnd, end);
+    auto [port, portEnd] =
+      discovery::Deserialize<std::uint16_t>::fromNetworkByteStream(addrEnd, end);
+    return std::make_pair(
+      ChannelMulticastGroup{std::move(id), {discovery::IpAddressV4{addr}, port}},
+      portEnd);
+  }
+
+  friend bool operator==(const ChannelMulticastGroup& lhs,
+                         const ChannelMulticastGroup& rhs)
+  {
+    return std::tie(lhs.id, lhs.group) == std::tie(rhs.id, rhs.group);
+  }
+};
+
+// Multicast groups of announced channels. Only channels of sinks that have multicast
+// enabled are listed.
+struct ChannelMulticastGroups
+{
+  static constexpr std::int32_t key = 'aucg';
+  static_assert(key == 0x61756367, "Unexpected byte order");
+
+  std::vector<ChannelMulticastGroup> groups;
+
+  // Model the NetworkByteStreamSerializable concept. An empty list is not serialized.
+  friend std::uint32_t sizeInByteStream(const ChannelMulticastGroups& groups)
+  {
+    return groups.groups.empty() ? 0 : discovery::sizeInByteStream(groups.groups);
+  }
+
+  template <typename It>
+  friend It toNetworkByteStream(const ChannelMulticastGroups& groups, It out)
+  {
+    return discovery::toNetworkByteStream(groups.groups, std::move(out));
+  }
+
+  template <typename It>
+  static std::pair<ChannelMulticastGroups, It> fromNetworkByteStream(It begin, It end)
+  {
+    auto [groups, groupsEnd] =
+      discovery::Deserialize<std::vector<ChannelMulticastGroup>>::fromNetworkByteStream(
+        std::move(begin), end);
+    return std::make_pair(ChannelMulticastGroups{std::move(groups)}, groupsEnd);
+  }
+
+  friend bool operator==(const ChannelMulticastGroups& lhs,
+                         const ChannelMulticastGroups& rhs)
+  {
+    return lhs.groups == rhs.groups;
+  }
+};
+
 struct ChannelBye
 {
   Id id;
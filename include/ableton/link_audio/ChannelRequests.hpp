@@ -21,41 +21,177 @@
 
 #include <ableton/discovery/NetworkByteStreamSerializable.hpp>
 #include <ableton/discovery/Payload.hpp>
+#include <ableton/link/EndpointV4.hpp>
+#include <ableton/link_audio/AudioBuffer.hpp>
 #include <ableton/link_audio/ChannelId.hpp>
+#include <optional>
 
 namespace ableton
 {
 namespace link_audio
 {
 
+// The codec a requesting peer prefers to receive. Senders that don't know the entry
+// ignore it and send PCM.
+struct PreferredCodec
+{
+  static constexpr std::int32_t key = 'aupc';
+  static_assert(key == 0x61757063, "Unexpected byte order");
+
+  // Model the NetworkByteStreamSerializable concept. PCM has a size of zero and is not
+  // serialized.
+  friend std::uint32_t sizeInByteStream(const PreferredCodec pc)
+  {
+    return pc.codec == Codec::kPCM_i16
+             ? 0
+             : discovery::sizeInByteStream(static_cast<uint8_t>(pc.codec));
+  }
+
+  template <typename It>
+  friend It toNetworkByteStream(const PreferredCodec pc, It out)
+  {
+    return discovery::toNetworkByteStream(static_cast<uint8_t>(pc.codec), std::move(out));
+  }
+
+  template <typename It>
+  static std::pair<PreferredCodec, It> fromNetworkByteStream(It begin, It end)
+  {
+    auto [codec, codecEnd] =
+      discovery::Deserialize<uint8_t>::fromNetworkByteStream(std::move(begin), end);
+    return std::make_pair(PreferredCodec{static_cast<Codec>(codec)}, codecEnd);
+  }
+
+  Codec codec;
+};
+
+// Whether a requesting peer handles parity messages. Only peers that do get them.
+struct AcceptsParity
+{
+  static constexpr std::int32_t key = 'aupa';
+  static_assert(key == 0x61757061, "Unexpected byte order");
+
+  // Model the NetworkByteStreamSerializable concept. False has a size of zero and is not
+  // serialized.
+  friend std::uint32_t sizeInByteStream(const AcceptsParity ap)
+  {
+    return ap.accepts ? discovery::sizeInByteStream(ap.accepts) : 0;
+  }
+
+  template <typename It>
+  friend It toNetworkByteStream(const AcceptsParity ap, It out)
+  {
+    return discovery::toNetworkByteStream(ap.accepts, std::move(out));
+  }
+
+  template <typename It>
+  static std::pair<AcceptsParity, It> fromNetworkByteStream(It begin, It end)
+  {
+    auto [accepts, acceptsEnd] =
+      discovery::Deserialize<bool>::fromNetworkByteStream(std::move(begin), end);
+    return std::make_pair(AcceptsParity{accepts}, acceptsEnd);
+  }
+
+  bool accepts;
+};
+
+// Whether a requesting peer handles audio buffers followed by their timing. Buffers only
+// carry it if all peers receiving them do.
+struct AcceptsTiming
+{
+  static constexpr std::int32_t key = 'auti';
+  static_assert(key == 0x61757469, "Unexpected byte order");
+
+  // Model the NetworkByteStreamSerializable concept. False has a size of zero and is not
+  // serialized.
+  friend std::uint32_t sizeInByteStream(const AcceptsTiming at)
+  {
+    return at.accepts ? discovery::sizeInByteStream(at.accepts) : 0;
+  }
+
+  template <typename It>
+  friend It toNetworkByteStream(const AcceptsTiming at, It out)
+  {
+    return discovery::toNetworkByteStream(at.accepts, std::move(out));
+  }
+
+  template <typename It>
+  static std::pair<AcceptsTiming, It> fromNetworkByteStream(It begin, It end)
+  {
+    auto [accepts, acceptsEnd] =
+      discovery::Deserialize<bool>::fromNetworkByteStream(std::move(begin), end);
+    return std::make_pair(AcceptsTiming{accepts}, acceptsEnd);
+  }
+
+  bool accepts;
+};
+
 struct ChannelRequest
 {
-  using Payload = decltype(discovery::makePayload(ChannelId{}));
+  // The multicast group the requesting peer joined to receive the channel
+  static constexpr std::int32_t kMulticastGroupKey = 'aumg';
+  using MulticastGroupV4 = link::EndpointV4<kMulticastGroupKey>;
+  static_assert(MulticastGroupV4::key == 0x61756d67, "Unexpected byte order");
+
+  using Payload = decltype(discovery::makePayload(
+    ChannelId{}, MulticastGroupV4{}, PreferredCodec{}, AcceptsParity{}, AcceptsTiming{}));
 
   friend bool operator==(const ChannelRequest& lhs, const ChannelRequest& rhs)
   {
-    return std::tie(lhs.peerId, lhs.channelId) == std::tie(rhs.peerId, rhs.channelId);
+    return std::tie(lhs.peerId,
+                    lhs.channelId,
+                    lhs.multicastGroup,
+                    lhs.codec,
+                    lhs.acceptsParity,
+                    lhs.acceptsTiming)
+           == std::tie(rhs.peerId,
+                       rhs.channelId,
+                       rhs.multicastGroup,
+                       rhs.codec,
+                       rhs.acceptsParity,
+                       rhs.acceptsTiming);
   }
 
   friend Payload toPayload(const ChannelRequest& request)
   {
-    return discovery::makePayload(ChannelId{request.channelId});
+    // An IPv6 endpoint has a size of zero and is not serialized, so requests for
+    // unicast look the same as before multicast was supported
+    return discovery::makePayload(
+      ChannelId{request.channelId},
+      MulticastGroupV4{request.multicastGroup
+                         ? *request.multicastGroup
+                         : discovery::UdpEndpoint{discovery::makeAddress("::"), {}}},
+      PreferredCodec{request.codec},
+      AcceptsParity{request.acceptsParity},
+      AcceptsTiming{request.acceptsTiming});
   }
 
   template <typename It>
   static ChannelRequest fromPayload(Id peerId, It begin, It end)
   {
     using namespace std;
-    auto request = ChannelRequest{std::move(peerId)};
-    discovery::parsePayload<ChannelId>(std::move(begin),
-                                       std::move(end),
-                                       [&request](ChannelId cid)
-                                       { request.channelId = std::move(cid.id); });
+    auto request = ChannelRequest{std::move(peerId), {}, {}};
+    discovery::parsePayload<ChannelId,
+                            MulticastGroupV4,
+                            PreferredCodec,
+                            AcceptsParity,
+                            AcceptsTiming>(
+      std::move(begin),
+      std::move(end),
+      [&request](ChannelId cid) { request.channelId = std::move(cid.id); },
+      [&request](MulticastGroupV4 group)
+      { request.multicastGroup = std::move(group.ep); },
+      [&request](PreferredCodec pc) { request.codec = pc.codec; },
+      [&request](AcceptsParity ap) { request.acceptsParity = ap.accepts; },
+      [&request](AcceptsTiming at) { request.acceptsTiming = at.accepts; });
     return request;
   }
 
   Id peerId;
   Id channelId;
+  std::optional<discovery::UdpEndpoint> multicastGroup;
+  Codec codec = Codec::kPCM_i16;
+  bool acceptsParity = false;
+  bool acceptsTiming = false;
 };
 
 struct ChannelStopRequest
@@ -24,6 +24,7 @@
 #include <ableton/link_audio/Id.hpp>
 #include <ableton/link_audio/PeerAnnouncement.hpp>
 #include <ableton/util/Injected.hpp>
+#include <ableton/util/Locked.hpp>
 #include <algorithm>
 #include <cassert>
 #include <chrono>
@@ -72,6 +73,41 @@ public:
 
     discovery::UdpEndpoint endpoint() const { return mEndpoint; }
 
+    std::shared_ptr<Interface> interface() const { return mpInterface.lock(); }
+
+    // Join a multicast group on the interface of this handler. Returns false if the
+    // group can't be received via this interface.
+    bool joinMulticastGroup(const discovery::UdpEndpoint& group)
+    {
+      auto interface = mpInterface.lock();
+      if (interface && group.address().is_v4() && mEndpoint.address().is_v4())
+      {
+        try
+        {
+          interface->joinMulticastGroup(group);
+          return true;
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+      }
+      return false;
+    }
+
+    void leaveMulticastGroup(const discovery::UdpEndpoint& group)
+    {
+      if (auto interface = mpInterface.lock())
+      {
+        try
+        {
+          interface->leaveMulticastGroup(group);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+      }
+    }
+
   private:
     discovery::UdpEndpoint mEndpoint;
     std::weak_ptr<Interface> mpInterface;
@@ -92,10 +128,19 @@ public:
     }
   };
 
+  // Round trip time and jitter of the connection a peer's channels are received from
+  struct PeerNetworkStats
+  {
+    Id peerId;
+    std::chrono::microseconds roundTripTime;
+    std::chrono::microseconds jitter;
+  };
+
   struct ChannelInfo
   {
     Channel channel;
     discovery::IpAddress gatewayAddr;
+    std::optional<discovery::UdpEndpoint> multicastGroup;
   };
 
   struct ChannelInfoCompare
@@ -164,6 +209,41 @@ public:
     return it != end(channels) ? peerSendHandler(it->channel.peerId) : std::nullopt;
   }
 
+  // The multicast group the channel is sent to, if its sink has multicast enabled
+  std::optional<discovery::UdpEndpoint> channelMulticastGroup(const Id channelId) const
+  {
+    const auto& channels = mpImpl->mChannels;
+    const auto it =
+      std::find_if(begin(channels),
+                   end(channels),
+                   [&](const auto& info) { return info.channel.id == channelId; });
+    return it != end(channels) ? it->multicastGroup : std::nullopt;
+  }
+
+  // The network statistics of the peer that sends the channel
+  std::optional<PeerNetworkStats> channelNetworkStats(const Id channelId) const
+  {
+    const auto& channels = mpImpl->mChannels;
+    const auto it =
+      std::find_if(begin(channels),
+                   end(channels),
+                   [&](const auto& info) { return info.channel.id == channelId; });
+    if (it == end(channels))
+    {
+      return std::nullopt;
+    }
+    const auto handlerIt = mpImpl->mPeerSendHandlers.find(it->channel.peerId);
+    return handlerIt != mpImpl->mPeerSendHandlers.end()
+             ? std::optional{handlerIt->second.networkStats}
+             : std::nullopt;
+  }
+
+  // Thread-safe
+  std::vector<PeerNetworkStats> peerNetworkStats() const
+  {
+    return mpImpl->mPeerNetworkStats.read();
+  }
+
   template <typename PeerIdIt>
   void prunePeerChannels(PeerIdIt connectedPeersBegin, PeerIdIt connectedPeersEnd)
   {
@@ -246,6 +326,7 @@ private:
     Impl(util::Injected<IoContext> io, Callback callback)
       : mIo(std::move(io))
       , mCallback(std::move(callback))
+      , mPeerNetworkStats({})
       , mPruneTimer(mIo->makeTimer())
     {
     }
@@ -262,13 +343,16 @@ private:
       const auto ttl = incoming.ttl;
       auto sendHandler = SendHandler(incoming.from, incoming.pInterface);
       const auto networkQuality = incoming.networkQuality;
+      const auto networkStats = PeerNetworkStats{
+        nodeId, incoming.networkStats.roundTripTime, incoming.networkStats.jitter};
       bool didChannelsChange = false;
 
       for (const auto& peerChannel : peerAudioChannels)
       {
         const auto channelInfo = ChannelInfo{
           {peerChannel.name, peerChannel.id, peerInfo.name, nodeId, peerSession},
-          gatewayAddr};
+          gatewayAddr,
+          peerChannel.multicastGroup};
 
         {
           const auto timeout =
@@ -340,13 +424,19 @@ private:
 
       if (mPeerSendHandlers.count(nodeId) == 0)
       {
-        mPeerSendHandlers.emplace(nodeId, PeerSendHandler{sendHandler, networkQuality});
+        mPeerSendHandlers.emplace(
+          nodeId, PeerSendHandler{sendHandler, networkQuality, networkStats});
       }
       else if (mPeerSendHandlers.at(nodeId).networkQuality < networkQuality)
       {
         mPeerSendHandlers.insert_or_assign(
-          nodeId, PeerSendHandler{sendHandler, networkQuality});
+          nodeId, PeerSendHandler{sendHandler, networkQuality, networkStats});
+      }
+      else if (mPeerSendHandlers.at(nodeId).handler.endpoint() == sendHandler.endpoint())
+      {
+        mPeerSendHandlers.at(nodeId).networkStats = networkStats;
       }
+      updatePeerNetworkStats();
 
       // Invoke callbacks outside the critical section
       if (didChannelsChange)
@@ -374,6 +464,20 @@ private:
           ++it;
         }
       }
+      updatePeerNetworkStats();
+    }
+
+    void updatePeerNetworkStats()
+    {
+      mPeerNetworkStats.update(
+        [&](auto& stats)
+        {
+          stats.clear();
+          for (const auto& entry : mPeerSendHandlers)
+          {
+            stats.push_back(entry.second.networkStats);
+          }
+        });
     }
 
     void pruneSendHandlers()
@@ -578,8 +682,10 @@ private:
     {
       SendHandler handler;
       double networkQuality;
+      PeerNetworkStats networkStats;
     };
     std::map<Id, PeerSendHandler> mPeerSendHandlers;
+    util::Locked<std::vector<PeerNetworkStats>> mPeerNetworkStats;
 
     using ChannelTimeout = std::tuple<TimePoint, discovery::IpAddress, Id>;
     using ChannelTimeouts = std::vector<ChannelTimeout>;
@@ -0,0 +1,163 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/link_audio/AudioBuffer.hpp>
+#include <ableton/link_audio/PCMCodec.hpp>
+#include <ableton/util/Injected.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+// Successor of a Resizer that sends packets with a compressing codec. The Resizer is
+// meant to collect up to Compression::kMaxExpansion times the frames that fit into a
+// packet as PCM. Packets that don't compress well enough are split in halves. Parts that
+// a lossless codec can't make smaller than PCM are sent as PCM. Chunks are numbered by
+// the encoder, because split chunks need a count of their own.
+//
+// Compression provides kCodec, kIsLossless, kMaxExpansion and
+//   uint8_t* encode(const int16_t* pSamples, numFrames, numChannels, pOut, pEnd)
+// which returns the end of the encoded bytes or nullptr if they don't fit.
+template <typename Sender, typename Compression>
+struct CompressedEncoder
+{
+  static constexpr uint32_t kMaxExpansion = Compression::kMaxExpansion;
+
+  CompressedEncoder(util::Injected<Sender> sender, Id channelId)
+    : mSender(std::move(sender))
+  {
+    mOutputBuffer.channelId = channelId;
+  }
+
+  void setMaxNumBytes(const uint32_t maxNumBytes)
+  {
+    mMaxNumBytes = std::min(maxNumBytes, AudioBuffer::kMaxAudioBytes);
+  }
+
+  void operator()(const int16_t* samples,
+                  const AudioBuffer::Chunks& chunks,
+                  const uint32_t numChannels,
+                  const uint32_t sampleRate,
+                  const Id sessionId)
+  {
+    mOutputBuffer.sampleRate = sampleRate;
+    mOutputBuffer.numChannels = static_cast<uint8_t>(numChannels);
+    mOutputBuffer.sessionId = sessionId;
+    encode(samples, chunks);
+  }
+
+private:
+  void encode(const int16_t* samples, const AudioBuffer::Chunks& chunks)
+  {
+    const auto numChannels = uint32_t{mOutputBuffer.numChannels};
+    const auto numFrames = std::accumulate(chunks.begin(),
+                                           chunks.end(),
+                                           0u,
+                                           [](uint32_t sum, const auto& chunk)
+                                           { return sum + chunk.numFrames; });
+    const auto chunkBytes =
+      static_cast<uint32_t>((chunks.size() - 1) * sizeInByteStream(chunks.front()));
+    const auto availableBytes = mMaxNumBytes > chunkBytes ? mMaxNumBytes - chunkBytes : 0;
+    const auto pcmBytes = numFrames * numChannels * uint32_t{sizeof(int16_t)};
+
+    // Lossless codecs only pay off if they are smaller than PCM
+    const auto maxNumBytes =
+      Compression::kIsLossless ? std::min(availableBytes, pcmBytes - 1) : availableBytes;
+
+    const auto pBytes = mOutputBuffer.bytes.data();
+    const auto pEnd = Compression::encode(
+      samples, numFrames, numChannels, pBytes, pBytes + maxNumBytes);
+    if (pEnd != nullptr)
+    {
+      send(chunks, Compression::kCodec, static_cast<uint32_t>(pEnd - pBytes));
+    }
+    else if (pcmBytes <= availableBytes || numFrames < 2)
+    {
+      detail::samplesToNetworkByteStream(samples, numFrames * numChannels, pBytes);
+      send(chunks, Codec::kPCM_i16, pcmBytes);
+    }
+    else
+    {
+      const auto numFirstFrames = numFrames / 2;
+      const auto [first, second] = split(chunks, numFirstFrames);
+      encode(samples, first);
+      encode(samples + numFirstFrames * numChannels, second);
+    }
+  }
+
+  std::pair<AudioBuffer::Chunks, AudioBuffer::Chunks> split(
+    const AudioBuffer::Chunks& chunks, const uint32_t numFirstFrames) const
+  {
+    auto result = std::pair<AudioBuffer::Chunks, AudioBuffer::Chunks>{};
+    auto numFrames = uint32_t{0};
+    for (const auto& chunk : chunks)
+    {
+      if (numFrames + chunk.numFrames <= numFirstFrames)
+      {
+        result.first.push_back(chunk);
+      }
+      else if (numFrames >= numFirstFrames)
+      {
+        result.second.push_back(chunk);
+      }
+      else
+      {
+        const auto head = static_cast<uint16_t>(numFirstFrames - numFrames);
+        const auto secondsPerBeat = 60.0 / chunk.tempo.bpm();
+        const auto headDuration =
+          static_cast<double>(head) / static_cast<double>(mOutputBuffer.sampleRate);
+        result.first.push_back({chunk.count, head, chunk.beginBeats, chunk.tempo});
+        result.second.push_back(
+          {chunk.count,
+           static_cast<uint16_t>(chunk.numFrames - head),
+           chunk.beginBeats + link::Beats{headDuration / secondsPerBeat},
+           chunk.tempo});
+      }
+      numFrames += chunk.numFrames;
+    }
+    return result;
+  }
+
+  void send(const AudioBuffer::Chunks& chunks, const Codec codec, const uint32_t numBytes)
+  {
+    mOutputBuffer.chunks = chunks;
+    for (auto& chunk : mOutputBuffer.chunks)
+    {
+      chunk.count = ++mCount;
+    }
+    mOutputBuffer.codec = codec;
+    mOutputBuffer.numBytes = static_cast<uint16_t>(numBytes);
+    (*mSender)(mOutputBuffer);
+  }
+
+  AudioBuffer mOutputBuffer;
+  util::Injected<Sender> mSender;
+  uint32_t mMaxNumBytes = AudioBuffer::kMaxAudioBytes;
+  uint64_t mCount = 0;
+};
+
+} // namespace link_audio
+} // namespace ableton
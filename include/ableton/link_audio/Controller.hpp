@@ -21,6 +21,7 @@
 
 #include <ableton/discovery/AsioTypes.hpp>
 #include <ableton/link/Controller.hpp>
+#include <ableton/link/GhostXForm.hpp>
 #include <ableton/link_audio/Channels.hpp>
 #include <ableton/link_audio/Id.hpp>
 #include <ableton/link_audio/MainProcessor.hpp>
@@ -29,6 +30,7 @@
 #include <ableton/link_audio/UdpMessenger.hpp>
 #include <ableton/util/Injected.hpp>
 #include <ableton/util/Locked.hpp>
+#include <ableton/util/RcuSlot.hpp>
 #include <algorithm>
 #include <atomic>
 #include <functional>
@@ -68,23 +70,36 @@ public:
                                           IoContext,
                                           SessionController>;
 
+  // Link Audio runs on its own thread so that audio traffic can't delay the timing
+  // critical work on the Link thread. State owned by one thread is only passed to the
+  // other one by value via async.
   Controller(link::Tempo tempo,
              link::PeerCountCallback peerCallback,
              link::TempoCallback tempoCallback,
              link::StartStopStateCallback startStopStateCallback,
              Clock clock)
     : LinkController(tempo, peerCallback, tempoCallback, startStopStateCallback, clock)
+    , mAudioIo(IoContext{AudioUdpSendExceptionHandler{this}, "Link Audio"})
+    , mAudioNodeId(this->mNodeId)
+    , mAudioSessionId(this->mSessionId)
     , mChannelsChangedCallback{[]() {}}
     , mApiChannels({})
     , mIsLinkAudioEnabledByUser(false)
     , mIsLinkAudioEffectivlyEnabled(false)
     , mPeerInfo({})
-    , mChannels(util::injectRef(*(this->mIo)), ChannelsChanged{this})
-    , mProcessor{util::injectRef(*(this->mIo)), util::injectVal(ChannelsCallback{this})}
-    , mGateways{util::injectVal(GatewayFactory{this}), util::injectRef(*(this->mIo))}
+    , mGhostXForm(this->mSessionState.ghostXForm)
+    , mChannels(util::injectRef(*mAudioIo), ChannelsChanged{this})
+    , mProcessor{util::injectRef(*mAudioIo), util::injectVal(ChannelsCallback{this})}
+    , mGateways{util::injectVal(GatewayFactory{this}), util::injectRef(*mAudioIo)}
   {
   }
 
+  ~Controller()
+  {
+    // The Link thread has been stopped by the SessionController at this point
+    mAudioIo->stop();
+  }
+
   void enableLinkAudio(bool enabled)
   {
     mIsLinkAudioEnabledByUser = enabled;
@@ -115,20 +130,27 @@ public:
     this->mIo->async([func = std::move(func)]() { func(); });
   }
 
-  SharedSink addSink(std::string name, size_t maxNumSamples)
+  void callOnLinkAudioThread(CallOnThreadFunction func)
   {
-    auto id = Id::random<Random>();
-    auto sink = std::make_shared<Sink>(name, maxNumSamples, id);
+    mAudioIo->async([func = std::move(func)]() { func(); });
+  }
 
-    this->mIo->async(
+  SharedSink addSink(std::string name, size_t maxNumSamples, size_t queueDepth)
+  {
+    auto id = Id::random<Random>();
+    auto sink = std::make_shared<Sink>(name,
+                                       maxNumSamples,
+                                       id,
+                                       mProcessor.commitCallback(),
+                                       queueDepth,
+                                       [this]() { return ghostTime(); });
+
+    mAudioIo->async(
       [this, sink]()
       {
         this->mProcessor.addSink(
           sink, util::injectVal(GetSender{this}), util::injectVal(GetNodeId{this}));
-        if (this->mpSessionController)
-        {
-          this->mpSessionController->updateDiscoveryCallback();
-        }
+        updateDiscoveryOnLinkThread();
       });
 
     return sink;
@@ -136,9 +158,10 @@ public:
 
   SharedSource addSource(Id channelId, Source::Callback callback)
   {
-    auto source = std::make_shared<Source>(std::move(channelId), std::move(callback));
+    auto source = std::make_shared<Source>(
+      std::move(channelId), std::move(callback), [this]() { return ghostTime(); });
 
-    this->mIo->async(
+    mAudioIo->async(
       [this, source]()
       {
         mProcessor.addSource(
@@ -150,12 +173,23 @@ public:
 
   void setChannelsChangedCallback(ChannelsChangedCallback callback)
   {
-    this->mIo->async([&, callback = std::move(callback)]()
-                     { mChannelsChangedCallback = callback; });
+    mAudioIo->async([&, callback = std::move(callback)]()
+                    { mChannelsChangedCallback = callback; });
   }
 
   auto channels() const { return mApiChannels.read(); }
 
+  auto peerNetworkStats() const { return mChannels.peerNetworkStats(); }
+
+  // The current time in the ghost time of the session. Realtime safe.
+  std::chrono::microseconds ghostTime() const
+  {
+    auto ghostTime = std::chrono::microseconds{};
+    mGhostXForm.read([&](const auto& xform)
+                     { ghostTime = xform.hostToGhost(this->mClock.micros()); });
+    return ghostTime;
+  }
+
 protected:
   void updateIsLinkAudioEnabled()
   {
@@ -168,16 +202,30 @@ protected:
     else if (!shouldBeEnabled && mIsLinkAudioEffectivlyEnabled)
     {
       mIsLinkAudioEffectivlyEnabled = false;
-      mGateways.clear();
+      mAudioIo->async([this]() { mGateways.clear(); });
     }
   }
 
   void updateAudioDiscovery()
   {
-    mGateways.updateAnnouncement(PeerAnnouncement{this->mNodeId,
-                                                  this->mSessionId,
-                                                  mPeerInfo.read(),
-                                                  mProcessor.channelAnnouncements()});
+    // Replacing the transformation blocks until readers are done, so only do it when it
+    // changed
+    auto xformChanged = false;
+    mGhostXForm.read([&](const auto& xform)
+                     { xformChanged = xform != this->mSessionState.ghostXForm; });
+    if (xformChanged)
+    {
+      mGhostXForm.write(this->mSessionState.ghostXForm);
+    }
+
+    mAudioIo->async(
+      [this, nodeId = this->mNodeId, sessionId = this->mSessionId]()
+      {
+        mAudioNodeId = nodeId;
+        mAudioSessionId = sessionId;
+        mGateways.updateAnnouncement(PeerAnnouncement{
+          nodeId, sessionId, mPeerInfo.read(), mProcessor.channelAnnouncements()});
+      });
   }
 
   void updateLinkAudio()
@@ -189,19 +237,26 @@ protected:
       peers.insert(sessionPeer.first.nodeState.ident());
     }
 
-    mGateways.updateSessionPeers(begin(peers), end(peers));
+    mAudioIo->async(
+      [this, peers = std::move(peers), sessionId = this->mSessionId]()
+      {
+        mAudioSessionId = sessionId;
+        mGateways.updateSessionPeers(begin(peers), end(peers));
 
-    // Remove channels for peers that are no longer in the session
-    mChannels.prunePeerChannels(peers.begin(), peers.end());
+        // Remove channels for peers that are no longer in the session
+        mChannels.prunePeerChannels(peers.begin(), peers.end());
 
-    updateApiChannels();
+        updateApiChannels();
+      });
   }
 
   void sawLinkAudioEndpoint(link::NodeId peerId,
                             std::optional<discovery::UdpEndpoint> endpoint,
                             discovery::IpAddress gateway)
   {
-    mGateways.sawLinkAudioEndpoint(peerId, endpoint, gateway);
+    mAudioIo->async(
+      [this, peerId, endpoint, gateway]()
+      { mGateways.sawLinkAudioEndpoint(peerId, endpoint, gateway); });
   }
 
   void updateLinkAudioGateways()
@@ -213,15 +268,28 @@ protected:
 
     if (mIsLinkAudioEffectivlyEnabled)
     {
-      mGateways.updateGateways(std::move(gateways));
+      mAudioIo->async([this, gateways = std::move(gateways)]() mutable
+                      { mGateways.updateGateways(std::move(gateways)); });
       updateLinkAudio();
     }
     else
     {
-      mGateways.clear();
+      mAudioIo->async([this]() { mGateways.clear(); });
     }
   }
 
+  void updateDiscoveryOnLinkThread()
+  {
+    this->mIo->async(
+      [this]()
+      {
+        if (this->mpSessionController)
+        {
+          this->mpSessionController->updateDiscoveryCallback();
+        }
+      });
+  }
+
   void updateAudioEndpoints(std::vector<discovery::UdpEndpoint> endpoints)
   {
     this->mDiscovery.withGateways(
@@ -251,7 +319,7 @@ protected:
   void updateApiChannels()
   {
     auto channelsChanged = false;
-    auto currentChannels = mChannels.uniqueSessionChannels(this->mSessionId);
+    auto currentChannels = mChannels.uniqueSessionChannels(mAudioSessionId);
 
     std::sort(currentChannels.begin(),
               currentChannels.end(),
@@ -304,12 +372,22 @@ protected:
       return mpController->mChannels.peerSendHandler(id);
     }
 
+    std::optional<discovery::UdpEndpoint> multicastGroup(const Id& channelId)
+    {
+      return mpController->mChannels.channelMulticastGroup(channelId);
+    }
+
+    auto channelNetworkStats(const Id& channelId)
+    {
+      return mpController->mChannels.channelNetworkStats(channelId);
+    }
+
     Controller* mpController;
   };
 
   struct GetNodeId
   {
-    const link::NodeId& operator()() const { return mpController->mNodeId; }
+    const link::NodeId& operator()() const { return mpController->mAudioNodeId; }
 
     Controller* mpController;
   };
@@ -318,9 +396,9 @@ protected:
   {
     void operator()()
     {
-      if (mpController && mpController->mpSessionController)
+      if (mpController)
       {
-        mpController->mpSessionController->updateDiscoveryCallback();
+        mpController->updateDiscoveryOnLinkThread();
       }
     }
 
@@ -340,11 +418,11 @@ protected:
     {
       return makeMessengerPtr(
         util::injectRef(mpController->mProcessor),
-        util::injectRef(*(mpController->mIo)),
+        util::injectRef(*(mpController->mAudioIo)),
         addr,
         util::injectVal(makeGatewayObserver(mpController->mChannels, addr)),
-        PeerAnnouncement{mpController->mNodeId,
-                         mpController->mSessionId,
+        PeerAnnouncement{mpController->mAudioNodeId,
+                         mpController->mAudioSessionId,
                          mpController->mPeerInfo.read(),
                          mpController->mProcessor.channelAnnouncements()});
     }
@@ -361,7 +439,24 @@ protected:
                          std::back_inserter(endpoints),
                          [](auto gateway) { return gateway.second->endpoint(); });
         });
-      mpController->updateAudioEndpoints(std::move(endpoints));
+      mpController->mIo->async(
+        [pController = mpController, endpoints = std::move(endpoints)]() mutable
+        { pController->updateAudioEndpoints(std::move(endpoints)); });
+    }
+
+    Controller* mpController;
+  };
+
+  // Send errors of the audio sockets are handled like those of the discovery sockets
+  struct AudioUdpSendExceptionHandler
+  {
+    using Exception = discovery::UdpSendException;
+
+    void operator()(const Exception exception)
+    {
+      mpController->mIo->async(
+        [pController = mpController, exception]
+        { pController->mDiscovery.repairGateway(exception.interfaceAddr); });
     }
 
     Controller* mpController;
@@ -371,14 +466,20 @@ protected:
   {
     mIsLinkAudioEnabledByUser = false;
     updateIsLinkAudioEnabled();
-    mProcessor.stop();
+    mAudioIo->async([this]() { mProcessor.stop(); });
   }
 
+  util::Injected<IoContext> mAudioIo;
+  // Copies of the Link thread's node and session ids for use on the audio thread
+  link::NodeId mAudioNodeId;
+  link::SessionId mAudioSessionId;
   ChannelsChangedCallback mChannelsChangedCallback;
   util::Locked<std::vector<typename ControllerChannels::Channel>> mApiChannels;
   std::atomic_bool mIsLinkAudioEnabledByUser;
   bool mIsLinkAudioEffectivlyEnabled;
   util::Locked<PeerInfo> mPeerInfo;
+  // Copy of the Link thread's ghost transformation for use on any thread
+  util::RcuSlot<link::GhostXForm> mGhostXForm;
   ControllerChannels mChannels;
   ControllerMainProcessor mProcessor;
   PeerGateways<GatewayFactory, IoContext&> mGateways;
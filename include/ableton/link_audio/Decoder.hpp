@@ -0,0 +1,106 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/link_audio/ADPCMCodec.hpp>
+#include <ableton/link_audio/AudioBuffer.hpp>
+#include <ableton/link_audio/Buffer.hpp>
+#include <ableton/link_audio/LPCCodec.hpp>
+#include <ableton/link_audio/PCMCodec.hpp>
+#include <ableton/util/Injected.hpp>
+#include <memory>
+#include <stdexcept>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+// Decodes audio buffers of every supported codec and passes on one buffer per chunk. The
+// samples are converted straight from the serialized bytes.
+// Throws std::runtime_error for buffers that can't be decoded.
+template <typename Successor>
+struct Decoder
+{
+  Decoder(util::Injected<Successor> successor, uint32_t cacheSize)
+    : mBuffer(cacheSize)
+    , mSuccessor(std::move(successor))
+  {
+  }
+
+  void operator()(const AudioBufferView& input)
+  {
+    const auto numSamples = size_t{input.numFrames()} * input.numChannels;
+    if (numSamples > mBuffer.mSamples.size())
+    {
+      throw std::range_error("Audio buffer exceeds decoder cache");
+    }
+
+    switch (input.codec)
+    {
+    case Codec::kPCM_i16:
+      if (numSamples * sizeof(int16_t) != input.numBytes)
+      {
+        throw std::range_error("Byte count / frame count mismatch.");
+      }
+      detail::samplesFromNetworkByteStream(
+        input.pBytes, numSamples, mBuffer.mSamples.data());
+      break;
+    case Codec::kLPC_i16:
+      detail::lpcDecode(input.pBytes,
+                        input.pBytes + input.numBytes,
+                        input.numFrames(),
+                        input.numChannels,
+                        mBuffer.mSamples.data());
+      break;
+    case Codec::kADPCM_i4:
+      detail::adpcmDecode(input.pBytes,
+                          input.pBytes + input.numBytes,
+                          input.numFrames(),
+                          input.numChannels,
+                          mBuffer.mSamples.data());
+      break;
+    default:
+      throw std::runtime_error("Unsupported codec.");
+    }
+
+    auto pSamples = mBuffer.mSamples.data();
+
+    for (const auto& [count, numFrames, beginBeats, tempo] : input.chunks)
+    {
+      mBuffer.mNumFrames = numFrames;
+      mBuffer.mNumChannels = input.numChannels;
+      mBuffer.mSampleRate = input.sampleRate;
+      mBuffer.mBeginBeats = beginBeats;
+      mBuffer.mTempo = tempo;
+      mBuffer.mCount = count;
+      mBuffer.mSessionId = input.sessionId;
+
+      (*mSuccessor)(BufferCallbackHandle<Buffer<int16_t>>{mBuffer, pSamples});
+      pSamples += numFrames * input.numChannels;
+    }
+  }
+
+  Buffer<int16_t> mBuffer;
+  util::Injected<Successor> mSuccessor;
+};
+
+} // namespace link_audio
+} // namespace ableton
@@ -19,12 +19,15 @@
 
 #pragma once
 
+#include <ableton/link_audio/ADPCMCodec.hpp>
 #include <ableton/link_audio/AudioBuffer.hpp>
 #include <ableton/link_audio/Buffer.hpp>
 #include <ableton/link_audio/Id.hpp>
+#include <ableton/link_audio/LPCCodec.hpp>
 #include <ableton/link_audio/PCMCodec.hpp>
 #include <ableton/link_audio/Resizer.hpp>
 #include <ableton/util/Injected.hpp>
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <stdexcept>
@@ -34,23 +37,80 @@ namespace ableton
 namespace link_audio
 {
 
-template <typename Sender, typename SampleFormat>
+namespace detail
+{
+
+template <typename SampleFormat, typename Sender, Codec kCodec>
+struct CodecEncoder
+{
+  static_assert(kCodec == Codec::kPCM_i16, "Unsupported codec");
+  using type = PCMEncoder<SampleFormat, Sender>;
+  static constexpr uint32_t kExpansion = 1;
+};
+
+template <typename Sender>
+struct CodecEncoder<int16_t, Sender, Codec::kLPC_i16>
+{
+  using type = LPCEncoder<Sender>;
+  static constexpr uint32_t kExpansion = LPCEncoder<Sender>::kMaxExpansion;
+};
+
+template <typename Sender>
+struct CodecEncoder<int16_t, Sender, Codec::kADPCM_i4>
+{
+  using type = ADPCMEncoder<Sender>;
+  static constexpr uint32_t kExpansion = ADPCMEncoder<Sender>::kMaxExpansion;
+};
+
+} // namespace detail
+
+// Collects samples into audio buffers that fit into a message and encodes them with
+// kCodec. Codecs that compress collect more frames than fit into a message uncompressed,
+// which delays sending accordingly.
+template <typename Sender, typename SampleFormat, Codec kCodec = Codec::kPCM_i16>
 struct Encoder
 {
-  // TODO: Find the best size for audio buffer messages
-  // For now we take RFC 791 as a reference. Nodes must be able to process IP messages of
-  // at least 576 bytes.
-  static constexpr uint32_t kMaxAudioBytes =
-    576 - v1::kHeaderSize - AudioBuffer::kNonAudioBytes;
+  static constexpr uint32_t kMaxAudioBytes = v1::kDefaultMaxAudioBufferMessageSize
+                                             - v1::kHeaderSize
+                                             - AudioBuffer::kNonAudioBytes;
   static_assert(kMaxAudioBytes <= v1::kMaxPayloadSize);
+  // Smaller messages leave room for the timing and parity that are added to messages
+  // of the default size
+  static constexpr size_t kMinMessageSize = v1::kDefaultMaxAudioBufferMessageSize / 2;
+
+  using CodecEncoder = typename detail::CodecEncoder<SampleFormat, Sender, kCodec>::type;
+  static constexpr uint32_t kExpansion =
+    detail::CodecEncoder<SampleFormat, Sender, kCodec>::kExpansion;
 
   Encoder(util::Injected<Sender> sender, Id channelId)
-    : mProcessor(
-        util::injectVal(PCMEncoder<SampleFormat, Sender>(std::move(sender), channelId)))
+    : mCodecEncoder(std::move(sender), channelId)
+    , mProcessor(util::injectRef(mCodecEncoder))
+  {
+    setMaxNumBytes(kMaxAudioBytes);
+  }
+
+  // The resizer refers to the codec encoder
+  Encoder(const Encoder&) = delete;
+  Encoder& operator=(const Encoder&) = delete;
+
+  size_t maxMessageSize() const
+  {
+    return mProcessor.maxNumBytes() / kExpansion + v1::kHeaderSize
+           + AudioBuffer::kNonAudioBytes;
+  }
+
+  // Set the size of the largest audio buffer message including the header. The size is
+  // clamped to [kMinMessageSize, v1::kMaxMessageSize]. Samples that are pending for the
+  // previous size are sent first.
+  void setMaxMessageSize(size_t maxMessageSize)
   {
+    maxMessageSize = std::clamp(maxMessageSize, kMinMessageSize, v1::kMaxMessageSize);
+    setMaxNumBytes(static_cast<uint32_t>(
+      maxMessageSize - v1::kHeaderSize - AudioBuffer::kNonAudioBytes));
   }
 
-  void operator()(const Buffer<SampleFormat>& input)
+  template <typename SampleStorage>
+  void operator()(const Buffer<SampleFormat, SampleStorage>& input)
   {
     mProcessor(input.mSamples.data(),
                input.mNumFrames,
@@ -61,8 +121,23 @@ struct Encoder
                input.mSessionId);
   }
 
+  // Send the pending samples without waiting for a full packet
+  void flush() { mProcessor.flush(); }
+
 private:
-  Resizer<SampleFormat, PCMEncoder<SampleFormat, Sender>, kMaxAudioBytes> mProcessor;
+  void setMaxNumBytes(const uint32_t maxNumBytes)
+  {
+    // Pending samples have to be sent with the previous size
+    mProcessor.setMaxNumBytes(maxNumBytes * kExpansion);
+    if constexpr (kCodec != Codec::kPCM_i16)
+    {
+      mCodecEncoder.setMaxNumBytes(maxNumBytes);
+    }
+  }
+
+  CodecEncoder mCodecEncoder;
+  Resizer<SampleFormat, CodecEncoder&, AudioBuffer::kMaxAudioBytes * kExpansion>
+    mProcessor;
 };
 
 } // namespace link_audio
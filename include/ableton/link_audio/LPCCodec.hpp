@@ -0,0 +1,373 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/link_audio/AudioBuffer.hpp>
+#include <ableton/link_audio/CompressedEncoder.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace detail
+{
+
+// Lossless coding of 16 bit samples in the style of Shorten and FLAC. Every channel is
+// predicted with the fixed polynomial predictor of order 0 to 4 that leaves the smallest
+// residuals. The first samples up to the order of the predictor are stored verbatim and
+// the residuals are Rice coded with one parameter per channel. Every packet can be
+// decoded on its own.
+//
+// Bitstream per channel, most significant bit first:
+//   order (3 bits) | rice parameter (5 bits) | warmup samples (16 bits each) | residuals
+// The stream is padded with zero bits to a whole number of bytes.
+
+constexpr uint32_t kLPCMaxOrder = 4;
+constexpr uint32_t kLPCMaxRiceParameter = 20;
+// A unary quotient of this many ones without a terminating zero is followed by the
+// folded residual in kLPCEscapeBits. Residuals of order 4 fit into 20 bits.
+constexpr uint32_t kLPCEscapeQuotient = 24;
+constexpr uint32_t kLPCEscapeBits = 21;
+// Mono packets of twice the largest PCM packet
+constexpr uint32_t kLPCMaxNumFrames = AudioBuffer::kMaxAudioBytes;
+
+class BitWriter
+{
+public:
+  BitWriter(uint8_t* pBegin, uint8_t* pEnd)
+    : mpOut(pBegin)
+    , mpEnd(pEnd)
+  {
+  }
+
+  // Write the lowest numBits of value, numBits must not exceed 32
+  void write(const uint32_t value, const uint32_t numBits)
+  {
+    mAccumulator = (mAccumulator << numBits) | value;
+    mNumBits += numBits;
+    while (mNumBits >= 8)
+    {
+      mNumBits -= 8;
+      put(static_cast<uint8_t>(mAccumulator >> mNumBits));
+    }
+    mAccumulator &= (uint64_t{1} << mNumBits) - 1;
+  }
+
+  void writeUnary(uint32_t numOnes)
+  {
+    while (numOnes >= 16)
+    {
+      write(0xffff, 16);
+      numOnes -= 16;
+    }
+    write(((1u << numOnes) - 1) << 1, numOnes + 1);
+  }
+
+  // Pad to the next byte. Returns the end of the written bytes or nullptr if they didn't
+  // fit.
+  uint8_t* finish()
+  {
+    if (mNumBits > 0)
+    {
+      write(0, 8 - mNumBits);
+    }
+    return mFits ? mpOut : nullptr;
+  }
+
+private:
+  void put(const uint8_t byte)
+  {
+    if (mpOut == mpEnd)
+    {
+      mFits = false;
+      return;
+    }
+    *mpOut++ = byte;
+  }
+
+  uint8_t* mpOut;
+  uint8_t* mpEnd;
+  uint64_t mAccumulator = 0;
+  uint32_t mNumBits = 0;
+  bool mFits = true;
+};
+
+// Throws std::range_error when reading past the end
+class BitReader
+{
+public:
+  BitReader(const uint8_t* pBegin, const uint8_t* pEnd)
+    : mpIn(pBegin)
+    , mpEnd(pEnd)
+  {
+  }
+
+  uint32_t read(const uint32_t numBits)
+  {
+    while (mNumBits < numBits)
+    {
+      if (mpIn == mpEnd)
+      {
+        throw std::range_error("Reading lossless audio from byte stream failed");
+      }
+      mAccumulator = (mAccumulator << 8) | *mpIn++;
+      mNumBits += 8;
+    }
+    mNumBits -= numBits;
+    const auto value =
+      static_cast<uint32_t>((mAccumulator >> mNumBits) & ((uint64_t{1} << numBits) - 1));
+    mAccumulator &= (uint64_t{1} << mNumBits) - 1;
+    return value;
+  }
+
+  // Count ones up to the terminating zero, but at most maxNumOnes
+  uint32_t readUnary(const uint32_t maxNumOnes)
+  {
+    auto numOnes = uint32_t{0};
+    while (numOnes < maxNumOnes && read(1) == 1)
+    {
+      ++numOnes;
+    }
+    return numOnes;
+  }
+
+private:
+  const uint8_t* mpIn;
+  const uint8_t* mpEnd;
+  uint64_t mAccumulator = 0;
+  uint32_t mNumBits = 0;
+};
+
+// Prediction of sample i from the preceding samples of the same channel
+template <typename Sample>
+int32_t lpcPrediction(const Sample* pChannel,
+                      const size_t stride,
+                      const uint32_t i,
+                      const uint32_t order)
+{
+  const auto x = [&](const uint32_t j)
+  { return static_cast<int32_t>(pChannel[j * stride]); };
+  switch (order)
+  {
+  case 1:
+    return x(i - 1);
+  case 2:
+    return 2 * x(i - 1) - x(i - 2);
+  case 3:
+    return 3 * x(i - 1) - 3 * x(i - 2) + x(i - 3);
+  case 4:
+    return 4 * x(i - 1) - 6 * x(i - 2) + 4 * x(i - 3) - x(i - 4);
+  default:
+    return 0;
+  }
+}
+
+inline uint32_t foldResidual(const int32_t residual)
+{
+  return (static_cast<uint32_t>(residual) << 1) ^ static_cast<uint32_t>(residual >> 31);
+}
+
+inline int32_t unfoldResidual(const uint32_t folded)
+{
+  return static_cast<int32_t>(folded >> 1) ^ -static_cast<int32_t>(folded & 1);
+}
+
+inline uint32_t riceCodeSize(const uint32_t folded, const uint32_t riceParameter)
+{
+  const auto quotient = folded >> riceParameter;
+  return quotient < kLPCEscapeQuotient ? quotient + 1 + riceParameter
+                                       : kLPCEscapeQuotient + kLPCEscapeBits;
+}
+
+inline void writeLPCChannel(BitWriter& writer,
+                            const int16_t* pChannel,
+                            const size_t stride,
+                            const uint32_t numFrames,
+                            uint32_t* pFolded)
+{
+  // The residual of each order is the difference of the residuals of the order below,
+  // so all orders are evaluated in a single pass. Pick the order with the smallest sum
+  // of residuals over the samples all orders can predict.
+  const auto maxOrder = std::min(kLPCMaxOrder, numFrames);
+  auto sums = std::array<uint64_t, kLPCMaxOrder + 1>{};
+  auto previous = std::array<int32_t, kLPCMaxOrder + 1>{};
+  for (auto i = uint32_t{0}; i < numFrames; ++i)
+  {
+    auto residual = static_cast<int32_t>(pChannel[i * stride]);
+    for (auto o = uint32_t{0}; o <= maxOrder; ++o)
+    {
+      if (i >= maxOrder)
+      {
+        sums[o] += foldResidual(residual);
+      }
+      const auto next = residual - previous[o];
+      previous[o] = residual;
+      residual = next;
+    }
+  }
+  const auto order = static_cast<uint32_t>(std::distance(
+    sums.begin(), std::min_element(sums.begin(), sums.begin() + maxOrder + 1)));
+
+  // Estimate the rice parameter from the mean residual and refine it with the exact
+  // code size of its neighbours
+  const auto numResiduals = numFrames - order;
+  auto sum = uint64_t{0};
+  for (auto i = order; i < numFrames; ++i)
+  {
+    pFolded[i] =
+      foldResidual(pChannel[i * stride] - lpcPrediction(pChannel, stride, i, order));
+    sum += pFolded[i];
+  }
+  auto estimate = uint32_t{0};
+  while (estimate < kLPCMaxRiceParameter && (uint64_t{numResiduals} << estimate) < sum)
+  {
+    ++estimate;
+  }
+
+  auto riceParameter = estimate;
+  auto minSize = std::numeric_limits<uint64_t>::max();
+  for (auto k = estimate > 0 ? estimate - 1 : 0;
+       k <= std::min(estimate + 1, kLPCMaxRiceParameter);
+       ++k)
+  {
+    auto size = uint64_t{0};
+    for (auto i = order; i < numFrames; ++i)
+    {
+      size += riceCodeSize(pFolded[i], k);
+    }
+    if (size < minSize)
+    {
+      minSize = size;
+      riceParameter = k;
+    }
+  }
+
+  writer.write(order, 3);
+  writer.write(riceParameter, 5);
+  for (auto i = uint32_t{0}; i < order; ++i)
+  {
+    writer.write(static_cast<uint16_t>(pChannel[i * stride]), 16);
+  }
+  for (auto i = order; i < numFrames; ++i)
+  {
+    const auto folded = pFolded[i];
+    const auto quotient = folded >> riceParameter;
+    if (quotient < kLPCEscapeQuotient)
+    {
+      writer.writeUnary(quotient);
+      writer.write(folded & ((1u << riceParameter) - 1), riceParameter);
+    }
+    else
+    {
+      writer.write((1u << kLPCEscapeQuotient) - 1, kLPCEscapeQuotient);
+      writer.write(folded, kLPCEscapeBits);
+    }
+  }
+}
+
+// Encode interleaved samples. Returns the end of the encoded bytes or nullptr if they
+// don't fit into [pOut, pEnd).
+inline uint8_t* lpcEncode(const int16_t* pSamples,
+                          const uint32_t numFrames,
+                          const uint32_t numChannels,
+                          uint8_t* pOut,
+                          uint8_t* pEnd)
+{
+  assert(numFrames <= kLPCMaxNumFrames);
+  auto folded = std::array<uint32_t, kLPCMaxNumFrames>{};
+  auto writer = BitWriter{pOut, pEnd};
+  for (auto channel = uint32_t{0}; channel < numChannels; ++channel)
+  {
+    writeLPCChannel(writer, pSamples + channel, numChannels, numFrames, folded.data());
+  }
+  return writer.finish();
+}
+
+// Decode into interleaved samples. Throws std::range_error if the bytes are malformed.
+inline void lpcDecode(const uint8_t* pBegin,
+                      const uint8_t* pEnd,
+                      const uint32_t numFrames,
+                      const uint32_t numChannels,
+                      int16_t* pSamples)
+{
+  auto reader = BitReader{pBegin, pEnd};
+  for (auto channel = uint32_t{0}; channel < numChannels; ++channel)
+  {
+    auto pChannel = pSamples + channel;
+    const auto order = reader.read(3);
+    const auto riceParameter = reader.read(5);
+    if (order > kLPCMaxOrder || order > numFrames
+        || riceParameter > kLPCMaxRiceParameter)
+    {
+      throw std::range_error("Invalid lossless audio channel header");
+    }
+
+    for (auto i = uint32_t{0}; i < order; ++i)
+    {
+      pChannel[i * numChannels] = static_cast<int16_t>(reader.read(16));
+    }
+    for (auto i = order; i < numFrames; ++i)
+    {
+      const auto quotient = reader.readUnary(kLPCEscapeQuotient);
+      const auto folded = quotient < kLPCEscapeQuotient
+                            ? (quotient << riceParameter) | reader.read(riceParameter)
+                            : reader.read(kLPCEscapeBits);
+      const auto sample = lpcPrediction(pChannel, numChannels, i, order)
+                          + unfoldResidual(folded);
+      if (sample < std::numeric_limits<int16_t>::min()
+          || sample > std::numeric_limits<int16_t>::max())
+      {
+        throw std::range_error("Invalid lossless audio sample");
+      }
+      pChannel[i * numChannels] = static_cast<int16_t>(sample);
+    }
+  }
+}
+
+} // namespace detail
+
+// Lossless compression for the CompressedEncoder
+struct LPCCompression
+{
+  static constexpr Codec kCodec = Codec::kLPC_i16;
+  static constexpr bool kIsLossless = true;
+  static constexpr uint32_t kMaxExpansion = 2;
+
+  static uint8_t* encode(const int16_t* pSamples,
+                         const uint32_t numFrames,
+                         const uint32_t numChannels,
+                         uint8_t* pOut,
+                         uint8_t* pEnd)
+  {
+    return detail::lpcEncode(pSamples, numFrames, numChannels, pOut, pEnd);
+  }
+};
+
+template <typename Sender>
+using LPCEncoder = CompressedEncoder<Sender, LPCCompression>;
+
+} // namespace link_audio
+} // namespace ableton
@@ -0,0 +1,129 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+// Returns the current time in the ghost time of the session, which is comparable across
+// peers. Must be realtime safe.
+using GetGhostTime = std::function<std::chrono::microseconds()>;
+
+// Counts latencies in bins that double in width. Bin i counts latencies below
+// binLimit(i) that didn't fit into bin i - 1, the last bin counts all longer ones.
+// Adding is lock-free and realtime safe.
+class LatencyHistogram
+{
+public:
+  static constexpr size_t kNumBins = 16;
+  static constexpr auto kFirstBinLimit = std::chrono::microseconds{125};
+
+  using Counts = std::array<uint64_t, kNumBins>;
+
+  static std::chrono::microseconds binLimit(const size_t bin)
+  {
+    return bin + 1 < kNumBins ? kFirstBinLimit * (int64_t{1} << bin)
+                              : std::chrono::microseconds::max();
+  }
+
+  // Latencies below zero, e.g. due to the uncertainty of the ghost time, count as zero
+  void add(const std::chrono::microseconds latency)
+  {
+    auto bin = size_t{0};
+    while (bin + 1 < kNumBins && latency >= binLimit(bin))
+    {
+      ++bin;
+    }
+    ++mCounts[bin];
+  }
+
+  // Each count is read atomically, but the counts are not a consistent snapshot
+  Counts counts() const
+  {
+    auto counts = Counts{};
+    for (auto i = size_t{0}; i < kNumBins; ++i)
+    {
+      counts[i] = mCounts[i];
+    }
+    return counts;
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, kNumBins> mCounts{};
+};
+
+// Incrementally estimates a delay and its jitter from a series of measurements, like the
+// round trip time estimator of TCP (RFC 6298). Both follow new measurements with a gain
+// of 1/16, the gain of the interarrival jitter of RTP (RFC 3550).
+class DelayEstimator
+{
+public:
+  void operator()(const std::chrono::microseconds delay)
+  {
+    if (mNumSamples == 0)
+    {
+      mDelay = static_cast<double>(delay.count());
+      mJitter = mDelay / 2.;
+    }
+    else
+    {
+      const auto diff = static_cast<double>(delay.count()) - mDelay;
+      mDelay += diff / kGain;
+      mJitter += (std::abs(diff) - mJitter) / kGain;
+    }
+    ++mNumSamples;
+  }
+
+  size_t numSamples() const { return mNumSamples; }
+
+  std::chrono::microseconds delay() const { return toMicros(mDelay); }
+
+  std::chrono::microseconds jitter() const { return toMicros(mJitter); }
+
+  // The delay that all but late outliers stay below, as used for adaptive playout
+  std::chrono::microseconds playoutDelay() const
+  {
+    return toMicros(mDelay + kJitterFactor * mJitter);
+  }
+
+private:
+  static std::chrono::microseconds toMicros(const double micros)
+  {
+    return std::chrono::microseconds{std::llround(micros)};
+  }
+
+  static constexpr double kGain = 16.;
+  static constexpr double kJitterFactor = 4.;
+  double mDelay = 0.;
+  double mJitter = 0.;
+  size_t mNumSamples = 0;
+};
+
+} // namespace link_audio
+} // namespace ableton
@@ -19,13 +19,22 @@
 
 #pragma once
 
+#include <ableton/discovery/IpInterface.hpp>
 #include <ableton/link_audio/ChannelAnnouncements.hpp>
+#include <ableton/link_audio/Parity.hpp>
 #include <ableton/link_audio/Sink.hpp>
 #include <ableton/link_audio/SinkProcessor.hpp>
 #include <ableton/link_audio/Source.hpp>
 #include <ableton/link_audio/SourceProcessor.hpp>
 #include <ableton/util/Injected.hpp>
 #include <ableton/util/SafeAsyncHandler.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace ableton
 {
@@ -44,7 +53,13 @@ struct MainProcessor
 {
   using IoType = typename util::Injected<IoContext>::type;
 
-  static constexpr auto kProcessTimerPeriod = std::chrono::milliseconds(1);
+  // Committed sink buffers are processed as soon as the sink rings the doorbell. The
+  // timer only picks up name changes, removed channels and other housekeeping.
+  static constexpr auto kHousekeepingPeriod = std::chrono::milliseconds(50);
+  // Upper bound for the delay of a doorbell ring whose notification couldn't be sent
+  // without blocking. Housekeeping also answers the doorbell, so in practice the delay
+  // is bounded by kHousekeepingPeriod. Long, so that idle sinks rarely wake the thread.
+  static constexpr auto kDoorbellFallbackPeriod = std::chrono::milliseconds(500);
 
   MainProcessor(util::Injected<IoContext> io,
                 util::Injected<ChannelsChangedCallback> callback)
@@ -70,6 +85,12 @@ struct MainProcessor
     mpImpl->addSource(pSource, std::move(getSender), std::move(getNodeId));
   }
 
+  // Callback for sinks to signal committed buffers from the audio thread
+  Sink::CommitCallback commitCallback() const
+  {
+    return [pDoorbell = mpImpl->mpDoorbell]() { pDoorbell->ring(); };
+  }
+
   ChannelAnnouncements channelAnnouncements() const
   {
     return mpImpl->channelAnnouncements();
@@ -87,6 +108,24 @@ struct MainProcessor
     mpImpl->receiveAudioBuffer(begin, end);
   }
 
+  template <typename It>
+  void receiveAudioBuffer(It begin, It end, discovery::MulticastTag tag)
+  {
+    mpImpl->receiveAudioBuffer(begin, end, tag);
+  }
+
+  template <typename It>
+  void receiveAudioParity(It begin, It end)
+  {
+    mpImpl->receiveAudioParity(begin, end);
+  }
+
+  template <typename It>
+  void receiveAudioParity(It begin, It end, discovery::MulticastTag tag)
+  {
+    mpImpl->receiveAudioParity(begin, end, tag);
+  }
+
 private:
   struct Impl : std::enable_shared_from_this<Impl>
   {
@@ -94,13 +133,93 @@ private:
     using MainSinkProcessor = SinkProcessor<GetSender, GetNodeId, IoContext&>;
     using MainSourceProcessor = SourceProcessor<GetSender, GetNodeId, IoContext&>;
 
+    // Ringing is lock free and does not allocate. The dispatcher thread answers by
+    // posting to the io thread. Rings are coalesced until they have been answered.
+    // The dispatcher thread only runs while there are sinks. Sinks only ring once
+    // their processor has connected them, so there is a dispatcher whenever they ring.
+    struct Doorbell
+    {
+      using Dispatcher =
+        typename IoType::template LockFreeCallbackDispatcher<std::function<void()>,
+                                                             std::chrono::milliseconds>;
+
+      Doorbell(std::function<void()> callback)
+        : mCallback(std::move(callback))
+      {
+      }
+
+      // Called on the io thread
+      void start()
+      {
+        if (!mpDispatcher)
+        {
+          mIsRinging = false;
+          mpDispatcher = std::make_unique<Dispatcher>(
+            [this]()
+            {
+              if (mIsRinging)
+              {
+                mCallback();
+              }
+            },
+            kDoorbellFallbackPeriod);
+          mpDispatcher->start();
+        }
+      }
+
+      // Called on the io thread. Rings of sinks that outlive the processor still reach
+      // the stopped dispatcher, so it is kept.
+      void stop()
+      {
+        if (mpDispatcher)
+        {
+          mpDispatcher->stop();
+        }
+      }
+
+      // Called on the io thread once the last sink is gone and nothing can ring
+      void release()
+      {
+        stop();
+        mpDispatcher.reset();
+      }
+
+      void ring()
+      {
+        if (!mIsRinging.exchange(true))
+        {
+          mpDispatcher->invoke();
+        }
+      }
+
+      bool answer() { return mIsRinging.exchange(false); }
+
+      std::function<void()> mCallback;
+      std::atomic<bool> mIsRinging{false};
+      std::unique_ptr<Dispatcher> mpDispatcher;
+    };
+
     Impl(util::Injected<IoContext> io, util::Injected<ChannelsChangedCallback> callback)
       : mIo{std::move(io)}
       , mChannelsChangedCallback{std::move(callback)}
       , mProcessTimer{mIo->makeTimer()}
+      , mpDoorbell{std::make_shared<Doorbell>(
+          [this]()
+          {
+            mIo->async(
+              [pImpl = this->weak_from_this()]()
+              {
+                if (auto p = pImpl.lock())
+                {
+                  p->answerDoorbell();
+                }
+              });
+          })}
     {
     }
 
+    ~Impl() { mpDoorbell->stop(); }
+
     void addSink(SharedSink pSink,
                  util::Injected<GetSender> getSender,
                  util::Injected<GetNodeId> getNodeId)
@@ -108,30 +227,55 @@ private:
       auto processor = std::make_unique<MainSinkProcessor>(
         util::injectRef(*mIo), pSink, std::move(getSender), std::move(getNodeId));
       mSinks.push_back(std::move(processor));
-      start();
+      mpDoorbell->start();
+      (*this)();
     }
 
     void addSource(SharedSource pSource,
                    util::Injected<GetSender> getSender,
                    util::Injected<GetNodeId> getNodeId)
     {
-      auto pProcessor = std::make_unique<MainSourceProcessor>(
-        util::injectRef(*mIo), pSource, std::move(getSender), std::move(getNodeId));
-      mSources.push_back(std::move(pProcessor));
-      start();
+      // Sources of a channel share its processor
+      const auto it = mSources.find(pSource->id());
+      if (it != mSources.end())
+      {
+        it->second->addSource(std::move(pSource));
+      }
+      else
+      {
+        const auto id = pSource->id();
+        mSources.emplace(id,
+                         std::make_unique<MainSourceProcessor>(util::injectRef(*mIo),
+                                                               std::move(pSource),
+                                                               std::move(getSender),
+                                                               std::move(getNodeId)));
+      }
+      (*this)();
     }
 
-    void start() { (*this)(); }
+    void stop()
+    {
+      mProcessTimer.cancel();
+      mpDoorbell->stop();
+    }
 
-    void stop() { mProcessTimer.cancel(); }
+    void answerDoorbell()
+    {
+      if (mpDoorbell->answer())
+      {
+        processSinks();
+      }
+    }
 
     void operator()()
     {
+      // Clears a ring that is still pending, so that later rings notify again
+      mpDoorbell->answer();
       processSinks();
       processSources();
       if (!mSinks.empty() || !mSources.empty())
       {
-        mProcessTimer.expires_from_now(kProcessTimerPeriod);
+        mProcessTimer.expires_from_now(kHousekeepingPeriod);
         mProcessTimer.async_wait(
           [this](const auto e)
           {
@@ -154,6 +298,11 @@ private:
           channelsChanged = true;
         }
 
+        if ((*it)->multicastChanged())
+        {
+          channelsChanged = true;
+        }
+
         if ((*it)->process())
         {
           ++it;
@@ -165,6 +314,11 @@ private:
         }
       }
 
+      if (mSinks.empty())
+      {
+        mpDoorbell->release();
+      }
+
       if (channelsChanged)
       {
         (*mChannelsChangedCallback)();
@@ -173,11 +327,9 @@ private:
 
     void processSources()
     {
-      auto channelsChanged = false;
-
       for (auto it = mSources.begin(); it != mSources.end();)
       {
-        if ((*it)->process())
+        if (it->second->process())
         {
           ++it;
         }
@@ -193,8 +345,11 @@ private:
       auto announcements = ChannelAnnouncements{};
       for (auto& sink : mSinks)
       {
+        auto group = sink->isMulticastEnabled()
+                       ? std::optional<discovery::UdpEndpoint>{multicastGroup(sink->id())}
+                       : std::nullopt;
         announcements.channels.emplace_back(
-          ChannelAnnouncement{sink->name(), sink->id()});
+          ChannelAnnouncement{sink->name(), sink->id(), std::move(group)});
       }
       return announcements;
     }
@@ -212,27 +367,53 @@ private:
       }
     }
 
-    template <typename It>
-    void receiveAudioBuffer(It begin, It end)
+    // Each buffer is deserialized and decoded once for all sources of its channel. Its
+    // audio bytes are decoded from where they were received.
+    template <typename It, typename... Tag>
+    void receiveAudioBuffer(It begin, It end, Tag... tag)
     {
-      static auto audioBuffer = AudioBuffer{};
-      AudioBuffer::fromNetworkByteStream(audioBuffer, begin, end);
+      AudioBufferView::fromNetworkByteStream(mAudioBuffer, begin, end);
 
-      auto it = std::find_if(mSources.begin(),
-                             mSources.end(),
-                             [&](const auto& pSource)
-                             { return audioBuffer.channelId == pSource->id(); });
-      if (it != mSources.end())
+      if (auto* pProcessor = sourcesFor(mAudioBuffer.channelId, tag...))
       {
-        it->get()->receiveAudioBuffer(audioBuffer);
+        pProcessor->receiveAudioBuffer(mAudioBuffer);
       }
     }
 
+    template <typename It, typename... Tag>
+    void receiveAudioParity(It begin, It end, Tag... tag)
+    {
+      AudioParity::fromNetworkByteStream(mAudioParity, begin, end);
+
+      if (auto* pProcessor = sourcesFor(mAudioParity.channelId, tag...))
+      {
+        pProcessor->receiveAudioParity(mAudioParity);
+      }
+    }
+
+    MainSourceProcessor* sourcesFor(const Id& channelId)
+    {
+      const auto it = mSources.find(channelId);
+      return it != mSources.end() ? it->second.get() : nullptr;
+    }
+
+    // Buffers sent to a multicast group are ignored unless the channel was requested
+    // via multicast. Otherwise channels that map to the same group would be received
+    // twice.
+    MainSourceProcessor* sourcesFor(const Id& channelId, discovery::MulticastTag)
+    {
+      auto* pProcessor = sourcesFor(channelId);
+      return pProcessor && pProcessor->isMulticastMember() ? pProcessor : nullptr;
+    }
+
     util::Injected<IoContext> mIo;
     util::Injected<ChannelsChangedCallback> mChannelsChangedCallback;
     std::vector<std::unique_ptr<MainSinkProcessor>> mSinks;
-    std::vector<std::unique_ptr<MainSourceProcessor>> mSources;
+    std::map<Id, std::unique_ptr<MainSourceProcessor>> mSources;
+    AudioBufferView mAudioBuffer;
+    AudioParity mAudioParity;
     Timer mProcessTimer;
+    std::shared_ptr<Doorbell> mpDoorbell;
   };
 
   std::shared_ptr<Impl> mpImpl;
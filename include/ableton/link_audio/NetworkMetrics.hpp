@@ -3,7 +3,8 @@
 #include <array>
 #include <chrono>
 #include <cmath>
-#include <numeric>
+#include <cstdint>
+#include <utility>
 
 namespace ableton
 {
@@ -31,16 +32,33 @@ struct NetworkMetricsFilter
   {
   }
 
+  // Keeps running sums of the window, so adding a time and reading the metrics is O(1)
   void operator()(std::chrono::microseconds time)
   {
-    mPingPongTimes[mCurrentIndex] = time;
-    mCurrentIndex = (mCurrentIndex + 1) % kMaxSize;
-    if (mCount < kMaxSize)
+    if (mCount == kMaxSize)
+    {
+      const auto oldest = mPingPongTimes[mCurrentIndex].count();
+      mSum -= oldest;
+      mSumOfSquares -= oldest * oldest;
+    }
+    else
     {
       ++mCount;
     }
+    mPingPongTimes[mCurrentIndex] = time;
+    mSum += time.count();
+    mSumOfSquares += time.count() * time.count();
+    mCurrentIndex = (mCurrentIndex + 1) % kMaxSize;
   }
 
+  // The mean and standard deviation of the recent ping-pong round trip times
+  struct Stats
+  {
+    std::chrono::microseconds roundTripTime;
+    std::chrono::microseconds jitter;
+    size_t numSamples;
+  };
+
   NetworkMetrics metrics() const
   {
     if (mCount == 0)
@@ -48,34 +66,42 @@ struct NetworkMetricsFilter
       return {0.0, 0.0};
     }
 
-    double sum =
-      std::accumulate(mPingPongTimes.begin(),
-                      mPingPongTimes.begin() + mCount,
-                      0.0,
-                      [](auto acc, const auto& time) { return acc + time.count(); });
-    double avgRTT = sum / mCount;
-
+    const auto [avgRTT, jitter] = meanAndDeviation();
     double speed = avgRTT != 0.0 ? 1e6 / avgRTT : 0.0;
 
-    double variance = 0.0;
-    for (size_t i = 0; i < mCount; ++i)
-    {
-      double diff = mPingPongTimes[i].count() - avgRTT;
-      variance += diff * diff;
-    }
-    variance /= mCount;
-    double jitter = std::sqrt(variance);
-
     return {speed, (1e4 - 1e4 * mCount / kMaxSize) + jitter};
   }
 
+  Stats stats() const
+  {
+    const auto [avgRTT, jitter] = meanAndDeviation();
+    return {std::chrono::microseconds{std::llround(avgRTT)},
+            std::chrono::microseconds{std::llround(jitter)},
+            mCount};
+  }
+
   double quality() const { return metrics().quality(); }
 
 private:
+  std::pair<double, double> meanAndDeviation() const
+  {
+    if (mCount == 0)
+    {
+      return {0.0, 0.0};
+    }
+
+    const auto count = static_cast<int64_t>(mCount);
+    const auto scaledVariance = count * mSumOfSquares - mSum * mSum;
+    return {static_cast<double>(mSum) / static_cast<double>(count),
+            std::sqrt(static_cast<double>(scaledVariance)) / static_cast<double>(count)};
+  }
+
   static constexpr size_t kMaxSize = 10;
   std::array<std::chrono::microseconds, kMaxSize> mPingPongTimes;
   size_t mCurrentIndex;
   size_t mCount;
+  int64_t mSum = 0;
+  int64_t mSumOfSquares = 0;
 };
 
 } // namespace link_audio
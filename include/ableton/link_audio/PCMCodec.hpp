@@ -23,12 +23,121 @@
 #include <ableton/link_audio/AudioBuffer.hpp>
 #include <ableton/link_audio/Buffer.hpp>
 #include <ableton/util/Injected.hpp>
+#include <ableton/util/Simd.hpp>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 namespace ableton
 {
 namespace link_audio
 {
+namespace detail
+{
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr auto kIsBigEndianHost = true;
+#else
+constexpr auto kIsBigEndianHost = false;
+#endif
+
+// Swap the bytes of numSamples consecutive 16 bit values. Swapping is its own inverse,
+// so this converts from host to network byte order and back.
+inline void swapBytes16(const uint8_t* pSrc, uint8_t* pDst, const size_t numSamples)
+{
+  auto i = size_t{0};
+
+#if defined(LINK_SIMD_SSSE3)
+  const auto shuffle =
+    _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 2 * i));
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(pDst + 2 * i), _mm_shuffle_epi8(x, shuffle));
+  }
+#elif defined(LINK_SIMD_SSE2)
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 2 * i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 2 * i),
+                     _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8)));
+  }
+#elif defined(LINK_SIMD_NEON)
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    vst1q_u8(pDst + 2 * i, vrev16q_u8(vld1q_u8(pSrc + 2 * i)));
+  }
+#endif
+
+  for (; i < numSamples; ++i)
+  {
+    const auto first = pSrc[2 * i];
+    pDst[2 * i] = pSrc[2 * i + 1];
+    pDst[2 * i + 1] = first;
+  }
+}
+
+// Write numSamples samples to a byte stream in network byte order
+template <typename SampleFormat>
+uint8_t* samplesToNetworkByteStream(const SampleFormat* pSamples,
+                                    const size_t numSamples,
+                                    uint8_t* pOut)
+{
+  if constexpr (std::is_same<SampleFormat, int16_t>::value)
+  {
+    if constexpr (kIsBigEndianHost)
+    {
+      std::memcpy(pOut, pSamples, numSamples * sizeof(SampleFormat));
+    }
+    else
+    {
+      swapBytes16(reinterpret_cast<const uint8_t*>(pSamples), pOut, numSamples);
+    }
+    return pOut + numSamples * sizeof(SampleFormat);
+  }
+  else
+  {
+    for (auto sample = size_t{0}; sample < numSamples; ++sample)
+    {
+      pOut = discovery::toNetworkByteStream(pSamples[sample], pOut);
+    }
+    return pOut;
+  }
+}
+
+// Read numSamples samples in network byte order from a byte stream
+template <typename SampleFormat>
+void samplesFromNetworkByteStream(const uint8_t* pIn,
+                                  const size_t numSamples,
+                                  SampleFormat* pSamples)
+{
+  if constexpr (std::is_same<SampleFormat, int16_t>::value)
+  {
+    if constexpr (kIsBigEndianHost)
+    {
+      std::memcpy(pSamples, pIn, numSamples * sizeof(SampleFormat));
+    }
+    else
+    {
+      swapBytes16(pIn, reinterpret_cast<uint8_t*>(pSamples), numSamples);
+    }
+  }
+  else
+  {
+    const auto pEnd = pIn + numSamples * sizeof(SampleFormat);
+    for (auto sample = size_t{0}; sample < numSamples; ++sample)
+    {
+      auto [value, next] =
+        discovery::Deserialize<SampleFormat>::fromNetworkByteStream(pIn, pEnd);
+      pSamples[sample] = value;
+      pIn = next;
+    }
+  }
+}
+
+} // namespace detail
 
 template <typename SampleFormat, typename Sender>
 struct PCMEncoder
@@ -51,15 +160,12 @@ struct PCMEncoder
     mOutputBuffer.numChannels = numChannels;
     mOutputBuffer.sessionId = sessionId;
 
-    auto it = mOutputBuffer.bytes.begin();
     const auto numSamples = mOutputBuffer.numFrames() * mOutputBuffer.numChannels;
     assert(numSamples * sizeof(int16_t) <= AudioBuffer::kMaxAudioBytes);
-    for (auto sample = 0u; sample < numSamples; ++sample)
-    {
-      it = discovery::toNetworkByteStream(samples[sample], it);
-    }
+    const auto end =
+      detail::samplesToNetworkByteStream(samples, numSamples, mOutputBuffer.bytes.data());
     mOutputBuffer.numBytes =
-      static_cast<uint32_t>(std::distance(mOutputBuffer.bytes.begin(), it));
+      static_cast<uint32_t>(std::distance(mOutputBuffer.bytes.data(), end));
 
     (*mSender)(mOutputBuffer);
   }
@@ -79,18 +185,16 @@ struct PCMDecoder
 
   void operator()(const AudioBuffer& input)
   {
-    auto it = input.bytes.begin();
-    auto numSamples = 0u;
-    auto inputEnd = input.bytes.begin() + input.numBytes;
-    while (it != inputEnd)
+    if (input.numBytes % sizeof(SampleFormat) != 0)
     {
-      auto [sample, next] =
-        discovery::Deserialize<SampleFormat>::fromNetworkByteStream(it, inputEnd);
-      mBuffer.mSamples[numSamples] = sample;
-      ++numSamples;
-      it = next;
+      throw std::range_error("Parsing type from byte stream failed");
     }
 
+    const auto numSamples = input.numBytes / sizeof(SampleFormat);
+    assert(numSamples <= mBuffer.mSamples.size());
+    detail::samplesFromNetworkByteStream(
+      input.bytes.data(), numSamples, mBuffer.mSamples.data());
+
     auto pSamples = mBuffer.mSamples.data();
 
     for (const auto& [count, numFrames, beginBeats, tempo] : input.chunks)
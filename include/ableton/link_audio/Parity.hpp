@@ -0,0 +1,294 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/discovery/NetworkByteStreamSerializable.hpp>
+#include <ableton/link_audio/AudioBuffer.hpp>
+#include <ableton/link_audio/Id.hpp>
+#include <ableton/link_audio/v1/Messages.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+// XOR parity of a group of consecutive audio buffers of a channel. A receiver that
+// misses a single buffer of the group can rebuild it from the others and the parity.
+// Buffers are identified by the count of their first chunk.
+struct AudioParity
+{
+  static constexpr uint32_t kMaxGroupSize = 16;
+
+  using Counts = std::vector<uint64_t>;
+  using Bytes = std::array<uint8_t, v1::kMaxPayloadSize>;
+
+  // Serialized size of the parity of a group without its parity bytes
+  static uint32_t overhead(const uint32_t groupSize)
+  {
+    return discovery::sizeInByteStream(Id{})
+           + discovery::sizeInByteStream(Counts(groupSize))
+           + discovery::sizeInByteStream(uint16_t{})
+           + discovery::sizeInByteStream(uint16_t{});
+  }
+
+  // Model the NetworkByteStreamSerializable concept
+  friend std::uint32_t sizeInByteStream(const AudioParity& parity)
+  {
+    return discovery::sizeInByteStream(parity.channelId)
+           + discovery::sizeInByteStream(parity.counts)
+           + discovery::sizeInByteStream(parity.sizeParity)
+           + discovery::sizeInByteStream(parity.numBytes)
+           + static_cast<uint32_t>(parity.numBytes);
+  }
+
+  template <typename It>
+  friend It toNetworkByteStream(const AudioParity& parity, It out)
+  {
+    out = discovery::toNetworkByteStream(
+      parity.numBytes,
+      discovery::toNetworkByteStream(
+        parity.sizeParity,
+        discovery::toNetworkByteStream(
+          parity.counts, discovery::toNetworkByteStream(parity.channelId, out))));
+    return std::copy_n(parity.bytes.begin(), parity.numBytes, out);
+  }
+
+  template <typename It>
+  static It fromNetworkByteStream(AudioParity& parity, It begin, It end)
+  {
+    using namespace std;
+
+    auto [channelId, channelIdEnd] =
+      discovery::Deserialize<Id>::fromNetworkByteStream(begin, end);
+    parity.channelId = channelId;
+
+    auto [counts, countsEnd] =
+      discovery::Deserialize<Counts>::fromNetworkByteStream(channelIdEnd, end);
+    parity.counts = counts;
+
+    if (counts.size() < 2 || counts.size() > kMaxGroupSize)
+    {
+      throw range_error("Invalid parity group size.");
+    }
+
+    auto [sizeParity, sizeParityEnd] =
+      discovery::Deserialize<uint16_t>::fromNetworkByteStream(countsEnd, end);
+    parity.sizeParity = sizeParity;
+
+    auto [numBytes, numBytesEnd] =
+      discovery::Deserialize<uint16_t>::fromNetworkByteStream(sizeParityEnd, end);
+    parity.numBytes = numBytes;
+
+    if (numBytes > parity.bytes.size() || std::distance(numBytesEnd, end) < numBytes)
+    {
+      throw range_error("Invalid byte count.");
+    }
+
+    std::copy_n(numBytesEnd, numBytes, parity.bytes.begin());
+
+    return numBytesEnd + numBytes;
+  }
+
+  Id channelId;
+  Counts counts;
+  uint16_t sizeParity = 0; // XOR of the sizes of the serialized buffers
+  uint16_t numBytes = 0;   // Size of the largest serialized buffer
+  Bytes bytes;
+};
+
+// Accumulates the parity of the serialized audio buffers of one channel. Groups restart
+// when the group size changes.
+class ParityEncoder
+{
+public:
+  // A group size of zero disables parity
+  void setGroupSize(uint32_t groupSize)
+  {
+    groupSize = std::min(groupSize, AudioParity::kMaxGroupSize);
+    if (groupSize != mGroupSize)
+    {
+      mGroupSize = groupSize < 2 ? 0 : groupSize;
+      reset();
+    }
+  }
+
+  uint32_t groupSize() const { return mGroupSize; }
+
+  // Add a serialized audio buffer. Returns true if it completes a group, in which case
+  // parity() holds the parity of the group until the next call.
+  bool add(const AudioBuffer& buffer, const uint8_t* pBytes, const size_t numBytes)
+  {
+    if (mGroupSize == 0)
+    {
+      return false;
+    }
+
+    if (mParity.counts.size() == mGroupSize)
+    {
+      reset();
+    }
+
+    mParity.channelId = buffer.channelId;
+    mParity.counts.push_back(buffer.chunks.front().count);
+    mParity.sizeParity ^= static_cast<uint16_t>(numBytes);
+    for (auto i = size_t{0}; i < numBytes; ++i)
+    {
+      mParity.bytes[i] ^= pBytes[i];
+    }
+    mParity.numBytes = std::max(mParity.numBytes, static_cast<uint16_t>(numBytes));
+
+    return mParity.counts.size() == mGroupSize;
+  }
+
+  const AudioParity& parity() const { return mParity; }
+
+private:
+  void reset()
+  {
+    mParity.counts.clear();
+    mParity.counts.reserve(AudioParity::kMaxGroupSize);
+    mParity.sizeParity = 0;
+    mParity.numBytes = 0;
+    mParity.bytes.fill(0);
+  }
+
+  uint32_t mGroupSize = 0;
+  AudioParity mParity;
+};
+
+// Remembers the recently received audio buffers of a channel to rebuild a lost one from
+// parity. Buffers are only remembered once parity has been received for the stream, so
+// streams without parity aren't copied. Duplicates, e.g. a late buffer that was rebuilt
+// before, are left to the sequencer, which drops them by their count.
+class ParityDecoder
+{
+public:
+  static constexpr size_t kHistorySize = 2 * AudioParity::kMaxGroupSize;
+
+  // Forget all buffers and parity, e.g. when the counts of the channel start over
+  void reset()
+  {
+    mNext = 0;
+    mSize = 0;
+    mGroupSize = 0;
+  }
+
+  // The size of the last parity group received, or zero if the stream carries no parity
+  uint32_t groupSize() const { return mGroupSize; }
+
+  void receive(const AudioBufferView& buffer)
+  {
+    if (mGroupSize > 0)
+    {
+      mHistory[mNext].assign(buffer);
+      mNext = (mNext + 1) % kHistorySize;
+      mSize = std::min(mSize + 1, kHistorySize);
+    }
+  }
+
+  // Returns the rebuilt buffer if exactly one buffer of the group is missing. Throws
+  // std::runtime_error if the rebuilt bytes don't form a valid audio buffer.
+  const AudioBuffer* recover(const AudioParity& parity)
+  {
+    mGroupSize = static_cast<uint32_t>(parity.counts.size());
+
+    auto oMissing = std::optional<uint64_t>{};
+    for (const auto count : parity.counts)
+    {
+      if (!contains(count))
+      {
+        if (oMissing)
+        {
+          return nullptr;
+        }
+        oMissing = count;
+      }
+    }
+
+    if (!oMissing)
+    {
+      return nullptr;
+    }
+
+    auto bytes = parity.bytes;
+    auto size = parity.sizeParity;
+    for (const auto count : parity.counts)
+    {
+      if (count != *oMissing)
+      {
+        const auto& buffer = *find(count);
+        const auto end = toNetworkByteStream(buffer, mScratch.begin());
+        const auto numBytes = static_cast<size_t>(std::distance(mScratch.begin(), end));
+        size ^= static_cast<uint16_t>(numBytes);
+        for (auto i = size_t{0}; i < numBytes; ++i)
+        {
+          bytes[i] ^= mScratch[i];
+        }
+      }
+    }
+
+    if (size > parity.numBytes)
+    {
+      throw std::range_error("Invalid parity.");
+    }
+
+    auto recovered = AudioBufferView{};
+    AudioBufferView::fromNetworkByteStream(
+      recovered, bytes.begin(), bytes.begin() + size);
+    if (recovered.channelId != parity.channelId
+        || recovered.chunks.front().count != *oMissing)
+    {
+      throw std::runtime_error("Invalid parity.");
+    }
+
+    receive(recovered);
+    return find(*oMissing);
+  }
+
+private:
+  AudioBuffer* find(const uint64_t count)
+  {
+    for (auto i = size_t{0}; i < mSize; ++i)
+    {
+      if (mHistory[i].chunks.front().count == count)
+      {
+        return &mHistory[i];
+      }
+    }
+    return nullptr;
+  }
+
+  bool contains(const uint64_t count) { return find(count) != nullptr; }
+
+  std::array<AudioBuffer, kHistorySize> mHistory;
+  std::array<uint8_t, v1::kMaxPayloadSize> mScratch;
+  size_t mNext = 0;
+  size_t mSize = 0;
+  uint32_t mGroupSize = 0;
+};
+
+} // namespace link_audio
+} // namespace ableton
@@ -24,6 +24,7 @@
 #include <ableton/link/SessionId.hpp>
 #include <ableton/link_audio/ChannelAnnouncements.hpp>
 #include <ableton/link_audio/PeerInfo.hpp>
+#include <algorithm>
 
 namespace ableton
 {
@@ -34,8 +35,10 @@ struct PeerAnnouncement
 {
   using IdType = link::NodeId;
 
-  using Payload = decltype(discovery::makePayload(
-    link::SessionMembership{}, PeerInfo{}, ChannelAnnouncements{}));
+  using Payload = decltype(discovery::makePayload(link::SessionMembership{},
+                                                  PeerInfo{},
+                                                  ChannelAnnouncements{},
+                                                  ChannelMulticastGroups{}));
 
   link::NodeId ident() const { return nodeId; }
 
@@ -47,9 +50,18 @@ struct PeerAnnouncement
 
   friend Payload toPayload(const PeerAnnouncement& announcement)
   {
+    auto groups = ChannelMulticastGroups{};
+    for (const auto& channel : announcement.channels.channels)
+    {
+      if (channel.multicastGroup)
+      {
+        groups.groups.push_back({channel.id, *channel.multicastGroup});
+      }
+    }
     return discovery::makePayload(link::SessionMembership{announcement.sessionId},
                                   announcement.peerInfo,
-                                  announcement.channels);
+                                  announcement.channels,
+                                  std::move(groups));
   }
 
   template <typename It>
@@ -57,14 +69,31 @@ struct PeerAnnouncement
   {
     using namespace std;
     auto announcement = PeerAnnouncement{std::move(nodeId), {}, {}};
-    discovery::parsePayload<link::SessionMembership, PeerInfo, ChannelAnnouncements>(
+    auto groups = ChannelMulticastGroups{};
+    discovery::parsePayload<link::SessionMembership,
+                            PeerInfo,
+                            ChannelAnnouncements,
+                            ChannelMulticastGroups>(
       std::move(begin),
       std::move(end),
       [&announcement](link::SessionMembership membership)
       { announcement.sessionId = std::move(membership.sessionId); },
       [&announcement](PeerInfo pi) { announcement.peerInfo = std::move(pi); },
       [&announcement](ChannelAnnouncements chs)
-      { announcement.channels = std::move(chs); });
+      { announcement.channels = std::move(chs); },
+      [&groups](ChannelMulticastGroups gs) { groups = std::move(gs); });
+
+    for (auto& channel : announcement.channels.channels)
+    {
+      const auto it =
+        std::find_if(groups.groups.begin(),
+                     groups.groups.end(),
+                     [&](const auto& group) { return group.id == channel.id; });
+      if (it != groups.groups.end())
+      {
+        channel.multicastGroup = it->group;
+      }
+    }
     return announcement;
   }
 
@@ -0,0 +1,350 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/link/Beats.hpp>
+#include <ableton/link/Tempo.hpp>
+#include <ableton/link_audio/Buffer.hpp>
+#include <ableton/link_audio/Id.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+// Lock-free buffer between the thread that receives audio and a single thread that
+// plays it out. Received chunks are stored with their beat time, so the reader can ask
+// for the audio of any beat range. Reading is wait-free and doesn't allocate.
+struct PlayoutBuffer
+{
+  static constexpr auto kNumSamples = size_t{1} << 18;
+  static constexpr auto kNumSegments = size_t{1} << 10;
+  // Reading faster or slower than this means the beat time jumped
+  static constexpr auto kMaxRateRatio = 4.;
+
+  PlayoutBuffer()
+    : mSamples(kNumSamples)
+  {
+  }
+
+  // Where read() renders to: numChannels channels, either interleaved in pInterleaved
+  // or with one buffer per channel in ppPlanar. pChannels optionally selects the
+  // received channel of every output channel, otherwise they are taken in order.
+  struct Output
+  {
+    float& at(const size_t frame, const size_t channel) const
+    {
+      return ppPlanar ? ppPlanar[channel][frame]
+                      : pInterleaved[frame * numChannels + channel];
+    }
+
+    size_t sourceChannel(const size_t channel) const
+    {
+      return pChannels ? pChannels[channel] : channel;
+    }
+
+    void clear(const size_t numFrames) const
+    {
+      for (auto channel = size_t{0}; ppPlanar && channel < numChannels; ++channel)
+      {
+        std::fill_n(ppPlanar[channel], numFrames, 0.f);
+      }
+      if (!ppPlanar)
+      {
+        std::fill_n(pInterleaved, numFrames * numChannels, 0.f);
+      }
+    }
+
+    size_t numChannels = 0;
+    float* pInterleaved = nullptr;
+    float* const* ppPlanar = nullptr;
+    const size_t* pChannels = nullptr;
+  };
+
+  PlayoutBuffer(const PlayoutBuffer&) = delete;
+  PlayoutBuffer& operator=(const PlayoutBuffer&) = delete;
+
+  // Latency is given either in beats or in time, the other one is reset
+  void setLatency(const link::Beats beats)
+  {
+    mLatencyMicroBeats = beats.microBeats();
+    mLatencyMicros = 0;
+  }
+
+  void setLatency(const std::chrono::microseconds time)
+  {
+    mLatencyMicros = time.count();
+    mLatencyMicroBeats = 0;
+  }
+
+  link::Beats latency(const link::Tempo tempo) const
+  {
+    return link::Beats{mLatencyMicroBeats.load()}
+           + tempo.microsToBeats(std::chrono::microseconds{mLatencyMicros.load()});
+  }
+
+  // The time that is buffered ahead of the last read
+  std::chrono::microseconds bufferedTime() const
+  {
+    return std::chrono::microseconds{mBufferedMicros.load()};
+  }
+
+  // The highest buffered time seen by the reader
+  std::chrono::microseconds maxBufferedTime() const
+  {
+    return std::chrono::microseconds{mMaxBufferedMicros.load()};
+  }
+
+  // Called by the writer. Chunks that don't fit are dropped.
+  bool write(const BufferCallbackHandle<Buffer<int16_t>> handle)
+  {
+    const auto& buffer = handle.mBuffer;
+    const auto numSamples = size_t{buffer.mNumFrames} * buffer.mNumChannels;
+    const auto written = mNumWritten.load(std::memory_order_relaxed);
+    const auto consumed = mNumConsumed.load(std::memory_order_acquire);
+    const auto oldestSample =
+      consumed == written ? mSampleEnd : segment(consumed).sampleBegin;
+    if (numSamples == 0 || buffer.mSampleRate == 0 || buffer.mTempo.bpm() <= 0.
+        || written - consumed == kNumSegments
+        || mSampleEnd - oldestSample + numSamples > kNumSamples)
+    {
+      return false;
+    }
+
+    const auto offset = mSampleEnd & (kNumSamples - 1);
+    const auto numFirst = std::min(numSamples, kNumSamples - offset);
+    std::copy_n(handle.mpSamples, numFirst, mSamples.begin() + offset);
+    std::copy_n(handle.mpSamples + numFirst, numSamples - numFirst, mSamples.begin());
+
+    mSegments[written & (kNumSegments - 1)] = Segment{mSampleEnd,
+                                                       buffer.mNumFrames,
+                                                       buffer.mNumChannels,
+                                                       buffer.mSampleRate,
+                                                       buffer.mBeginBeats,
+                                                       buffer.mTempo,
+                                                       buffer.mSessionId};
+    mSampleEnd += numSamples;
+    mNumWritten.store(written + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Called by the reader. Renders the audio of the session beat range from begin to end
+  // to numFrames frames, resampling as needed. Output channels past the last received
+  // channel repeat it, so mono audio is copied to all of them. Writes silence and
+  // returns false if the range isn't buffered.
+  bool read(const Id& sessionId,
+            const link::Beats begin,
+            const link::Beats end,
+            const size_t numFrames,
+            const Output& output)
+  {
+    const auto written = mNumWritten.load(std::memory_order_acquire);
+    const auto isRendered = render(sessionId, begin, end, numFrames, output);
+    if (!isRendered)
+    {
+      mReadPos = std::nullopt;
+      output.clear(numFrames);
+    }
+
+    auto buffered = std::chrono::microseconds{0};
+    for (auto i = mFront; i < written; ++i)
+    {
+      buffered += segment(i).duration();
+    }
+    if (mReadPos)
+    {
+      buffered -= std::chrono::microseconds{
+        std::llround(*mReadPos * 1e6 / segment(mFront).sampleRate)};
+    }
+    mBufferedMicros = buffered.count();
+    if (buffered.count() > mMaxBufferedMicros.load(std::memory_order_relaxed))
+    {
+      mMaxBufferedMicros = buffered.count();
+    }
+
+    mNumConsumed.store(mFront, std::memory_order_release);
+    return isRendered;
+  }
+
+  // Renders to numChannels interleaved channels
+  bool read(const Id& sessionId,
+            const link::Beats begin,
+            const link::Beats end,
+            const size_t numFrames,
+            const size_t numChannels,
+            float* pOut)
+  {
+    return read(sessionId, begin, end, numFrames, Output{numChannels, pOut});
+  }
+
+private:
+  struct Segment
+  {
+    uint64_t sampleBegin;
+    uint32_t numFrames;
+    uint32_t numChannels;
+    uint32_t sampleRate;
+    link::Beats beginBeats;
+    link::Tempo tempo;
+    Id sessionId;
+
+    double framesPerBeat() const { return 60. * sampleRate / tempo.bpm(); }
+
+    link::Beats endBeats() const
+    {
+      return beginBeats + link::Beats{numFrames / framesPerBeat()};
+    }
+
+    std::chrono::microseconds duration() const
+    {
+      return std::chrono::microseconds{std::llround(numFrames * 1e6 / sampleRate)};
+    }
+  };
+
+  const Segment& segment(const uint64_t i) const
+  {
+    return mSegments[i & (kNumSegments - 1)];
+  }
+
+  float sample(const Segment& segment, const size_t frame, const size_t channel) const
+  {
+    const auto index = segment.sampleBegin + frame * segment.numChannels
+                       + std::min(channel, size_t{segment.numChannels} - 1);
+    return static_cast<float>(mSamples[index & (kNumSamples - 1)]) / 32768.f;
+  }
+
+  bool render(const Id& sessionId,
+              const link::Beats begin,
+              const link::Beats end,
+              const size_t numFrames,
+              const Output& output)
+  {
+    const auto written = mNumWritten.load(std::memory_order_acquire);
+
+    // Start at the chunk that holds the begin of the range
+    if (!mReadPos)
+    {
+      while (mFront < written
+             && (segment(mFront).sessionId != sessionId
+                 || !(begin < segment(mFront).endBeats())))
+      {
+        ++mFront;
+      }
+      if (mFront == written || segment(mFront).beginBeats > begin)
+      {
+        return false;
+      }
+      const auto& front = segment(mFront);
+      mReadPos = (begin - front.beginBeats).floating() * front.framesPerBeat();
+    }
+
+    // Find the position of the end of the range relative to the read position
+    auto numSourceFrames = -*mReadPos;
+    auto isEndBuffered = false;
+    for (auto i = mFront; i < written && segment(i).sessionId == sessionId; ++i)
+    {
+      const auto& s = segment(i);
+      if (!(s.endBeats() < end))
+      {
+        numSourceFrames +=
+          std::max(0., (end - s.beginBeats).floating() * s.framesPerBeat());
+        isEndBuffered = true;
+        break;
+      }
+      numSourceFrames += s.numFrames;
+    }
+
+    const auto numNominalFrames =
+      (end - begin).floating() * segment(mFront).framesPerBeat();
+    if (!isEndBuffered || numFrames == 0 || numSourceFrames <= 0.
+        || numSourceFrames > kMaxRateRatio * numNominalFrames
+        || numSourceFrames * kMaxRateRatio < numNominalFrames)
+    {
+      return false;
+    }
+
+    const auto increment = numSourceFrames / static_cast<double>(numFrames);
+
+    // Interpolate linearly between the frames around each read position. The frame after
+    // the last buffered one is approximated by the last one.
+    auto current = mFront;
+    auto currentBegin = 0.;
+    for (auto frame = size_t{0}; frame < numFrames; ++frame)
+    {
+      const auto pos = *mReadPos + static_cast<double>(frame) * increment;
+      while (current + 1 < written && pos - currentBegin >= segment(current).numFrames)
+      {
+        currentBegin += segment(current).numFrames;
+        ++current;
+      }
+
+      const auto& s = segment(current);
+      const auto index =
+        std::min(static_cast<size_t>(pos - currentBegin), size_t{s.numFrames} - 1);
+      const auto t = static_cast<float>(pos - currentBegin - static_cast<double>(index));
+      const auto hasNext = index + 1 < s.numFrames;
+      const auto pNext = hasNext || current + 1 == written ? &s : &segment(current + 1);
+      const auto nextIndex = hasNext ? index + 1 : (pNext == &s ? index : 0);
+
+      for (auto channel = size_t{0}; channel < output.numChannels; ++channel)
+      {
+        const auto sourceChannel = output.sourceChannel(channel);
+        const auto a = sample(s, index, sourceChannel);
+        const auto b = sample(*pNext, nextIndex, sourceChannel);
+        output.at(frame, channel) = a + t * (b - a);
+      }
+    }
+
+    // Release the chunks that were read completely
+    *mReadPos += static_cast<double>(numFrames) * increment;
+    while (mFront + 1 < written && *mReadPos >= segment(mFront).numFrames)
+    {
+      *mReadPos -= segment(mFront).numFrames;
+      ++mFront;
+    }
+    return true;
+  }
+
+  std::vector<int16_t> mSamples;
+  std::array<Segment, kNumSegments> mSegments{};
+  std::atomic<int64_t> mLatencyMicroBeats{0};
+  std::atomic<int64_t> mLatencyMicros{0};
+  std::atomic<int64_t> mBufferedMicros{0};
+  std::atomic<int64_t> mMaxBufferedMicros{0};
+
+  // Written by the writer
+  alignas(64) std::atomic<uint64_t> mNumWritten{0};
+  uint64_t mSampleEnd = 0;
+
+  // Written by the reader
+  alignas(64) std::atomic<uint64_t> mNumConsumed{0};
+  uint64_t mFront = 0;
+  std::optional<double> mReadPos;
+};
+
+} // namespace link_audio
+} // namespace ableton
@@ -28,6 +28,10 @@ namespace ableton
 namespace link_audio
 {
 
+// Single producer, single consumer ring of slots. The writer and the reader each own
+// a pair of monotonically increasing indices on a separate cache line and keep a copy
+// of the other side's begin index, which is only reloaded when the ring looks full
+// or empty. Releasing a slot publishes its contents to the other side.
 template <typename T>
 struct Queue
 {
@@ -47,32 +51,32 @@ public:
 
     bool retainSlot()
     {
-      return mpQueue->retainSlot(mpQueue->mWriterEnd, mpQueue->mReaderBegin);
+      auto& side = mpQueue->mWriter;
+      const auto end = side.end.load(std::memory_order_relaxed);
+      if (end - side.otherBegin >= mpQueue->mNumSlots)
+      {
+        side.otherBegin = mpQueue->mReader.begin.load(std::memory_order_acquire);
+        if (end - side.otherBegin >= mpQueue->mNumSlots)
+        {
+          return false;
+        }
+      }
+      side.end.store(end + 1, std::memory_order_relaxed);
+      return true;
     }
 
-    void releaseSlot()
-    {
-      mpQueue->releaseSlot(mpQueue->mWriterBegin, mpQueue->mWriterEnd);
-    }
+    void releaseSlot() { mpQueue->releaseSlot(mpQueue->mWriter); }
 
     size_t numRetainedSlots() const
     {
-      return mpQueue->numRetainedSlots(mpQueue->mWriterBegin, mpQueue->mWriterEnd);
+      return mpQueue->numRetainedSlots(mpQueue->mWriter);
     }
 
     size_t numQueuedSlots() const { return mpQueue->numQueuedSlots(); }
 
-    T* operator[](size_t i) const
-    {
-      if (i < numRetainedSlots())
-      {
-        i += mpQueue->mWriterBegin.load();
-        return mpQueue->mData[i % mpQueue->mData.size()].get();
-      }
-      return nullptr;
-    }
+    T* operator[](const size_t i) const { return mpQueue->slot(mpQueue->mWriter, i); }
 
-    size_t numSlots() const { return mpQueue->numSlots(); }
+    size_t numSlots() const { return mpQueue->mNumSlots; }
 
   private:
     friend Queue;
@@ -95,32 +99,32 @@ public:
 
     bool retainSlot()
     {
-      return mpQueue->retainSlot(mpQueue->mReaderEnd, mpQueue->mWriterBegin);
+      auto& side = mpQueue->mReader;
+      const auto end = side.end.load(std::memory_order_relaxed);
+      if (end == side.otherBegin)
+      {
+        side.otherBegin = mpQueue->mWriter.begin.load(std::memory_order_acquire);
+        if (end == side.otherBegin)
+        {
+          return false;
+        }
+      }
+      side.end.store(end + 1, std::memory_order_relaxed);
+      return true;
     }
 
-    void releaseSlot()
-    {
-      mpQueue->releaseSlot(mpQueue->mReaderBegin, mpQueue->mReaderEnd);
-    }
+    void releaseSlot() { mpQueue->releaseSlot(mpQueue->mReader); }
 
     size_t numRetainedSlots() const
     {
-      return mpQueue->numRetainedSlots(mpQueue->mReaderBegin, mpQueue->mReaderEnd);
+      return mpQueue->numRetainedSlots(mpQueue->mReader);
     }
 
     size_t numQueuedSlots() const { return mpQueue->numQueuedSlots(); }
 
-    T* operator[](size_t i) const
-    {
-      if (i < numRetainedSlots())
-      {
-        i += mpQueue->mReaderBegin.load() + 1;
-        return mpQueue->mData[i % mpQueue->mData.size()].get();
-      }
-      return nullptr;
-    }
+    T* operator[](const size_t i) const { return mpQueue->slot(mpQueue->mReader, i); }
 
-    size_t numSlots() const { return mpQueue->numSlots(); }
+    size_t numSlots() const { return mpQueue->mNumSlots; }
 
   private:
     friend Queue;
@@ -142,72 +146,86 @@ public:
 
   Reader reader() const { return {mpImpl}; }
 
+  // Visit all slots, e.g. to point them to new memory. Only safe while neither the
+  // writer nor the reader retain any. The ring may hold more slots than can be
+  // retained at once.
+  template <typename Function>
+  void forEachSlot(Function function)
+  {
+    for (auto& slot : mpImpl->mData)
+    {
+      function(slot);
+    }
+  }
+
 private:
   struct Impl
   {
-    Impl(size_t numRetainedSlots, const T& t)
-      : mData(numRetainedSlots + 2)
-      , mWriterBegin(1)
-      , mWriterEnd(1)
-      , mReaderBegin(0)
-      , mReaderEnd(0)
+    // Indices of one side. Only its owner writes them, and only the owner touches
+    // otherBegin, so the other side reads a single line per reload.
+    struct alignas(64) Side
+    {
+      std::atomic_size_t begin{0};
+      std::atomic_size_t end{0};
+      size_t otherBegin = 0;
+    };
+
+    static size_t ringSize(const size_t numSlots)
     {
-      for (auto& slot : mData)
+      auto size = size_t{1};
+      while (size < numSlots)
       {
-        slot = std::make_unique<T>(t);
+        size <<= 1;
       }
+      return size;
     }
 
-    inline size_t nextIndex(const size_t index) const
+    Impl(size_t numRetainedSlots, const T& t)
+      : mData(ringSize(numRetainedSlots), t)
+      , mMask(mData.size() - 1)
+      , mNumSlots(numRetainedSlots)
     {
-      return (index + 1) % mData.size();
     }
 
-    inline bool retainSlot(std::atomic_size_t& aEnd, std::atomic_size_t& aOtherBegin)
+    // The writer's slots follow the ones queued for the reader, which follow the
+    // reader's own slots: reader.begin <= reader.end <= writer.begin <= writer.end
+    static void releaseSlot(Side& side)
     {
-      const auto nextEnd = nextIndex(aEnd.load());
-      const auto otherBegin = aOtherBegin.load();
-      if (nextEnd != otherBegin)
+      const auto begin = side.begin.load(std::memory_order_relaxed);
+      if (begin != side.end.load(std::memory_order_relaxed))
       {
-        aEnd.store(nextEnd);
-        return true;
+        side.begin.store(begin + 1, std::memory_order_release);
       }
-      return false;
     }
 
-    inline void releaseSlot(std::atomic_size_t& aBegin, std::atomic_size_t& aEnd)
+    static size_t numRetainedSlots(const Side& side)
     {
-      const auto begin = aBegin.load();
-      const auto end = aEnd.load();
-      if (begin != end)
-      {
-        aBegin.store(nextIndex(begin));
-      }
+      return side.end.load(std::memory_order_relaxed)
+             - side.begin.load(std::memory_order_relaxed);
     }
 
-    inline size_t numRetainedSlots(const std::atomic_size_t& aBegin,
-                                   const std::atomic_size_t& aEnd) const
+    T* slot(const Side& side, const size_t i)
     {
-      const auto begin = aBegin.load();
-      const auto end = aEnd.load();
-      return begin > end ? end + mData.size() - begin : end - begin;
+      if (i < numRetainedSlots(side))
+      {
+        return &mData[(side.begin.load(std::memory_order_relaxed) + i) & mMask];
+      }
+      return nullptr;
     }
 
-    inline size_t numQueuedSlots() const
+    size_t numQueuedSlots() const
     {
-      const auto writerBegin = mWriterBegin.load();
-      const auto readerEnd = mReaderEnd.load();
-      return writerBegin > readerEnd ? writerBegin - readerEnd - 1
-                                     : writerBegin + mData.size() - readerEnd - 1;
+      // Load the lower bound first so the difference can't underflow
+      const auto readerEnd = mReader.end.load(std::memory_order_acquire);
+      const auto writerBegin = mWriter.begin.load(std::memory_order_acquire);
+      return writerBegin - readerEnd;
     }
 
-    size_t numSlots() const { return mData.size() - 2; }
-
-    std::vector<std::unique_ptr<T>> mData;
-    std::atomic_size_t mWriterBegin;
-    std::atomic_size_t mWriterEnd;
-    std::atomic_size_t mReaderBegin;
-    std::atomic_size_t mReaderEnd;
+    Side mWriter;
+    Side mReader;
+    std::vector<T> mData; // All slots in one allocation
+    size_t mMask;
+    size_t mNumSlots;
   };
 
   std::shared_ptr<Impl> mpImpl;
@@ -19,10 +19,15 @@
 
 #pragma once
 
+#include <ableton/discovery/AsioTypes.hpp>
 #include <ableton/link_audio/ChannelRequests.hpp>
 #include <ableton/util/Injected.hpp>
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -39,6 +44,24 @@ class Receivers
   using OptionalSendHandler =
     decltype(std::declval<GetSender>().forChannel(std::declval<Id>()));
 
+  using SendHandler = typename OptionalSendHandler::value_type;
+
+  // Send handlers that expose their interface and endpoint can be batched per interface
+  template <typename T, typename = void>
+  struct IsBatchable : std::false_type
+  {
+    using SharedInterface = std::nullptr_t;
+  };
+
+  template <typename T>
+  struct IsBatchable<T,
+                     std::void_t<decltype(std::declval<const T&>().interface()),
+                                 decltype(std::declval<const T&>().endpoint())>>
+    : std::true_type
+  {
+    using SharedInterface = decltype(std::declval<const T&>().interface());
+  };
+
   struct Receiver
   {
     OptionalSendHandler sendHandler;
@@ -47,6 +70,22 @@ class Receivers
   };
 
 public:
+  struct Packet
+  {
+    const uint8_t* pData;
+    size_t numBytes;
+    // Parity packets are only sent to receivers that accept them and to the multicast
+    // group, where peers without support ignore them
+    bool isParity = false;
+  };
+
+  // The datagrams handed to the network for a call to send()
+  struct SendResult
+  {
+    size_t numPackets = 0;
+    size_t numBytes = 0;
+  };
+
   Receivers(util::Injected<IoContext> io, util::Injected<GetSender> getSender)
     : mpImpl(std::make_shared<Impl>(std::move(io), std::move(getSender)))
   {
@@ -64,11 +103,42 @@ public:
 
   void operator()(const uint8_t* const pData, const size_t numBytes)
   {
-    (*mpImpl)(pData, numBytes);
+    const auto packet = Packet{pData, numBytes};
+    (*mpImpl)(&packet, 1, Codec::kPCM_i16);
+  }
+
+  // Send several packets to all receivers that receive the given codec. Packets are
+  // sent in order.
+  SendResult send(const Packet* pPackets,
+                  const size_t numPackets,
+                  const Codec codec = Codec::kPCM_i16)
+  {
+    return (*mpImpl)(pPackets, numPackets, codec);
+  }
+
+  // Receivers that requested the channel via this group get a single copy of each
+  // packet per interface, sent to the group. Requires batchable send handlers.
+  void setMulticastGroup(std::optional<discovery::UdpEndpoint> group)
+  {
+    mpImpl->mMulticastGroup = std::move(group);
   }
 
   bool empty() const { return mpImpl->empty(); }
 
+  size_t numReceivers() const { return mpImpl->mReceivers.size(); }
+
+  // Receivers that share the datagrams sent to the multicast group
+  size_t numMulticastReceivers() const { return mpImpl->numMulticastReceivers(); }
+
+  // Receivers get the codec they prefer if it is supported and PCM otherwise. Receivers
+  // of the multicast group share a codec, which is PCM unless all of them prefer the
+  // same one.
+  bool hasReceivers(const Codec codec) const { return mpImpl->hasReceivers(codec); }
+
+  // Timing is only appended to the buffers of a codec if all of its receivers can parse
+  // it, since older receivers reject trailing bytes
+  bool acceptsTiming(const Codec codec) const { return mpImpl->acceptsTiming(codec); }
+
 private:
   struct Impl
   {
@@ -147,22 +217,186 @@ private:
       }
     }
 
-    void operator()(const uint8_t* const pData, const size_t numBytes)
+    SendResult operator()(const Packet* pPackets,
+                          const size_t numPackets,
+                          const Codec codec)
     {
-      for (auto& receiver : mReceivers)
+      if constexpr (IsBatchable<SendHandler>::value)
+      {
+        return sendBatched(pPackets, numPackets, codec);
+      }
+      else
+      {
+        auto result = SendResult{};
+        for (auto& receiver : mReceivers)
+        {
+          auto& sendHandler = receiver.sendHandler;
+          if (sendHandler && codecFor(receiver) == codec)
+          {
+            for (auto i = size_t{0}; i < numPackets; ++i)
+            {
+              if (!pPackets[i].isParity || receiver.request.acceptsParity)
+              {
+                (*sendHandler)(pPackets[i].pData, pPackets[i].numBytes);
+                ++result.numPackets;
+                result.numBytes += pPackets[i].numBytes;
+              }
+            }
+          }
+        }
+        return result;
+      }
+    }
+
+    // Hand all packets for all receivers reachable via the same interface to that
+    // interface at once, so it can send them with a minimum of system calls. Receivers
+    // of the multicast group share one datagram per packet.
+    SendResult sendBatched(const Packet* pPackets,
+                           const size_t numPackets,
+                           const Codec codec)
+    {
+      auto result = SendResult{};
+      // Resolve each receiver's interface once, indexed like mReceivers. Receivers that
+      // don't get this codec are left without an interface.
+      mInterfaces.clear();
+      mReceiverInterfaces.clear();
+      for (const auto& receiver : mReceivers)
+      {
+        auto pInterface = receiver.sendHandler && codecFor(receiver) == codec
+                            ? receiver.sendHandler->interface()
+                            : SharedInterface{};
+        if (pInterface
+            && std::find(mInterfaces.begin(), mInterfaces.end(), pInterface)
+                 == mInterfaces.end())
+        {
+          mInterfaces.push_back(pInterface);
+        }
+        mReceiverInterfaces.push_back(std::move(pInterface));
+      }
+
+      for (const auto& pInterface : mInterfaces)
       {
-        if (auto& sendHandler = receiver.sendHandler)
+        auto hasMulticastReceivers = false;
+        for (auto r = size_t{0}; r < mReceivers.size(); ++r)
+        {
+          if (mReceiverInterfaces[r] == pInterface && isMulticast(mReceivers[r]))
+          {
+            hasMulticastReceivers = true;
+            break;
+          }
+        }
+
+        mDatagrams.clear();
+        for (auto i = size_t{0}; i < numPackets; ++i)
+        {
+          const auto& packet = pPackets[i];
+          if (hasMulticastReceivers)
+          {
+            mDatagrams.push_back(
+              discovery::UdpDatagram{packet.pData, packet.numBytes, *mMulticastGroup});
+          }
+          for (auto r = size_t{0}; r < mReceivers.size(); ++r)
+          {
+            const auto& receiver = mReceivers[r];
+            if (mReceiverInterfaces[r] == pInterface && !isMulticast(receiver)
+                && (!packet.isParity || receiver.request.acceptsParity))
+            {
+              mDatagrams.push_back(discovery::UdpDatagram{
+                packet.pData, packet.numBytes, receiver.sendHandler->endpoint()});
+            }
+          }
+        }
+
+        try
+        {
+          pInterface->send(mDatagrams.data(), mDatagrams.size());
+          result.numPackets += mDatagrams.size();
+          for (const auto& datagram : mDatagrams)
+          {
+            result.numBytes += datagram.numBytes;
+          }
+        }
+        catch (const std::runtime_error&)
         {
-          (*sendHandler)(pData, numBytes);
         }
       }
+      mInterfaces.clear();
+      mReceiverInterfaces.clear();
+      return result;
+    }
+
+    bool isMulticast(const Receiver& receiver) const
+    {
+      return mMulticastGroup && receiver.request.multicastGroup == mMulticastGroup;
     }
 
     bool empty() const { return mReceivers.empty(); }
 
+    size_t numMulticastReceivers() const
+    {
+      return static_cast<size_t>(
+        std::count_if(mReceivers.begin(),
+                      mReceivers.end(),
+                      [&](const auto& receiver) { return isMulticast(receiver); }));
+    }
+
+    bool hasReceivers(const Codec codec) const
+    {
+      return std::any_of(mReceivers.begin(),
+                         mReceivers.end(),
+                         [&](const auto& receiver)
+                         { return codecFor(receiver) == codec; });
+    }
+
+    bool acceptsTiming(const Codec codec) const
+    {
+      return hasReceivers(codec)
+             && std::all_of(mReceivers.begin(),
+                            mReceivers.end(),
+                            [&](const auto& receiver)
+                            {
+                              return codecFor(receiver) != codec
+                                     || receiver.request.acceptsTiming;
+                            });
+    }
+
+    static Codec preferredCodec(const Receiver& receiver)
+    {
+      switch (receiver.request.codec)
+      {
+      case Codec::kLPC_i16:
+      case Codec::kADPCM_i4:
+        return receiver.request.codec;
+      default:
+        return Codec::kPCM_i16;
+      }
+    }
+
+    Codec codecFor(const Receiver& receiver) const
+    {
+      if (!isMulticast(receiver))
+      {
+        return preferredCodec(receiver);
+      }
+
+      const auto codec = preferredCodec(receiver);
+      const auto isShared =
+        std::all_of(mReceivers.begin(),
+                    mReceivers.end(),
+                    [&](const auto& other)
+                    { return !isMulticast(other) || preferredCodec(other) == codec; });
+      return isShared ? codec : Codec::kPCM_i16;
+    }
+
+    using SharedInterface = typename IsBatchable<SendHandler>::SharedInterface;
+
     Timer mPruneTimer;
     util::Injected<GetSender> mGetSender;
     std::vector<Receiver> mReceivers; // Invariant: sorted by time_point
+    std::vector<SharedInterface> mInterfaces;
+    std::vector<SharedInterface> mReceiverInterfaces; // Parallel to mReceivers
+    std::vector<discovery::UdpDatagram> mDatagrams;
+    std::optional<discovery::UdpEndpoint> mMulticastGroup;
   };
 
   std::shared_ptr<Impl> mpImpl;
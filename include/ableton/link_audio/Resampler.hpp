@@ -0,0 +1,371 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/util/Simd.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+enum class ResamplerQuality
+{
+  kLow,
+  kMedium,
+  kHigh,
+};
+
+namespace detail
+{
+
+// M_PI isn't standard C++
+constexpr double kPi = 3.14159265358979323846;
+
+struct ResamplerConfig
+{
+  size_t numTaps;   // Taps on each side of the interpolated position
+  size_t numPhases; // Filters per input frame, interpolated linearly
+  double beta;      // Kaiser window shape
+  double passband;  // Cutoff relative to the lower Nyquist frequency
+};
+
+inline ResamplerConfig resamplerConfig(const ResamplerQuality quality)
+{
+  switch (quality)
+  {
+  case ResamplerQuality::kLow:
+    return {8, 128, 6., 0.85};
+  case ResamplerQuality::kHigh:
+    return {32, 512, 10., 0.95};
+  default:
+    return {16, 256, 8., 0.9};
+  }
+}
+
+inline double besselI0(const double x)
+{
+  auto sum = 1.;
+  auto term = 1.;
+  for (auto k = 1; term > 1e-12 * sum; ++k)
+  {
+    const auto factor = x / (2. * k);
+    term *= factor * factor;
+    sum += term;
+  }
+  return sum;
+}
+
+// Computes the dot products of x with a and with d at once. n is a multiple of 8.
+inline void dot2(const float* pA,
+                 const float* pD,
+                 const float* pX,
+                 const size_t n,
+                 float& a,
+                 float& d)
+{
+#if defined(LINK_SIMD_AVX2)
+  auto accA = _mm256_setzero_ps();
+  auto accD = _mm256_setzero_ps();
+  for (auto i = size_t{0}; i < n; i += 8)
+  {
+    const auto x = _mm256_loadu_ps(pX + i);
+    accA = _mm256_add_ps(accA, _mm256_mul_ps(_mm256_loadu_ps(pA + i), x));
+    accD = _mm256_add_ps(accD, _mm256_mul_ps(_mm256_loadu_ps(pD + i), x));
+  }
+  const auto sum = [](const __m256 v)
+  {
+    auto s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+  };
+  a = sum(accA);
+  d = sum(accD);
+#elif defined(LINK_SIMD_SSE2)
+  auto accA = _mm_setzero_ps();
+  auto accD = _mm_setzero_ps();
+  for (auto i = size_t{0}; i < n; i += 4)
+  {
+    const auto x = _mm_loadu_ps(pX + i);
+    accA = _mm_add_ps(accA, _mm_mul_ps(_mm_loadu_ps(pA + i), x));
+    accD = _mm_add_ps(accD, _mm_mul_ps(_mm_loadu_ps(pD + i), x));
+  }
+  const auto sum = [](__m128 s)
+  {
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+  };
+  a = sum(accA);
+  d = sum(accD);
+#elif defined(LINK_SIMD_NEON)
+  auto accA = vdupq_n_f32(0.f);
+  auto accD = vdupq_n_f32(0.f);
+  for (auto i = size_t{0}; i < n; i += 4)
+  {
+    const auto x = vld1q_f32(pX + i);
+    accA = vmlaq_f32(accA, vld1q_f32(pA + i), x);
+    accD = vmlaq_f32(accD, vld1q_f32(pD + i), x);
+  }
+  a = vaddvq_f32(accA);
+  d = vaddvq_f32(accD);
+#else
+  a = 0.f;
+  d = 0.f;
+  for (auto i = size_t{0}; i < n; ++i)
+  {
+    a += pA[i] * pX[i];
+    d += pD[i] * pX[i];
+  }
+#endif
+}
+
+} // namespace detail
+
+// Converts interleaved audio between arbitrary sample rates with a polyphase
+// windowed-sinc filter. The ratio of input to output frames can change at any time,
+// e.g. to correct clock drift. Output frame n corresponds to input position n * ratio
+// relative to the first input frame, so the output lags the input by latency() frames.
+class Resampler
+{
+public:
+  struct Result
+  {
+    size_t numInputFrames;
+    size_t numOutputFrames;
+  };
+
+  static constexpr auto kMinRatio = 1. / 16.;
+  static constexpr auto kMaxRatio = 16.;
+
+  Resampler(const size_t numChannels,
+            const ResamplerQuality quality = ResamplerQuality::kMedium,
+            const double ratio = 1.)
+    : mNumChannels(numChannels)
+    , mConfig(detail::resamplerConfig(quality))
+    , mChannels(numChannels)
+  {
+    setRatio(ratio);
+    reset();
+  }
+
+  // The number of input frames per output frame, i.e. input rate / output rate.
+  // Realtime-safe unless the anti-aliasing filter has to be redesigned, which happens
+  // when the ratio moves by more than 1% while being above 1.
+  void setRatio(const double ratio)
+  {
+    mRatio = std::clamp(ratio, kMinRatio, kMaxRatio);
+    const auto cutoff = mConfig.passband * std::min(1., 1. / mRatio);
+    if (std::abs(cutoff - mCutoff) > 0.01 * cutoff)
+    {
+      design(cutoff);
+    }
+  }
+
+  double ratio() const { return mRatio; }
+
+  // The number of input frames that are needed ahead of an output frame
+  size_t latency() const { return mNumTaps; }
+
+  void reset()
+  {
+    for (auto& channel : mChannels)
+    {
+      std::fill(channel.begin(), channel.end(), 0.f);
+    }
+    mNumBuffered = mNumTaps - 1;
+    mIndex = mNumBuffered;
+    mFraction = 0.;
+  }
+
+  // Consume up to numInputFrames and produce up to numOutputFrames. Stops when either
+  // the input is used up or the output is full.
+  Result process(const float* pInput,
+                 const size_t numInputFrames,
+                 float* pOutput,
+                 const size_t numOutputFrames)
+  {
+    const auto numTaps = mNumTaps;
+    auto result = Result{0, 0};
+    while (result.numOutputFrames < numOutputFrames)
+    {
+      const auto index = mIndex;
+      if (index + numTaps >= mNumBuffered)
+      {
+        if (result.numInputFrames == numInputFrames)
+        {
+          break;
+        }
+        const auto numConsumed =
+          append(pInput + result.numInputFrames * mNumChannels,
+                 numInputFrames - result.numInputFrames,
+                 index + 1 - numTaps);
+        result.numInputFrames += numConsumed;
+        continue;
+      }
+
+      const auto phase = mFraction * mConfig.numPhases;
+      const auto phaseIndex = static_cast<size_t>(phase);
+      const auto fraction = static_cast<float>(phase - static_cast<double>(phaseIndex));
+      const auto offset = phaseIndex * 2 * numTaps;
+      for (const auto& channel : mChannels)
+      {
+        auto a = 0.f;
+        auto d = 0.f;
+        detail::dot2(mCoefficients.data() + offset,
+                     mDeltas.data() + offset,
+                     channel.data() + index + 1 - numTaps,
+                     2 * numTaps,
+                     a,
+                     d);
+        *pOutput++ = a + fraction * d;
+      }
+
+      mFraction += mRatio;
+      const auto numAdvanced = std::floor(mFraction);
+      mIndex += static_cast<size_t>(numAdvanced);
+      mFraction -= numAdvanced;
+      ++result.numOutputFrames;
+    }
+    return result;
+  }
+
+private:
+  static constexpr auto kBlockFrames = size_t{512};
+  // When downsampling, filters get longer to keep their transition band narrow
+  static constexpr auto kMaxLengthScale = 3.;
+
+  // Drop the frames before first and append as many input frames as fit
+  size_t append(const float* pInput, const size_t numInputFrames, const size_t first)
+  {
+    const auto numDropped = std::min(first, mNumBuffered);
+    for (auto& channel : mChannels)
+    {
+      std::copy(channel.begin() + static_cast<std::ptrdiff_t>(numDropped),
+                channel.begin() + static_cast<std::ptrdiff_t>(mNumBuffered),
+                channel.begin());
+    }
+    mNumBuffered -= numDropped;
+    mIndex -= numDropped;
+
+    const auto numAppended = std::min(numInputFrames, mChannels[0].size() - mNumBuffered);
+    for (auto channel = size_t{0}; channel < mNumChannels; ++channel)
+    {
+      auto& samples = mChannels[channel];
+      for (auto frame = size_t{0}; frame < numAppended; ++frame)
+      {
+        samples[mNumBuffered + frame] = pInput[frame * mNumChannels + channel];
+      }
+    }
+    mNumBuffered += numAppended;
+    return numAppended;
+  }
+
+  // Kaiser windowed sinc filters for every phase, normalized to unity gain at DC.
+  // Phase p interpolates at p / numPhases frames after the center tap.
+  void design(const double cutoff)
+  {
+    const auto scale = std::min(mConfig.passband / cutoff, kMaxLengthScale);
+    const auto numTaps =
+      (static_cast<size_t>(std::ceil(mConfig.numTaps * scale)) + 3) / 4 * 4;
+    const auto numPhases = mConfig.numPhases;
+    const auto length = 2 * numTaps;
+    resizeHistory(numTaps);
+    mCoefficients.resize(numPhases * length);
+    mDeltas.resize(numPhases * length);
+    const auto window = [&](const double t)
+    {
+      const auto x = t / static_cast<double>(numTaps);
+      return std::abs(x) < 1. ? detail::besselI0(mConfig.beta * std::sqrt(1. - x * x))
+                                  / detail::besselI0(mConfig.beta)
+                              : 0.;
+    };
+    const auto filter = [&](const size_t phase, std::vector<double>& taps)
+    {
+      auto sum = 0.;
+      for (auto k = size_t{0}; k < length; ++k)
+      {
+        const auto t = static_cast<double>(k) - static_cast<double>(numTaps - 1)
+                       - static_cast<double>(phase) / static_cast<double>(numPhases);
+        const auto x = detail::kPi * cutoff * t;
+        taps[k] = (x == 0. ? 1. : std::sin(x) / x) * window(t);
+        sum += taps[k];
+      }
+      for (auto& tap : taps)
+      {
+        tap /= sum;
+      }
+    };
+
+    auto current = std::vector<double>(length);
+    auto next = std::vector<double>(length);
+    filter(0, current);
+    for (auto phase = size_t{0}; phase < numPhases; ++phase)
+    {
+      filter(phase + 1, next);
+      for (auto k = size_t{0}; k < length; ++k)
+      {
+        mCoefficients[phase * length + k] = static_cast<float>(current[k]);
+        mDeltas[phase * length + k] = static_cast<float>(next[k] - current[k]);
+      }
+      std::swap(current, next);
+    }
+    mCutoff = cutoff;
+  }
+
+  // Make room for the taps of a new filter length. Missing history is filled with
+  // silence, so the input position stays where it was.
+  void resizeHistory(const size_t numTaps)
+  {
+    const auto numMissing = mIndex + 1 < numTaps ? numTaps - 1 - mIndex : size_t{0};
+    for (auto& channel : mChannels)
+    {
+      channel.resize(std::max(channel.size(), kBlockFrames + 2 * numTaps + numMissing));
+      std::copy_backward(channel.begin(),
+                         channel.begin() + static_cast<std::ptrdiff_t>(mNumBuffered),
+                         channel.begin()
+                           + static_cast<std::ptrdiff_t>(mNumBuffered + numMissing));
+      std::fill_n(channel.begin(), numMissing, 0.f);
+    }
+    mNumBuffered += numMissing;
+    mIndex += numMissing;
+    mNumTaps = numTaps;
+  }
+
+  size_t mNumChannels;
+  detail::ResamplerConfig mConfig;
+  std::vector<float> mCoefficients;
+  std::vector<float> mDeltas;
+  std::vector<std::vector<float>> mChannels;
+  size_t mNumTaps = 0;
+  double mRatio = 1.;
+  double mCutoff = 0.;
+  size_t mNumBuffered = 0;
+  // Read position, kept apart from its fraction so that shifting the history doesn't
+  // change the rounding
+  size_t mIndex = 0;
+  double mFraction = 0.;
+};
+
+} // namespace link_audio
+} // namespace ableton
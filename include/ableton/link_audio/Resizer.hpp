@@ -36,6 +36,10 @@ namespace ableton
 namespace link_audio
 {
 
+// Collects interleaved samples into packets of at most maxNumBytes() audio bytes. Every
+// chunk besides the first one in a packet takes up space that would otherwise be used
+// for audio, so packets holding several chunks contain fewer frames. KMaxNumBytes is the
+// upper bound for the packet size that can be set at runtime.
 template <typename SampleFormat, typename Successor, size_t KMaxNumBytes>
 struct Resizer
 {
@@ -48,6 +52,19 @@ struct Resizer
   {
   }
 
+  uint32_t maxNumBytes() const { return mMaxNumBytes; }
+
+  // Pending samples are sent before the new size takes effect
+  void setMaxNumBytes(uint32_t maxNumBytes)
+  {
+    maxNumBytes = std::min(maxNumBytes, static_cast<uint32_t>(KMaxNumBytes));
+    if (maxNumBytes != mMaxNumBytes)
+    {
+      flush();
+      mMaxNumBytes = maxNumBytes;
+    }
+  }
+
   void operator()(const SampleFormat* samples,
                   uint32_t numFrames,
                   uint32_t numChannels,
@@ -56,13 +73,29 @@ struct Resizer
                   link::Tempo tempo,
                   Id sessionId)
   {
-    if (mCachedFrames != 0
-        && (numChannels != mNumChannels || sampleRate != mSampleRate
-            || sessionId != mSessionId))
+    if (numChannels != mNumChannels || sampleRate != mSampleRate
+        || sessionId != mSessionId)
     {
-      (*mSuccessor)(mCache.data(), mChunks, mNumChannels, mSampleRate, mSessionId);
-      mCachedFrames = 0;
-      mChunks.clear();
+      flush();
+    }
+
+    if (numFrames == 0)
+    {
+      return;
+    }
+
+    if (mCachedFrames != 0 && tempo != mChunks.back().tempo
+        && beginBeats != chunkEndBeats(mChunks.back()))
+    {
+      // The additional chunk has to leave room for at least one more frame
+      if (maxNumFrames(mChunks.size() + 1) <= mCachedFrames)
+      {
+        flush();
+      }
+      else
+      {
+        newChunk(beginBeats, tempo);
+      }
     }
 
     if (mCachedFrames == 0)
@@ -73,31 +106,29 @@ struct Resizer
       assert(mChunks.empty());
       newChunk(beginBeats, tempo);
     }
-    else if (tempo != mChunks.back().tempo && beginBeats != chunkEndBeats(mChunks.back()))
-    {
-      newChunk(beginBeats, tempo);
-    }
 
-    for (auto frame = 0u; frame < numFrames; ++frame)
+    // Samples are interleaved, so every run up to the next packet boundary is a single
+    // contiguous copy
+    while (numFrames > 0)
     {
-      for (auto channel = 0u; channel < mNumChannels; ++channel)
+      const auto packetFrames = maxNumFrames(mChunks.size());
+      assert(packetFrames > mCachedFrames);
+      const auto runFrames = std::min(numFrames, packetFrames - mCachedFrames);
+      std::copy_n(
+        samples, runFrames * mNumChannels, mCache.data() + mCachedFrames * mNumChannels);
+      samples += runFrames * mNumChannels;
+      numFrames -= runFrames;
+      mCachedFrames += runFrames;
+      mChunks.back().numFrames =
+        static_cast<uint16_t>(mChunks.back().numFrames + runFrames);
+
+      if (mCachedFrames >= packetFrames)
       {
-        mCache[mNumChannels * mCachedFrames + channel] =
-          samples[mNumChannels * frame + channel];
-      }
-      ++mCachedFrames;
-      ++mChunks.back().numFrames;
-
-
-      if (mCachedFrames >= ((kMaxNumSamples / mNumChannels)))
-      {
-        (*mSuccessor)(mCache.data(), mChunks, mNumChannels, mSampleRate, mSessionId);
-        mCachedFrames = 0;
         const auto nextChunkBeginBeats = chunkEndBeats(mChunks.back());
-        mChunks.clear();
+        flush();
 
         // Always create a new chunk when needed - don't lose data
-        if (frame + 1 < numFrames) // Only if there are more frames to process
+        if (numFrames > 0) // Only if there are more frames to process
         {
           newChunk(nextChunkBeginBeats, tempo);
         }
@@ -105,6 +136,17 @@ struct Resizer
     }
   }
 
+  // Sends the cached frames right away, even if they don't fill a packet
+  void flush()
+  {
+    if (mCachedFrames != 0)
+    {
+      (*mSuccessor)(mCache.data(), mChunks, mNumChannels, mSampleRate, mSessionId);
+      mCachedFrames = 0;
+    }
+    mChunks.clear();
+  }
+
 private:
   link::Beats chunkEndBeats(const AudioBuffer::Chunk& chunk)
   {
@@ -115,26 +157,23 @@ private:
     return beginBeats + link::Beats{rangeDuration / secondsPerBeat};
   }
 
-  uint32_t mCachedFrames = 0;
-  uint32_t mAvailableFrames = 0;
-
-  void updateAvailableFrames()
+  uint32_t maxNumFrames(const size_t numChunks) const
   {
-    const auto availableBytes =
-      kMaxNumSamples * kSampleFormatSize - discovery::sizeInByteStream(mChunks);
-    const auto bytesPerFrame = mNumChannels * kSampleFormatSize;
-    const auto offsetBytes = availableBytes % bytesPerFrame;
-    mAvailableFrames = (availableBytes - offsetBytes) / bytesPerFrame;
+    const auto chunkBytes =
+      static_cast<uint32_t>((numChunks - 1) * sizeInByteStream(mChunks.back()));
+    const auto availableBytes = mMaxNumBytes > chunkBytes ? mMaxNumBytes - chunkBytes : 0;
+    return availableBytes / (mNumChannels * kSampleFormatSize);
   }
 
   void newChunk(Beats beats, Tempo tempo)
   {
     mChunks.emplace_back(AudioBuffer::Chunk{++mCount, 0, beats, tempo});
-    updateAvailableFrames();
   }
 
   std::array<SampleFormat, kMaxNumSamples> mCache;
   util::Injected<Successor> mSuccessor;
+  uint32_t mMaxNumBytes = kMaxNumSamples * kSampleFormatSize;
+  uint32_t mCachedFrames = 0;
   uint32_t mNumChannels = 0u;
   uint32_t mSampleRate = 0u;
   Id mSessionId;
@@ -0,0 +1,449 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/link_audio/Buffer.hpp>
+#include <ableton/util/Injected.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace detail
+{
+
+static constexpr auto kMinConcealmentPeriod = size_t{32};
+static constexpr auto kMaxConcealmentPeriod = size_t{768};
+static constexpr auto kConcealmentMatchFrames = size_t{256};
+static constexpr auto kConcealmentHistoryFrames =
+  kMaxConcealmentPeriod + kConcealmentMatchFrames;
+
+// Find the period of the end of interleaved audio by comparing its last frames with
+// earlier frames at every candidate lag. Returns 0 if there are too few frames.
+inline size_t findPeriod(const int16_t* pSamples,
+                         const size_t numFrames,
+                         const size_t numChannels)
+{
+  if (numFrames < kConcealmentMatchFrames + kMinConcealmentPeriod)
+  {
+    return 0;
+  }
+
+  const auto mono = [&](const size_t frame)
+  {
+    auto sum = 0.f;
+    for (auto channel = size_t{0}; channel < numChannels; ++channel)
+    {
+      sum += static_cast<float>(pSamples[frame * numChannels + channel]);
+    }
+    return sum;
+  };
+
+  const auto matchBegin = numFrames - kConcealmentMatchFrames;
+  const auto maxPeriod = std::min(kMaxConcealmentPeriod, matchBegin);
+
+  auto bestPeriod = kMinConcealmentPeriod;
+  auto bestScore = -1.f;
+  for (auto period = kMinConcealmentPeriod; period <= maxPeriod; ++period)
+  {
+    auto xy = 0.f;
+    auto yy = 0.f;
+    for (auto i = matchBegin; i < numFrames; ++i)
+    {
+      const auto y = mono(i - period);
+      xy += mono(i) * y;
+      yy += y * y;
+    }
+    const auto score = yy > 0.f ? xy / std::sqrt(yy) : 0.f;
+    if (score > bestScore)
+    {
+      bestScore = score;
+      bestPeriod = period;
+    }
+  }
+  return bestPeriod;
+}
+
+} // namespace detail
+
+// Passes on chunks in the order of their count. Chunks that arrive early are held
+// back until the missing ones arrive, the window of held chunks is full or the held
+// chunks cover more than the maximum hold time. Then the missing chunks are considered
+// lost and, if enabled, replaced with concealment audio of the same duration. Duplicates
+// and chunks that arrive too late are dropped.
+//
+// The successor receives chunks via operator() and lost chunks via lost(numBuffers).
+template <typename Successor>
+struct Sequencer
+{
+  using Handle = BufferCallbackHandle<Buffer<int16_t>>;
+
+  static constexpr auto kWindowSize = uint64_t{16};
+  // Count jumps beyond this are treated as a new stream instead of a gap
+  static constexpr auto kMaxGap = uint64_t{1024};
+  static constexpr auto kFadeTime = 0.02;
+
+  Sequencer(util::Injected<Successor> successor, uint32_t cacheSize)
+    : mSuccessor(std::move(successor))
+    , mHeld(kWindowSize, Buffer<int16_t>{0})
+    , mConcealment(cacheSize)
+  {
+    for (auto& slot : mHeld)
+    {
+      slot.mSamples.reserve(cacheSize);
+    }
+  }
+
+  Sequencer(const Sequencer&) = delete;
+  Sequencer& operator=(const Sequencer&) = delete;
+
+  void setConcealmentEnabled(const bool isEnabled) { mIsConcealmentEnabled = isEnabled; }
+
+  // Audio duration of the chunks that may be held back while waiting for a missing one.
+  // Unbounded by default.
+  void setMaxHoldTime(const std::chrono::microseconds maxHoldTime)
+  {
+    mMaxHoldTime = maxHoldTime;
+  }
+
+  std::chrono::microseconds maxHoldTime() const { return mMaxHoldTime; }
+
+  // Give up on all missing chunks and pass on the held ones, e.g. because the stream
+  // stalled
+  void flush()
+  {
+    while (const auto pHeld = firstHeld())
+    {
+      giveUp(Handle{*pHeld, pHeld->mSamples.data()});
+    }
+  }
+
+  // Forget the stream, e.g. because it is continued with other counts
+  void reset()
+  {
+    releaseAll();
+    mNext = std::nullopt;
+    mNumHistoryFrames = 0;
+  }
+
+  uint64_t numLostBuffers() const { return mNumLostBuffers; }
+
+  uint64_t numDroppedBuffers() const { return mNumDroppedBuffers; }
+
+  void operator()(const Handle handle)
+  {
+    const auto count = handle.mBuffer.mCount;
+
+    if (mNext && count < *mNext && *mNext - count <= kMaxGap)
+    {
+      ++mNumDroppedBuffers;
+      return;
+    }
+
+    if (!mNext || count < *mNext || count - *mNext > kMaxGap)
+    {
+      reset();
+      deliver(handle);
+      return;
+    }
+
+    // Give up on missing chunks until this one fits into the window and the held
+    // chunks don't exceed the hold time
+    while (count > *mNext
+           && (count - *mNext >= kWindowSize
+               || duration(handle.mBuffer) > mMaxHoldTime - heldDuration()))
+    {
+      const auto pHeld = firstHeld();
+      giveUp(pHeld ? Handle{*pHeld, pHeld->mSamples.data()} : handle);
+    }
+
+    if (count == *mNext)
+    {
+      deliver(handle);
+      releaseHeld();
+    }
+    else
+    {
+      auto& slot = mHeld[count % kWindowSize];
+      if (mIsHeld[count % kWindowSize])
+      {
+        ++mNumDroppedBuffers;
+        return;
+      }
+      hold(slot, handle);
+      mIsHeld[count % kWindowSize] = true;
+    }
+  }
+
+private:
+  void hold(Buffer<int16_t>& slot, const Handle handle)
+  {
+    const auto& buffer = handle.mBuffer;
+    slot.mSampleRate = buffer.mSampleRate;
+    slot.mNumChannels = buffer.mNumChannels;
+    slot.mNumFrames = buffer.mNumFrames;
+    slot.mBeginBeats = buffer.mBeginBeats;
+    slot.mTempo = buffer.mTempo;
+    slot.mCount = buffer.mCount;
+    slot.mSessionId = buffer.mSessionId;
+    slot.mIsConcealed = buffer.mIsConcealed;
+    slot.mSamples.assign(
+      handle.mpSamples, handle.mpSamples + buffer.mNumFrames * buffer.mNumChannels);
+  }
+
+  // Conceal the chunks missing before next and pass on the held ones that follow it
+  void giveUp(const Handle next)
+  {
+    conceal(*mNext, next.mBuffer.mCount, next);
+    mNext = next.mBuffer.mCount;
+    releaseHeld();
+  }
+
+  Buffer<int16_t>* firstHeld()
+  {
+    if (!mNext)
+    {
+      return nullptr;
+    }
+    for (auto count = *mNext; count < *mNext + kWindowSize; ++count)
+    {
+      if (mIsHeld[count % kWindowSize])
+      {
+        return &mHeld[count % kWindowSize];
+      }
+    }
+    return nullptr;
+  }
+
+  void releaseHeld()
+  {
+    while (mIsHeld[*mNext % kWindowSize])
+    {
+      auto& slot = mHeld[*mNext % kWindowSize];
+      mIsHeld[*mNext % kWindowSize] = false;
+      deliver(Handle{slot, slot.mSamples.data()});
+    }
+  }
+
+  // Deliver held chunks in order without concealing what is missing in between
+  void releaseAll()
+  {
+    while (mNext)
+    {
+      const auto pHeld = firstHeld();
+      if (!pHeld)
+      {
+        break;
+      }
+      mNext = pHeld->mCount;
+      releaseHeld();
+    }
+    mIsHeld.fill(false);
+  }
+
+  void deliver(const Handle handle)
+  {
+    const auto& buffer = handle.mBuffer;
+    mNext = buffer.mCount + 1;
+    mLast = Format{buffer.mSampleRate,
+                   buffer.mNumChannels,
+                   buffer.mBeginBeats + endOffset(buffer),
+                   buffer.mTempo,
+                   buffer.mSessionId};
+    if (mIsConcealmentEnabled)
+    {
+      remember(handle.mpSamples, buffer.mNumFrames, buffer.mNumChannels);
+    }
+    (*mSuccessor)(handle);
+  }
+
+  // Keep the most recent frames to continue the waveform from in case of a loss
+  void remember(const int16_t* pSamples, const size_t numFrames, const size_t numChannels)
+  {
+    const auto historySize = detail::kConcealmentHistoryFrames * numChannels;
+    if (mHistory.size() != historySize)
+    {
+      mHistory.assign(historySize, 0);
+      mNumHistoryFrames = 0;
+    }
+
+    const auto numNew = std::min(numFrames, detail::kConcealmentHistoryFrames);
+    const auto numKept = detail::kConcealmentHistoryFrames - numNew;
+    std::memmove(mHistory.data(),
+                 mHistory.data() + numNew * numChannels,
+                 numKept * numChannels * sizeof(int16_t));
+    std::memcpy(mHistory.data() + numKept * numChannels,
+                pSamples + (numFrames - numNew) * numChannels,
+                numNew * numChannels * sizeof(int16_t));
+    mNumHistoryFrames =
+      std::min(mNumHistoryFrames + numNew, detail::kConcealmentHistoryFrames);
+  }
+
+  static std::chrono::microseconds duration(const Buffer<int16_t>& buffer)
+  {
+    return buffer.mSampleRate > 0
+             ? std::chrono::microseconds{int64_t{buffer.mNumFrames} * 1000000
+                                         / buffer.mSampleRate}
+             : std::chrono::microseconds{0};
+  }
+
+  std::chrono::microseconds heldDuration() const
+  {
+    auto result = std::chrono::microseconds{0};
+    for (auto i = size_t{0}; i < kWindowSize; ++i)
+    {
+      if (mIsHeld[i])
+      {
+        result += duration(mHeld[i]);
+      }
+    }
+    return result;
+  }
+
+  static link::Beats endOffset(const Buffer<int16_t>& buffer)
+  {
+    return link::Beats{static_cast<double>(buffer.mNumFrames)
+                       / static_cast<double>(buffer.mSampleRate) * buffer.mTempo.bpm()
+                       / 60.};
+  }
+
+  // Replace the chunks from first to end with audio that continues the waveform of the
+  // last delivered chunk and crossfades into the chunk that follows the gap
+  void conceal(const uint64_t first, const uint64_t end, const Handle next)
+  {
+    const auto numMissing = end - first;
+    mNumLostBuffers += numMissing;
+    mSuccessor->lost(numMissing);
+
+    const auto& nextBuffer = next.mBuffer;
+    if (!mIsConcealmentEnabled || !mLast || mLast->sampleRate != nextBuffer.mSampleRate
+        || mLast->numChannels != nextBuffer.mNumChannels || nextBuffer.mSampleRate == 0)
+    {
+      return;
+    }
+
+    const auto numChannels = size_t{mLast->numChannels};
+    const auto maxFrames = mConcealment.mSamples.size() / numChannels;
+    const auto sampleRate = static_cast<double>(mLast->sampleRate);
+
+    // The beat time of the next chunk tells how much audio is missing
+    auto numFrames = size_t{0};
+    if (mLast->sessionId == nextBuffer.mSessionId && nextBuffer.mBeginBeats > mLast->end
+        && mLast->tempo.bpm() > 0.)
+    {
+      numFrames = static_cast<size_t>(std::llround(
+        (nextBuffer.mBeginBeats - mLast->end).floating() * 60. / mLast->tempo.bpm()
+        * sampleRate));
+    }
+    numFrames = std::min(numFrames, numMissing * maxFrames);
+
+    const auto period =
+      detail::findPeriod(mHistory.data()
+                           + (detail::kConcealmentHistoryFrames - mNumHistoryFrames)
+                               * numChannels,
+                         mNumHistoryFrames,
+                         numChannels);
+    const auto nextPeriod = std::min(
+      size_t{nextBuffer.mNumFrames}, period > 0 ? period : detail::kMaxConcealmentPeriod);
+    const auto numFadeFrames =
+      std::min(numFrames, static_cast<size_t>(kFadeTime * sampleRate));
+
+    auto beginBeats = mLast->end;
+    auto offset = size_t{0};
+    for (auto i = uint64_t{0}; i < numMissing; ++i)
+    {
+      const auto pieceEnd = static_cast<size_t>(numFrames * (i + 1) / numMissing);
+      auto pOut = mConcealment.mSamples.data();
+      for (; offset < pieceEnd; ++offset)
+      {
+        const auto fade = static_cast<float>(numFadeFrames);
+        const auto fadeOut =
+          offset < numFadeFrames ? 1.f - static_cast<float>(offset) / fade : 0.f;
+        const auto fadeIn = numFrames - offset <= numFadeFrames
+                              ? 1.f - static_cast<float>(numFrames - offset) / fade
+                              : 0.f;
+        const auto pForward =
+          period > 0
+            ? mHistory.data()
+                + (detail::kConcealmentHistoryFrames - period + offset % period)
+                    * numChannels
+            : nullptr;
+        const auto pBackward =
+          nextPeriod > 0
+            ? next.mpSamples
+                + (nextPeriod - 1 - (numFrames - offset - 1) % nextPeriod) * numChannels
+            : nullptr;
+
+        for (auto channel = size_t{0}; channel < numChannels; ++channel)
+        {
+          const auto forward = pForward ? static_cast<float>(pForward[channel]) : 0.f;
+          const auto backward = pBackward ? static_cast<float>(pBackward[channel]) : 0.f;
+          *pOut++ = static_cast<int16_t>(std::lround(
+            std::clamp(fadeOut * forward + fadeIn * backward, -32768.f, 32767.f)));
+        }
+      }
+
+      mConcealment.mSampleRate = mLast->sampleRate;
+      mConcealment.mNumChannels = mLast->numChannels;
+      mConcealment.mNumFrames =
+        static_cast<uint32_t>(pOut - mConcealment.mSamples.data()) / mLast->numChannels;
+      mConcealment.mBeginBeats = beginBeats;
+      mConcealment.mTempo = mLast->tempo;
+      mConcealment.mCount = first + i;
+      mConcealment.mSessionId = mLast->sessionId;
+      mConcealment.mIsConcealed = true;
+      beginBeats = beginBeats + endOffset(mConcealment);
+
+      (*mSuccessor)(Handle{mConcealment, mConcealment.mSamples.data()});
+    }
+  }
+
+  struct Format
+  {
+    uint32_t sampleRate;
+    uint32_t numChannels;
+    link::Beats end;
+    link::Tempo tempo;
+    Id sessionId;
+  };
+
+  util::Injected<Successor> mSuccessor;
+  bool mIsConcealmentEnabled = false;
+  std::chrono::microseconds mMaxHoldTime = std::chrono::microseconds::max();
+  std::optional<uint64_t> mNext;
+  std::optional<Format> mLast;
+  std::vector<Buffer<int16_t>> mHeld;
+  std::array<bool, kWindowSize> mIsHeld{};
+  std::vector<int16_t> mHistory;
+  size_t mNumHistoryFrames = 0;
+  Buffer<int16_t> mConcealment;
+  uint64_t mNumLostBuffers = 0;
+  uint64_t mNumDroppedBuffers = 0;
+};
+
+} // namespace link_audio
+} // namespace ableton
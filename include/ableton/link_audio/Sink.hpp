@@ -20,10 +20,18 @@
 #include <ableton/link_audio/BeatTimeMapping.hpp>
 #include <ableton/link_audio/Buffer.hpp>
 #include <ableton/link_audio/Id.hpp>
+#include <ableton/link_audio/Latency.hpp>
+#include <ableton/link_audio/Parity.hpp>
 #include <ableton/link_audio/Queue.hpp>
+#include <ableton/link_audio/v1/Messages.hpp>
 #include <ableton/util/Locked.hpp>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
 #include <string>
+#include <vector>
 
 #pragma once
 
@@ -32,14 +40,43 @@ namespace ableton
 namespace link_audio
 {
 
+static constexpr auto kDefaultSinkQueueDepth = size_t{128};
+// Wider sinks send larger audio buffer messages unless configured otherwise
+static constexpr auto kMaxNumChannelsPerDefaultMessage = size_t{8};
+
+struct SinkStats
+{
+  uint64_t numCommittedBuffers;
+  uint64_t numDroppedBuffers;
+  size_t maxNumQueuedBuffers;
+  uint64_t numPacketsSent;
+  uint64_t numBytesSent;
+  size_t numReceivers;
+  size_t numMulticastReceivers;
+  std::chrono::nanoseconds encodeTime;
+};
+
+// The samples of all buffers of the queue live in one arena. It is only allocated while
+// the sink has receivers, and sized for the requested maximum number of samples.
 struct Sink
 {
-  Sink(std::string name, size_t maxNumSamples, Id id)
+  using SinkBuffer = Buffer<int16_t, SampleSpan<int16_t>>;
+
+  // Called on the audio thread after a buffer has been committed. Must be realtime safe.
+  using CommitCallback = std::function<void()>;
+
+  Sink(std::string name,
+       size_t maxNumSamples,
+       Id id,
+       CommitCallback onCommit = {},
+       size_t queueDepth = kDefaultSinkQueueDepth,
+       GetGhostTime getGhostTime = {})
     : mName{std::move(name)}
     , mId{std::move(id)}
     , mMaxNumSamples{maxNumSamples}
-    , mQueue(128, {static_cast<uint32_t>(maxNumSamples)})
-    , mIsConnected(false)
+    , mQueue(std::max(queueDepth, size_t{1}), {})
+    , mOnCommit(std::move(onCommit))
+    , mGetGhostTime(std::move(getGhostTime))
   {
   }
 
@@ -55,24 +92,30 @@ struct Sink
 
   const Id& id() const { return mId; }
 
-  Buffer<int16_t>* retainBuffer()
+  SinkBuffer* retainBuffer()
   {
     auto queueWriter = mQueue.writer();
 
-    if (!mIsConnected || queueWriter.numRetainedSlots() > 0)
+    if (queueWriter.numRetainedSlots() > 0)
     {
       return nullptr;
     }
 
-    if (!queueWriter.retainSlot())
+    if (mArenaState != ArenaState::kInUse)
     {
+      // Holding no buffer, the audio thread lets go of an arena that is being released
+      auto state = ArenaState::kReleasing;
+      if (mArenaState.compare_exchange_strong(state, ArenaState::kUnused) && mOnCommit)
+      {
+        mOnCommit();
+      }
       return nullptr;
     }
 
-    if (queueWriter[0]->mSamples.size() < mMaxNumSamples)
+    if (!queueWriter.retainSlot())
     {
-      queueWriter.releaseSlot();
-      return retainBuffer();
+      ++mNumDroppedBuffers;
+      return nullptr;
     }
 
     return queueWriter[0];
@@ -96,10 +139,24 @@ struct Sink
       pBuffer->mBeginBeats = beginBeats;
       pBuffer->mTempo = timeline.tempo;
       pBuffer->mNumChannels = static_cast<uint32_t>(numChannels);
+      mNumChannels = numChannels;
       pBuffer->mSampleRate = sampleRate;
       pBuffer->mNumFrames = static_cast<uint32_t>(numFrames);
       pBuffer->mSessionId = sessionId;
+      pBuffer->mCommitTime = ghostTime();
       queueWriter.releaseSlot();
+
+      ++mNumCommittedBuffers;
+      const auto numQueued = queueWriter.numQueuedSlots();
+      if (numQueued > mMaxNumQueuedBuffers)
+      {
+        mMaxNumQueuedBuffers = numQueued;
+      }
+
+      if (mOnCommit)
+      {
+        mOnCommit();
+      }
     }
   }
 
@@ -117,27 +174,197 @@ struct Sink
     }
   }
 
-  void requestMaxNumSamples(size_t numSamples) { mMaxNumSamples = numSamples; }
+  void requestMaxNumSamples(size_t numSamples)
+  {
+    auto maxNumSamples = mMaxNumSamples.load();
+    while (maxNumSamples < numSamples
+           && !mMaxNumSamples.compare_exchange_weak(maxNumSamples, numSamples))
+    {
+    }
+  }
 
   size_t maxNumSamples() const { return mMaxNumSamples; }
 
-  Buffer<int16_t>* buffer()
+  void setMaxMessageSize(size_t maxMessageSize)
+  {
+    mMaxMessageSize = std::clamp(
+      maxMessageSize, v1::kDefaultMaxAudioBufferMessageSize, v1::kMaxMessageSize);
+  }
+
+  // Unless set explicitly, the size follows the number of channels last committed. Only
+  // a few frames of a wide sink would fit into a message of the default size.
+  size_t maxMessageSize() const
+  {
+    const auto maxMessageSize = mMaxMessageSize.load();
+    if (maxMessageSize > 0)
+    {
+      return maxMessageSize;
+    }
+    return mNumChannels > kMaxNumChannelsPerDefaultMessage
+             ? v1::kMaxMessageSize
+             : v1::kDefaultMaxAudioBufferMessageSize;
+  }
+
+  void setMulticastEnabled(bool isEnabled)
+  {
+    if (mIsMulticastEnabled.exchange(isEnabled) != isEnabled)
+    {
+      mMulticastIsUpToDate.clear();
+    }
+  }
+
+  bool isMulticastEnabled() const { return mIsMulticastEnabled; }
+
+  bool multicastChanged() { return !mMulticastIsUpToDate.test_and_set(); }
+
+  void setFecGroupSize(size_t groupSize)
+  {
+    mFecGroupSize =
+      groupSize < 2 ? 0 : std::min(groupSize, size_t{AudioParity::kMaxGroupSize});
+  }
+
+  size_t fecGroupSize() const { return mFecGroupSize; }
+
+  void setLowLatencyEnabled(bool isEnabled) { mIsLowLatencyEnabled = isEnabled; }
+
+  bool isLowLatencyEnabled() const { return mIsLowLatencyEnabled; }
+
+  SinkBuffer* buffer()
   {
     auto queueWriter = mQueue.writer();
     return queueWriter.numRetainedSlots() > 0 ? queueWriter[0] : nullptr;
   }
 
-  Queue<Buffer<int16_t>>::Reader reader() { return mQueue.reader(); }
+  Queue<SinkBuffer>::Reader reader() { return mQueue.reader(); }
+
+  size_t queueDepth() const { return mQueue.writer().numSlots(); }
+
+  // Counters are written by the thread they belong to and can be read from any thread.
+  // The snapshot is not consistent across counters.
+  SinkStats stats() const
+  {
+    return {mNumCommittedBuffers,
+            mNumDroppedBuffers,
+            mMaxNumQueuedBuffers,
+            mNumPacketsSent,
+            mNumBytesSent,
+            mNumReceivers,
+            mNumMulticastReceivers,
+            std::chrono::nanoseconds{mEncodeTimeNs}};
+  }
+
+  // Called on the processing thread
+  void addSentPackets(const size_t numPackets, const size_t numBytes)
+  {
+    mNumPacketsSent += numPackets;
+    mNumBytesSent += numBytes;
+  }
+
+  // Called on the processing thread
+  void setNumReceivers(const size_t numReceivers, const size_t numMulticastReceivers)
+  {
+    mNumReceivers = numReceivers;
+    mNumMulticastReceivers = numMulticastReceivers;
+  }
+
+  // Called on the processing thread
+  void addEncodeTime(const std::chrono::nanoseconds time)
+  {
+    mEncodeTimeNs += time.count();
+  }
+
+  bool measuresLatency() const { return static_cast<bool>(mGetGhostTime); }
 
-  void setIsConnected(bool isConnected) { mIsConnected = isConnected; }
+  // The session's ghost time if the sink measures latency. Realtime safe.
+  std::optional<std::chrono::microseconds> ghostTime() const
+  {
+    return mGetGhostTime ? std::optional<std::chrono::microseconds>{mGetGhostTime()}
+                         : std::nullopt;
+  }
+
+  // Number of samples allocated for the queue
+  size_t arenaSize() const { return mArena.size(); }
+
+  // Called on the processing thread whenever the sink's receivers may have changed and
+  // while it doesn't retain a buffer of the queue. The arena is allocated as soon as
+  // the first receiver connects. It is released or resized once the audio thread has
+  // let go of it, which it does the next time it tries to retain a buffer.
+  void setIsConnected(const bool isConnected)
+  {
+    const auto numSamples = isConnected ? mMaxNumSamples.load() : size_t{0};
+    auto state = mArenaState.load();
+    if (state == ArenaState::kInUse || state == ArenaState::kReleasing)
+    {
+      const auto next =
+        numSamples == mNumSamplesPerBuffer ? ArenaState::kInUse : ArenaState::kReleasing;
+      if (mArenaState.compare_exchange_strong(state, next))
+      {
+        return;
+      }
+    }
+
+    // The audio thread doesn't use the arena. Buffers it committed before letting go
+    // of it are dropped.
+    if (state == ArenaState::kReleased && numSamples == 0)
+    {
+      return;
+    }
+    auto queueReader = mQueue.reader();
+    while (queueReader.retainSlot())
+    {
+      queueReader.releaseSlot();
+    }
+
+    auto numBuffers = size_t{0};
+    mQueue.forEachSlot([&](SinkBuffer&) { ++numBuffers; });
+    mArena = std::vector<int16_t>(numSamples * numBuffers);
+    mNumSamplesPerBuffer = numSamples;
+    auto pSamples = mArena.data();
+    mQueue.forEachSlot(
+      [&](SinkBuffer& buffer)
+      {
+        buffer.mSamples = {numSamples > 0 ? pSamples : nullptr, numSamples};
+        pSamples += numSamples;
+      });
+    mArenaState = numSamples > 0 ? ArenaState::kInUse : ArenaState::kReleased;
+  }
 
 private:
   util::Locked<std::string> mName;
   std::atomic_flag mNameIsUpToDate = ATOMIC_FLAG_INIT;
   Id mId;
   std::atomic<size_t> mMaxNumSamples;
-  Queue<Buffer<int16_t>> mQueue;
-  std::atomic<bool> mIsConnected;
+  std::atomic<size_t> mMaxMessageSize{0};
+  std::atomic<size_t> mNumChannels{0};
+  std::atomic<bool> mIsMulticastEnabled{false};
+  std::atomic_flag mMulticastIsUpToDate = ATOMIC_FLAG_INIT;
+  std::atomic<size_t> mFecGroupSize{0};
+  std::atomic<bool> mIsLowLatencyEnabled{false};
+  Queue<SinkBuffer> mQueue;
+
+  // Written by the audio thread
+  std::atomic<uint64_t> mNumCommittedBuffers{0};
+  std::atomic<uint64_t> mNumDroppedBuffers{0};
+  std::atomic<size_t> mMaxNumQueuedBuffers{0};
+  // Written by the processing thread
+  std::atomic<uint64_t> mNumPacketsSent{0};
+  std::atomic<uint64_t> mNumBytesSent{0};
+  std::atomic<size_t> mNumReceivers{0};
+  std::atomic<size_t> mNumMulticastReceivers{0};
+  std::atomic<int64_t> mEncodeTimeNs{0};
+
+  enum class ArenaState
+  {
+    kReleased,  // No arena
+    kInUse,     // The audio thread may write to the arena
+    kReleasing, // The audio thread is asked to let go of the arena
+    kUnused,    // The audio thread let go of the arena
+  };
+  std::atomic<ArenaState> mArenaState{ArenaState::kReleased};
+  std::vector<int16_t> mArena;     // Processing thread only
+  size_t mNumSamplesPerBuffer = 0; // Processing thread only
+  CommitCallback mOnCommit;
+  GetGhostTime mGetGhostTime;
 };
 
 } // namespace link_audio
@@ -19,12 +19,19 @@
 
 #pragma once
 
+#include <ableton/link_audio/ChannelAnnouncements.hpp>
 #include <ableton/link_audio/Encoder.hpp>
 #include <ableton/link_audio/Id.hpp>
+#include <ableton/link_audio/Parity.hpp>
 #include <ableton/link_audio/Receivers.hpp>
 #include <ableton/link_audio/Sink.hpp>
 #include <ableton/util/Injected.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace ableton
@@ -52,6 +59,10 @@ struct SinkProcessor
 
   bool nameChanged() { return mpImpl->nameChanged(); }
 
+  bool multicastChanged() { return mpImpl->multicastChanged(); }
+
+  bool isMulticastEnabled() const { return mpImpl->isMulticastEnabled(); }
+
   template <typename Request>
   void receiveChannelRequest(Request request, uint8_t ttl)
   {
@@ -60,24 +71,26 @@ struct SinkProcessor
 
   struct Impl : public std::enable_shared_from_this<Impl>
   {
+    // Messages are collected during process() and sent to the receivers together
+    static constexpr size_t kMaxNumPendingMessages = 16;
+
+    // Collects the messages for the receivers of one codec
     struct Sender
     {
-      void operator()(const AudioBuffer& buffer)
-      {
-        auto end =
-          v1::audioBufferMessage((*mpImpl->mGetNodeId)(), buffer, mBuffer.begin());
-        try
-        {
-          mpImpl->mReceivers(mBuffer.data(), std::distance(mBuffer.begin(), end));
-        }
-        catch (const std::runtime_error& err)
-        {
-          debug(mpImpl->mIo->log()) << "Failed to send message: " << err.what();
-        }
-      }
+      void operator()(const AudioBuffer& buffer) { mpImpl->send(buffer, mCodec); }
 
       Impl* mpImpl;
-      std::array<uint8_t, v1::kMaxMessageSize> mBuffer{};
+      Codec mCodec;
+    };
+
+    struct PendingMessages
+    {
+      std::array<v1::MessageBuffer, kMaxNumPendingMessages> messages;
+      std::array<typename Receivers<GetSender, IoContext>::Packet, kMaxNumPendingMessages>
+        packets;
+      size_t numPending = 0;
+      ParityEncoder parity;
+      bool isTimed = false;
     };
 
     Impl(util::Injected<IoContext> io,
@@ -87,7 +100,9 @@ struct SinkProcessor
       : mIo(std::move(io))
       , mpSink(pSink)
       , mQueueReader(pSink->reader())
-      , mEncoder(util::injectVal(Sender{this}), mpSink->id())
+      , mEncoder(util::injectVal(Sender{this, Codec::kPCM_i16}), mpSink->id())
+      , mLPCEncoder(util::injectVal(Sender{this, Codec::kLPC_i16}), mpSink->id())
+      , mADPCMEncoder(util::injectVal(Sender{this, Codec::kADPCM_i4}), mpSink->id())
       , mReceivers(util::injectRef(*mIo), std::move(getSender))
       , mGetNodeId(std::move(getNodeId))
     {
@@ -100,43 +115,185 @@ struct SinkProcessor
         return false;
       }
 
+      mReceivers.setMulticastGroup(
+        mpSink->isMulticastEnabled()
+          ? std::optional<discovery::UdpEndpoint>{multicastGroup(mpSink->id())}
+          : std::nullopt);
+
+      // Parity messages are larger than the audio buffer messages they protect, so
+      // these are made smaller to keep all messages within the sink's size
+      const auto fecGroupSize = static_cast<uint32_t>(mpSink->fecGroupSize());
+      const auto maxMessageSize =
+        fecGroupSize == 0 ? mpSink->maxMessageSize()
+                          : mpSink->maxMessageSize() - AudioParity::overhead(fecGroupSize);
+      for (auto& pending : mPending)
+      {
+        pending.parity.setGroupSize(fecGroupSize);
+      }
+      mEncoder.setMaxMessageSize(timedMaxMessageSize(maxMessageSize, Codec::kPCM_i16));
+      mLPCEncoder.setMaxMessageSize(timedMaxMessageSize(maxMessageSize, Codec::kLPC_i16));
+      mADPCMEncoder.setMaxMessageSize(
+        timedMaxMessageSize(maxMessageSize, Codec::kADPCM_i4));
+
+      const auto hasPCMReceivers = mReceivers.hasReceivers(Codec::kPCM_i16);
+      const auto hasLPCReceivers = mReceivers.hasReceivers(Codec::kLPC_i16);
+      const auto hasADPCMReceivers = mReceivers.hasReceivers(Codec::kADPCM_i4);
+      const auto isLowLatencyEnabled = mpSink->isLowLatencyEnabled();
+      const auto encodeBegin = std::chrono::steady_clock::now();
       while (mQueueReader.retainSlot())
       {
-        if (!mReceivers.empty() && mQueueReader[0]->mTempo > link::Tempo{0})
-        {
-          mEncoder(*mQueueReader[0]);
-        }
-        if (mQueueReader[0]->mSamples.size() < mpSink->maxNumSamples())
+        if (mQueueReader[0]->mTempo > link::Tempo{0})
         {
-          mQueueReader[0]->mSamples.resize(mpSink->maxNumSamples());
+          mCommitTime = mQueueReader[0]->mCommitTime;
+          if (hasPCMReceivers)
+          {
+            encode(mEncoder, *mQueueReader[0], isLowLatencyEnabled);
+          }
+          if (hasLPCReceivers)
+          {
+            encode(mLPCEncoder, *mQueueReader[0], isLowLatencyEnabled);
+          }
+          if (hasADPCMReceivers)
+          {
+            encode(mADPCMEncoder, *mQueueReader[0], isLowLatencyEnabled);
+          }
         }
         mQueueReader.releaseSlot();
       }
+      mpSink->addEncodeTime(std::chrono::steady_clock::now() - encodeBegin);
+
+      // Receivers may have expired and the requested buffer size may have changed
+      mpSink->setIsConnected(!mReceivers.empty());
+      mpSink->setNumReceivers(
+        mReceivers.numReceivers(), mReceivers.numMulticastReceivers());
+
+      flush(Codec::kPCM_i16);
+      flush(Codec::kLPC_i16);
+      flush(Codec::kADPCM_i4);
 
       return true;
     }
 
+    // In low latency mode every committed buffer is sent right away, the last packet
+    // only partially filled, instead of waiting for frames of the next buffer
+    template <typename Encoder>
+    static void encode(Encoder& encoder,
+                       const Sink::SinkBuffer& buffer,
+                       const bool isLowLatencyEnabled)
+    {
+      encoder(buffer);
+      if (isLowLatencyEnabled)
+      {
+        encoder.flush();
+      }
+    }
+
+    // Buffers of codecs whose receivers all accept timing carry it after their audio
+    size_t timedMaxMessageSize(const size_t maxMessageSize, const Codec codec)
+    {
+      auto& pending = pendingMessages(codec);
+      pending.isTimed = mpSink->measuresLatency() && mReceivers.acceptsTiming(codec);
+      return pending.isTimed ? maxMessageSize - AudioBufferTiming::kSize : maxMessageSize;
+    }
+
+    // A buffer that spans several commits is timed by the commit that completed it
+    void send(const AudioBuffer& buffer, const Codec codec)
+    {
+      auto& pending = pendingMessages(codec);
+      if (pending.numPending == kMaxNumPendingMessages)
+      {
+        flush(codec);
+      }
+
+      auto& message = pending.messages[pending.numPending];
+      const auto oSendTime = pending.isTimed ? mpSink->ghostTime() : std::nullopt;
+      const auto end =
+        oSendTime && mCommitTime
+          ? v1::audioBufferMessage((*mGetNodeId)(),
+                                   TimedAudioBuffer{buffer, {*mCommitTime, *oSendTime}},
+                                   message.begin())
+          : v1::audioBufferMessage((*mGetNodeId)(), buffer, message.begin());
+      const auto numBytes = static_cast<size_t>(std::distance(message.begin(), end));
+      pending.packets[pending.numPending] = {message.data(), numBytes};
+      ++pending.numPending;
+
+      if (pending.parity.add(
+            buffer, message.data() + v1::kHeaderSize, numBytes - v1::kHeaderSize))
+      {
+        if (pending.numPending == kMaxNumPendingMessages)
+        {
+          flush(codec);
+        }
+
+        auto& parityMessage = pending.messages[pending.numPending];
+        const auto parityEnd = v1::audioParityMessage(
+          (*mGetNodeId)(), pending.parity.parity(), parityMessage.begin());
+        pending.packets[pending.numPending] = {
+          parityMessage.data(),
+          static_cast<size_t>(std::distance(parityMessage.begin(), parityEnd)),
+          true};
+        ++pending.numPending;
+      }
+    }
+
+    void flush(const Codec codec)
+    {
+      auto& pending = pendingMessages(codec);
+      if (pending.numPending > 0)
+      {
+        try
+        {
+          const auto result =
+            mReceivers.send(pending.packets.data(), pending.numPending, codec);
+          mpSink->addSentPackets(result.numPackets, result.numBytes);
+        }
+        catch (const std::runtime_error& err)
+        {
+          debug(mIo->log()) << "Failed to send message: " << err.what();
+        }
+        pending.numPending = 0;
+      }
+    }
+
+    PendingMessages& pendingMessages(const Codec codec)
+    {
+      assert(codec != Codec::kInvalid && codec <= mPending.size());
+      return mPending[codec - 1];
+    }
+
     const Id& id() const { return mpSink->id(); }
 
     std::string name() const { return mpSink->name(); }
 
     bool nameChanged() { return mpSink->nameChanged(); }
 
+    bool multicastChanged() { return mpSink->multicastChanged(); }
+
+    bool isMulticastEnabled() const { return mpSink->isMulticastEnabled(); }
+
     template <typename Request>
     void receiveChannelRequest(Request request, uint8_t ttl)
     {
       mReceivers.receiveChannelRequest(std::move(request), ttl);
 
       mpSink->setIsConnected(!mReceivers.empty());
+      mpSink->setNumReceivers(
+        mReceivers.numReceivers(), mReceivers.numMulticastReceivers());
     }
 
   private:
     util::Injected<IoContext> mIo;
     std::shared_ptr<Sink> mpSink;
-    Queue<Buffer<int16_t>>::Reader mQueueReader;
+    Queue<Sink::SinkBuffer>::Reader mQueueReader;
     Encoder<Sender, int16_t> mEncoder;
+    Encoder<Sender, int16_t, Codec::kLPC_i16> mLPCEncoder;
+    Encoder<Sender, int16_t, Codec::kADPCM_i4> mADPCMEncoder;
     Receivers<GetSender, IoContext> mReceivers;
     util::Injected<GetNodeId> mGetNodeId;
+    // One set of pending messages per codec, indexed by codec - 1
+    std::array<PendingMessages, 3> mPending;
+    // Commit time of the sink buffer that is being encoded
+    std::optional<std::chrono::microseconds> mCommitTime;
   };
 
   std::shared_ptr<Impl> mpImpl;
@@ -19,12 +19,17 @@
 
 #pragma once
 
+#include <ableton/link_audio/AudioBuffer.hpp>
 #include <ableton/link_audio/Buffer.hpp>
 #include <ableton/link_audio/Id.hpp>
+#include <ableton/link_audio/Latency.hpp>
+#include <ableton/link_audio/PlayoutBuffer.hpp>
 #include <ableton/link_audio/Queue.hpp>
-#include <ableton/util/Locked.hpp>
+#include <ableton/util/RcuSlot.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <memory>
 #include <optional>
 
 namespace ableton
@@ -34,33 +39,204 @@ namespace link_audio
 
 static constexpr auto kSourceQueueSize = std::chrono::milliseconds(10000);
 
+struct SourceStats
+{
+  uint64_t numPacketsReceived;
+  uint64_t numBytesReceived;
+  uint64_t numParityPacketsReceived;
+  uint64_t numRecoveredBuffers;
+  uint64_t numLostBuffers;
+  uint64_t numDroppedBuffers;
+  std::chrono::nanoseconds decodeTime;
+  std::chrono::microseconds maxBufferedTime;
+};
+
+// Latencies of the buffers received with timing, measured in the session's ghost time
+struct SourceLatencies
+{
+  LatencyHistogram::Counts commitToSend;
+  LatencyHistogram::Counts sendToReceive;
+  LatencyHistogram::Counts receiveToDeliver;
+  LatencyHistogram::Counts commitToDeliver;
+};
+
 struct Source
 {
   using Callback = std::function<void(BufferCallbackHandle<Buffer<int16_t>>)>;
 
-  Source(Id id, Callback callback)
+  // Sources without a callback write received audio to a playout buffer instead
+  Source(Id id, Callback callback, GetGhostTime getGhostTime = {})
     : mId(std::move(id))
+    , mpPlayoutBuffer(callback ? nullptr : std::make_unique<PlayoutBuffer>())
     , mCallback(std::move(callback))
+    , mGetGhostTime(std::move(getGhostTime))
   {
   }
 
   const Id& id() const { return mId; }
 
 
-  void setCallback(Callback newCallback)
+  // Doesn't block the receiving thread. Returns once the previous callback has
+  // finished its last invocation.
+  void setCallback(Callback newCallback) { mCallback.write(std::move(newCallback)); }
+
+  void callback(BufferCallbackHandle<Buffer<int16_t>> buffer)
   {
-    mCallback.update([newCallback_ = std::move(newCallback)](auto& callback)
-                     { callback = std::move(newCallback_); });
+    if (mpPlayoutBuffer)
+    {
+      mpPlayoutBuffer->write(buffer);
+    }
+    else
+    {
+      mCallback.read([&](const auto& callback) { callback(buffer); });
+    }
   }
 
-  void callback(BufferCallbackHandle<Buffer<int16_t>> buffer)
+  PlayoutBuffer* playoutBuffer() const { return mpPlayoutBuffer.get(); }
+
+  void setLowBandwidthEnabled(bool isEnabled)
+  {
+    if (mIsLowBandwidthEnabled.exchange(isEnabled) != isEnabled)
+    {
+      mCodecIsUpToDate.clear();
+    }
+  }
+
+  bool isLowBandwidthEnabled() const { return mIsLowBandwidthEnabled; }
+
+  void setLosslessCompressionEnabled(bool isEnabled)
+  {
+    if (mIsLosslessCompressionEnabled.exchange(isEnabled) != isEnabled)
+    {
+      mCodecIsUpToDate.clear();
+    }
+  }
+
+  bool isLosslessCompressionEnabled() const { return mIsLosslessCompressionEnabled; }
+
+  // PCM unless the application asks for less bandwidth
+  Codec preferredCodec() const
+  {
+    if (mIsLowBandwidthEnabled)
+    {
+      return Codec::kADPCM_i4;
+    }
+    return mIsLosslessCompressionEnabled ? Codec::kLPC_i16 : Codec::kPCM_i16;
+  }
+
+  bool codecChanged() { return !mCodecIsUpToDate.test_and_set(); }
+
+  void setLossConcealmentEnabled(bool isEnabled)
+  {
+    mIsLossConcealmentEnabled = isEnabled;
+  }
+
+  bool isLossConcealmentEnabled() const { return mIsLossConcealmentEnabled; }
+
+  void addLostBuffers(uint64_t numBuffers) { mNumLostBuffers += numBuffers; }
+
+  uint64_t numLostBuffers() const { return mNumLostBuffers; }
+
+  // Counters are written by the receiving thread, except for the buffered time of the
+  // playout buffer, and can be read from any thread. The snapshot is not consistent
+  // across counters.
+  SourceStats stats() const
+  {
+    return {mNumPacketsReceived,
+            mNumBytesReceived,
+            mNumParityPacketsReceived,
+            mNumRecoveredBuffers,
+            mNumLostBuffers,
+            mNumDroppedBuffers,
+            std::chrono::nanoseconds{mDecodeTimeNs},
+            mpPlayoutBuffer ? mpPlayoutBuffer->maxBufferedTime()
+                            : std::chrono::microseconds{0}};
+  }
+
+  void addReceivedPacket(const size_t numBytes, const bool isParity)
+  {
+    ++mNumPacketsReceived;
+    mNumBytesReceived += numBytes;
+    if (isParity)
+    {
+      ++mNumParityPacketsReceived;
+    }
+  }
+
+  void addRecoveredBuffer() { ++mNumRecoveredBuffers; }
+
+  void addDroppedBuffers(uint64_t numBuffers) { mNumDroppedBuffers += numBuffers; }
+
+  void addDecodeTime(const std::chrono::nanoseconds time)
+  {
+    mDecodeTimeNs += time.count();
+  }
+
+  bool measuresLatency() const { return static_cast<bool>(mGetGhostTime); }
+
+  // The session's ghost time if the source measures latency. Realtime safe.
+  std::optional<std::chrono::microseconds> ghostTime() const
+  {
+    return mGetGhostTime ? std::optional<std::chrono::microseconds>{mGetGhostTime()}
+                         : std::nullopt;
+  }
+
+  void addReceivedTiming(const AudioBufferTiming& timing,
+                         const std::chrono::microseconds receiveTime)
+  {
+    mCommitToSend.add(timing.sendTime - timing.commitTime);
+    mSendToReceive.add(receiveTime - timing.sendTime);
+  }
+
+  // Buffers written to the playout buffer count as delivered once they are written
+  void addDeliveredTiming(const AudioBufferTiming& timing,
+                          const std::chrono::microseconds receiveTime,
+                          const std::chrono::microseconds deliverTime)
+  {
+    mReceiveToDeliver.add(deliverTime - receiveTime);
+    mCommitToDeliver.add(deliverTime - timing.commitTime);
+  }
+
+  // Written by the receiving thread, can be read on the audio thread
+  void setRecommendedPlayoutLatency(const std::chrono::microseconds latency)
+  {
+    mRecommendedPlayoutLatencyMicros = latency.count();
+  }
+
+  std::chrono::microseconds recommendedPlayoutLatency() const
+  {
+    return std::chrono::microseconds{mRecommendedPlayoutLatencyMicros};
+  }
+
+  SourceLatencies latencies() const
   {
-    mCallback.update([&](auto& callback) { callback(buffer); });
+    return {mCommitToSend.counts(),
+            mSendToReceive.counts(),
+            mReceiveToDeliver.counts(),
+            mCommitToDeliver.counts()};
   }
 
 private:
   Id mId;
-  util::Locked<Callback> mCallback;
+  std::unique_ptr<PlayoutBuffer> mpPlayoutBuffer;
+  util::RcuSlot<Callback> mCallback;
+  std::atomic<bool> mIsLowBandwidthEnabled{false};
+  std::atomic<bool> mIsLosslessCompressionEnabled{false};
+  std::atomic_flag mCodecIsUpToDate = ATOMIC_FLAG_INIT;
+  std::atomic<bool> mIsLossConcealmentEnabled{false};
+  std::atomic<uint64_t> mNumLostBuffers{0};
+  std::atomic<uint64_t> mNumPacketsReceived{0};
+  std::atomic<uint64_t> mNumBytesReceived{0};
+  std::atomic<uint64_t> mNumParityPacketsReceived{0};
+  std::atomic<uint64_t> mNumRecoveredBuffers{0};
+  std::atomic<uint64_t> mNumDroppedBuffers{0};
+  std::atomic<int64_t> mDecodeTimeNs{0};
+  GetGhostTime mGetGhostTime;
+  LatencyHistogram mCommitToSend;
+  LatencyHistogram mSendToReceive;
+  LatencyHistogram mReceiveToDeliver;
+  LatencyHistogram mCommitToDeliver;
+  std::atomic<int64_t> mRecommendedPlayoutLatencyMicros{0};
 };
 
 } // namespace link_audio
@@ -19,21 +19,82 @@
 
 #pragma once
 
+#include <ableton/discovery/AsioTypes.hpp>
+#include <ableton/discovery/IpInterface.hpp>
 #include <ableton/link_audio/ChannelAnnouncements.hpp>
 #include <ableton/link_audio/ChannelRequests.hpp>
+#include <ableton/link_audio/Decoder.hpp>
 #include <ableton/link_audio/Id.hpp>
-#include <ableton/link_audio/PCMCodec.hpp>
+#include <ableton/link_audio/Parity.hpp>
+#include <ableton/link_audio/Sequencer.hpp>
 #include <ableton/link_audio/Source.hpp>
 #include <ableton/link_audio/v1/Messages.hpp>
 #include <ableton/util/Injected.hpp>
+#include <algorithm>
+#include <chrono>
 #include <optional>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace ableton
 {
 namespace link_audio
 {
 
+// Senders that know the multicast groups of channels allow receiving via multicast
+template <typename GetSender, typename = void>
+struct HasMulticastGroups : std::false_type
+{
+};
+
+template <typename GetSender>
+struct HasMulticastGroups<GetSender,
+                          std::void_t<decltype(std::declval<GetSender&>().multicastGroup(
+                            std::declval<const Id&>()))>> : std::true_type
+{
+};
+
+// Senders that know the network statistics of the peer sending a channel allow
+// recommending a playout latency before timed buffers arrive
+template <typename GetSender, typename = void>
+struct HasNetworkStats : std::false_type
+{
+};
+
+template <typename GetSender>
+struct HasNetworkStats<
+  GetSender,
+  std::void_t<decltype(std::declval<GetSender&>().channelNetworkStats(
+    std::declval<const Id&>()))>> : std::true_type
+{
+};
+
+// All sources of a channel share one stream. It is received with the codec of the
+// source that asks for the most exact audio: PCM if any source wants PCM, otherwise LPC
+// if any source wants lossless compression, and ADPCM only if all of them want low
+// bandwidth.
+template <typename Sources>
+Codec channelCodec(const Sources& sources)
+{
+  auto codec = Codec::kADPCM_i4;
+  for (const auto& pSource : sources)
+  {
+    const auto preferred = pSource->preferredCodec();
+    if (preferred == Codec::kPCM_i16)
+    {
+      return preferred;
+    }
+    if (preferred == Codec::kLPC_i16)
+    {
+      codec = preferred;
+    }
+  }
+  return codec;
+}
+
+// Receives a channel for all of its sources. Each buffer is decoded once and delivered
+// to every source.
 template <typename GetSender, typename GetNodeId, typename IoContext>
 struct SourceProcessor
 {
@@ -55,30 +116,55 @@ struct SourceProcessor
     if (mpImpl != nullptr)
     {
       mpImpl->sendChannelStopRequest();
+      mpImpl->leaveMulticastGroup();
     }
   }
 
+  // Add another source of the same channel
+  void addSource(std::shared_ptr<Source> pSource)
+  {
+    mpImpl->addSource(std::move(pSource));
+  }
+
+  // Returns false once all sources have been released
   bool process() { return mpImpl->process(); }
 
-  void receiveAudioBuffer(const AudioBuffer& buffer)
+  void receiveAudioBuffer(const AudioBufferView& buffer)
   {
     mpImpl->receiveAudioBuffer(buffer);
   }
 
+  void receiveAudioParity(const AudioParity& parity)
+  {
+    mpImpl->receiveAudioParity(parity);
+  }
+
+  // Renew the request for the channel
+  void sendAudioRequest() { mpImpl->sendAudioRequest(); }
+
+  // Whether the channel is received via its multicast group
+  bool isMulticastMember() const { return mpImpl->isMulticastMember(); }
+
   const Id& id() const { return mpImpl->id(); }
 
   struct Impl : public std::enable_shared_from_this<Impl>
   {
+    using GetSenderType = typename util::Injected<GetSender>::type;
+    using SendHandler = typename decltype(std::declval<GetSenderType&>().forChannel(
+      std::declval<const Id&>()))::value_type;
+
     Impl(util::Injected<IoContext> io,
          std::shared_ptr<Source> pSource,
          util::Injected<GetSender> getSender,
          util::Injected<GetNodeId> getNodeId)
       : mTimer(io->makeTimer())
-      , mpSource(pSource)
+      , mChannelId(pSource->id())
+      , mSources{std::move(pSource)}
       , mGetSender(std::move(getSender))
       , mGetNodeId(std::move(getNodeId))
       , mBuffer(4096 * 2)
-      , mDecoder(util::injectVal(Callback{this}), 4096)
+      , mSequencer(util::injectVal(Callback{this}), 4096)
+      , mDecoder(util::injectRef(mSequencer), 4096)
     {
     }
 
@@ -92,7 +178,7 @@ struct SourceProcessor
       const auto messageEnd = v1::detail::encodeMessage(
         (*mGetNodeId)(), ttl, messageType, payload, messageBegin);
       const auto numBytes = static_cast<size_t>(std::distance(messageBegin, messageEnd));
-      auto oSender = mGetSender->forChannel(mpSource->id());
+      auto oSender = mGetSender->forChannel(mChannelId);
       if (oSender)
       {
         try
@@ -105,6 +191,13 @@ struct SourceProcessor
       }
     }
 
+    void addSource(std::shared_ptr<Source> pSource)
+    {
+      mSources.push_back(std::move(pSource));
+      sendAudioRequest();
+    }
+
+    // One request covers the preferences of all sources
     void sendAudioRequest()
     {
       mTimer.expires_from_now(std::chrono::seconds(kTtl));
@@ -117,39 +210,319 @@ struct SourceProcessor
           }
         });
 
-      const auto request = ChannelRequest{(*mGetNodeId)(), mpSource->id()};
+      forEachSource([](Source& source) { source.codecChanged(); });
+      const auto codec = channelCodec(mSources);
+
+      // Every codec is encoded with counts of its own
+      if (codec != mCodec)
+      {
+        mParityDecoder.reset();
+        mSequencer.reset();
+        mCodec = codec;
+      }
+
+      const auto measuresLatency =
+        std::any_of(mSources.begin(),
+                    mSources.end(),
+                    [](const auto& pSource) { return pSource->measuresLatency(); });
+      const auto request = ChannelRequest{(*mGetNodeId)(),
+                                          mChannelId,
+                                          updateMulticastMembership(),
+                                          codec,
+                                          true,
+                                          measuresLatency};
       sendMessage(toPayload(request), v1::kChannelRequest, kTtl);
+      updateNetworkPlayoutLatency();
+    }
+
+    // Until timed buffers arrive, the latency is estimated from the round trip times to
+    // the sending peer. This doesn't include the buffering of the sender.
+    void updateNetworkPlayoutLatency()
+    {
+      if constexpr (HasNetworkStats<GetSenderType>::value)
+      {
+        if (mDelayEstimator.numSamples() == 0)
+        {
+          if (const auto oStats = mGetSender->channelNetworkStats(mChannelId))
+          {
+            setRecommendedPlayoutLatency(oStats->roundTripTime / 2 + 2 * oStats->jitter
+                                         + mHoldTime);
+          }
+        }
+      }
+    }
+
+    // Join the multicast group of the channel if its sink announces one. The membership
+    // follows changes of the group and of the interface the channel is reached on.
+    // Returns the group the channel is received from.
+    std::optional<discovery::UdpEndpoint> updateMulticastMembership()
+    {
+      if constexpr (HasMulticastGroups<GetSenderType>::value)
+      {
+        const auto oGroup = mGetSender->multicastGroup(mChannelId);
+        auto oSender = mGetSender->forChannel(mChannelId);
+
+        if (mMembership
+            && (!oGroup || !oSender || mMembership->group != *oGroup
+                || mMembership->sender.interface() != oSender->interface()))
+        {
+          leaveMulticastGroup();
+        }
+
+        if (!mMembership && oGroup && oSender && oSender->joinMulticastGroup(*oGroup))
+        {
+          mMembership = Membership{std::move(*oSender), *oGroup};
+        }
+
+        if (mMembership)
+        {
+          return mMembership->group;
+        }
+      }
+      return std::nullopt;
+    }
+
+    void leaveMulticastGroup()
+    {
+      if constexpr (HasMulticastGroups<GetSenderType>::value)
+      {
+        if (mMembership)
+        {
+          mMembership->sender.leaveMulticastGroup(mMembership->group);
+          mMembership = std::nullopt;
+        }
+      }
     }
 
     void sendChannelStopRequest()
     {
-      const auto stopRequest = ChannelStopRequest{(*mGetNodeId)(), mpSource->id()};
+      const auto stopRequest = ChannelStopRequest{(*mGetNodeId)(), mChannelId};
       sendMessage(toPayload(stopRequest), v1::kStopChannelRequest, 0);
     }
 
-    bool process() { return mpSource.use_count() > 1; }
+    bool process()
+    {
+      const auto numSources = mSources.size();
+      mSources.erase(std::remove_if(mSources.begin(),
+                                    mSources.end(),
+                                    [](const auto& pSource)
+                                    { return pSource.use_count() <= 1; }),
+                     mSources.end());
+      if (mSources.empty())
+      {
+        return false;
+      }
 
-    void receiveAudioBuffer(const AudioBuffer& buffer) { mDecoder(buffer); }
+      // The preferences of the remaining sources may differ from the requested ones
+      auto codecChanged = mSources.size() < numSources;
+      forEachSource([&](Source& source) { codecChanged |= source.codecChanged(); });
+      if (codecChanged)
+      {
+        sendAudioRequest();
+      }
 
-    const Id& id() const { return mpSource->id(); }
+      // Chunks held back for a stream that stalled are passed on
+      if (!mHasReceived)
+      {
+        mSequencer.flush();
+      }
+      mHasReceived = false;
+
+      return true;
+    }
+
+    void receiveAudioBuffer(const AudioBufferView& buffer)
+    {
+      mReceiveTime = ghostTime();
+      mHasReceived = true;
+      forEachSource([&](Source& source)
+                    { source.addReceivedPacket(buffer.numBytes, false); });
+      mParityDecoder.receive(buffer);
+      decode(buffer);
+    }
+
+    void receiveAudioParity(const AudioParity& parity)
+    {
+      mReceiveTime = ghostTime();
+      mHasReceived = true;
+      forEachSource([&](Source& source)
+                    { source.addReceivedPacket(parity.numBytes, true); });
+      if (const auto pBuffer = mParityDecoder.recover(parity))
+      {
+        forEachSource([](Source& source) { source.addRecoveredBuffer(); });
+        decode(*pBuffer);
+      }
+    }
+
+    bool isMulticastMember() const { return mMembership.has_value(); }
+
+    const Id& id() const { return mChannelId; }
 
   private:
+    template <typename Function>
+    void forEachSource(Function function)
+    {
+      for (const auto& pSource : mSources)
+      {
+        function(*pSource);
+      }
+    }
+
+    // Sources measure latency in the ghost time of the same session
+    std::optional<std::chrono::microseconds> ghostTime() const
+    {
+      for (const auto& pSource : mSources)
+      {
+        if (const auto oGhostTime = pSource->ghostTime())
+        {
+          return oGhostTime;
+        }
+      }
+      return std::nullopt;
+    }
+
+    void setRecommendedPlayoutLatency(const std::chrono::microseconds latency)
+    {
+      forEachSource([&](Source& source)
+                    { source.setRecommendedPlayoutLatency(latency); });
+    }
+
+    // The time spent in the sources' callbacks doesn't count as decoding time. A timed
+    // buffer is delivered with the first callback while it is decoded. Buffers that
+    // the sequencer holds back to reorder them are not timed when they are delivered.
+    void decode(const AudioBufferView& buffer)
+    {
+      const auto begin = std::chrono::steady_clock::now();
+      const auto numDropped = mSequencer.numDroppedBuffers();
+      mCallbackTime = std::chrono::nanoseconds{0};
+
+      // A missing buffer is waited for about as long as it takes to receive the next
+      // one, or the rest of its group if it can be rebuilt from parity
+      mHoldTime = duration(buffer) * std::max(mParityDecoder.groupSize(), uint32_t{1});
+      mSequencer.setMaxHoldTime(mHoldTime);
+
+      if (buffer.timing && mReceiveTime)
+      {
+        forEachSource(
+          [&](Source& source)
+          {
+            if (source.measuresLatency())
+            {
+              source.addReceivedTiming(*buffer.timing, *mReceiveTime);
+            }
+          });
+        mDeliveryTiming = buffer.timing;
+        updatePlayoutLatency(buffer, *buffer.timing, *mReceiveTime);
+      }
+
+      // Concealed buffers are only delivered to the sources that enabled concealment
+      mSequencer.setConcealmentEnabled(std::any_of(
+        mSources.begin(),
+        mSources.end(),
+        [](const auto& pSource) { return pSource->isLossConcealmentEnabled(); }));
+      mDecoder(buffer);
+      mDeliveryTiming = std::nullopt;
+
+      const auto numDroppedNow = mSequencer.numDroppedBuffers() - numDropped;
+      const auto decodeTime = std::chrono::steady_clock::now() - begin - mCallbackTime;
+      forEachSource(
+        [&](Source& source)
+        {
+          source.addDroppedBuffers(numDroppedNow);
+          source.addDecodeTime(decodeTime);
+        });
+    }
+
+    static std::chrono::microseconds duration(const AudioBufferView& buffer)
+    {
+      auto numFrames = uint64_t{0};
+      for (const auto& chunk : buffer.chunks)
+      {
+        numFrames += chunk.numFrames;
+      }
+      return buffer.sampleRate > 0
+               ? std::chrono::microseconds{static_cast<int64_t>(numFrames * 1000000u
+                                                                / buffer.sampleRate)}
+               : std::chrono::microseconds{0};
+    }
+
+    // Audio for a beat is committed about when the session reaches it. A buffer is
+    // timed by its last commit, so its first frames may have been committed up to its
+    // duration earlier. Buffers held back to wait for a missing one arrive later.
+    void updatePlayoutLatency(const AudioBufferView& buffer,
+                              const AudioBufferTiming& timing,
+                              const std::chrono::microseconds receiveTime)
+    {
+      mDelayEstimator(receiveTime - timing.commitTime + duration(buffer));
+      setRecommendedPlayoutLatency(mDelayEstimator.playoutDelay() + mHoldTime);
+    }
+
     struct Callback
     {
       void operator()(BufferCallbackHandle<Buffer<int16_t>> buffer)
       {
-        pImpl->mpSource->callback(buffer);
+        if (pImpl->mDeliveryTiming)
+        {
+          if (const auto oDeliverTime = pImpl->ghostTime())
+          {
+            pImpl->forEachSource(
+              [&](Source& source)
+              {
+                if (source.measuresLatency())
+                {
+                  source.addDeliveredTiming(
+                    *pImpl->mDeliveryTiming, *pImpl->mReceiveTime, *oDeliverTime);
+                }
+              });
+          }
+          pImpl->mDeliveryTiming = std::nullopt;
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        pImpl->forEachSource(
+          [&](Source& source)
+          {
+            if (!buffer.mBuffer.mIsConcealed || source.isLossConcealmentEnabled())
+            {
+              source.callback(buffer);
+            }
+          });
+        pImpl->mCallbackTime += std::chrono::steady_clock::now() - begin;
+      }
+
+      void lost(const uint64_t numBuffers)
+      {
+        pImpl->forEachSource([&](Source& source) { source.addLostBuffers(numBuffers); });
       }
 
       Impl* pImpl;
     };
 
+    struct Membership
+    {
+      SendHandler sender;
+      discovery::UdpEndpoint group;
+    };
+
     Timer mTimer;
-    std::shared_ptr<Source> mpSource;
+    Id mChannelId;
+    std::vector<std::shared_ptr<Source>> mSources;
     util::Injected<GetSender> mGetSender;
     util::Injected<GetNodeId> mGetNodeId;
     Buffer<int16_t> mBuffer;
-    PCMDecoder<int16_t, Callback> mDecoder;
+    Sequencer<Callback> mSequencer;
+    Decoder<Sequencer<Callback>&> mDecoder;
+    ParityDecoder mParityDecoder;
+    Codec mCodec = Codec::kPCM_i16;
+    std::chrono::microseconds mHoldTime{0};
+    bool mHasReceived = false;
+    std::optional<Membership> mMembership;
+    std::chrono::nanoseconds mCallbackTime{0};
+    // Ghost time at which the last packet was received, if a source measures latency
+    std::optional<std::chrono::microseconds> mReceiveTime;
+    // Timing of the buffer that is being decoded until it is delivered
+    std::optional<AudioBufferTiming> mDeliveryTiming;
+    DelayEstimator mDelayEstimator;
   };
 
   std::shared_ptr<Impl> mpImpl;
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <ableton/discovery/AsioTypes.hpp>
+#include <ableton/discovery/IpInterface.hpp>
 #include <ableton/discovery/UdpMessenger.hpp>
 #include <ableton/discovery/UnicastIpInterface.hpp>
 #include <ableton/link/PayloadEntries.hpp>
@@ -33,6 +34,7 @@
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 namespace ableton
@@ -40,6 +42,20 @@ namespace ableton
 namespace link_audio
 {
 
+// Interfaces that can join multicast groups also receive audio buffers sent to them
+template <typename Interface, typename = void>
+struct SupportsMulticast : std::false_type
+{
+};
+
+template <typename Interface>
+struct SupportsMulticast<
+  Interface,
+  std::void_t<decltype(std::declval<Interface&>().joinMulticastGroup(
+    std::declval<const discovery::UdpEndpoint&>()))>> : std::true_type
+{
+};
+
 // Throws UdpSendException
 template <typename Interface, typename NodeId, typename Payload>
 void sendLinkAudioUdpMessage(Interface& iface,
@@ -92,6 +108,7 @@ public:
     SharedInterface pInterface;
     discovery::UdpEndpoint from;
     int ttl;
+    NetworkMetricsFilter::Stats networkStats;
   };
 
   UdpMessenger(util::Injected<ChannelsMessageHandler> handler,
@@ -112,6 +129,10 @@ public:
     // We need to always listen for incoming traffic in order to
     // respond to announcement broadcasts
     mpImpl->listen();
+    if constexpr (SupportsMulticast<Interface>::value)
+    {
+      mpImpl->listen(discovery::MulticastTag{});
+    }
     mpImpl->broadcastAnnouncement();
   }
 
@@ -272,7 +293,12 @@ private:
 
       for (const auto& channel : announcement.channels.channels)
       {
-        const auto channelSize = sizeInByteStream(channel);
+        auto channelSize = sizeInByteStream(channel);
+        if (channel.multicastGroup)
+        {
+          channelSize += sizeInByteStream(
+            ChannelMulticastGroups{{{channel.id, *channel.multicastGroup}}});
+        }
         // A ping is sent along with the first announcement
         auto addedSize =
           mAnnouncements.size() == 1 ? channelSize + pingSize : channelSize;
@@ -364,6 +390,42 @@ private:
 
     void listen() { mpInterface->receive(util::makeAsyncSafe(this->shared_from_this())); }
 
+    void listen(discovery::MulticastTag tag)
+    {
+      mpInterface->receive(util::makeAsyncSafe(this->shared_from_this()), tag);
+    }
+
+    // Only audio buffers and their parity are sent to multicast groups
+    template <typename It>
+    void operator()(discovery::MulticastTag tag,
+                    const discovery::UdpEndpoint&,
+                    const It messageBegin,
+                    const It messageEnd)
+    {
+      auto result = v1::parseMessageHeader(messageBegin, messageEnd);
+
+      const auto& header = result.first;
+      if (header.ident != mAnnouncements.front().ident() && header.groupId == 0)
+      {
+        try
+        {
+          if (header.messageType == v1::kAudioBuffer)
+          {
+            mChannelsMessageHandler->receiveAudioBuffer(result.second, messageEnd, tag);
+          }
+          else if (header.messageType == v1::kAudioParity)
+          {
+            mChannelsMessageHandler->receiveAudioParity(result.second, messageEnd, tag);
+          }
+        }
+        catch (const std::runtime_error& err)
+        {
+          info(mIo->log()) << "Ignoring multicast audio message: " << err.what();
+        }
+      }
+      listen(tag);
+    }
+
     template <typename It>
     void operator()(const discovery::UdpEndpoint& from,
                     const It messageBegin,
@@ -400,6 +462,9 @@ private:
         case v1::kAudioBuffer:
           receiveAudioBuffer(std::move(result.first), result.second, messageEnd);
           break;
+        case v1::kAudioParity:
+          receiveAudioParity(std::move(result.first), result.second, messageEnd);
+          break;
         default:
           info(mIo->log()) << "Unknown message received of type: " << header.messageType;
         }
@@ -486,7 +551,8 @@ private:
                                                it->metricsFilter.metrics().quality(),
                                                mpInterface,
                                                from,
-                                               mTtl});
+                                               mTtl,
+                                               it->metricsFilter.stats()});
         }
         catch (const std::runtime_error& err)
         {
@@ -556,6 +622,19 @@ private:
       }
     }
 
+    template <typename It>
+    void receiveAudioParity(v1::MessageHeader, It payloadBegin, It payloadEnd)
+    {
+      try
+      {
+        mChannelsMessageHandler->receiveAudioParity(payloadBegin, payloadEnd);
+      }
+      catch (const std::runtime_error& err)
+      {
+        info(mIo->log()) << "Ignoring AudioParity message: " << err.what();
+      }
+    }
+
     util::Injected<IoContext> mIo;
     util::Injected<ChannelsMessageHandler> mChannelsMessageHandler;
     SharedInterface mpInterface;
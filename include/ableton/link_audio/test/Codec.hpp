@@ -0,0 +1,99 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <ableton/link_audio/AudioBuffer.hpp>
+#include <ableton/link_audio/Buffer.hpp>
+#include <cmath>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace test
+{
+
+using Samples = std::vector<int16_t>;
+
+// Each channel is a sine with a different frequency
+inline Samples sine(const uint32_t numFrames, const uint32_t numChannels)
+{
+  auto samples = Samples(numFrames * numChannels);
+  for (auto i = 0u; i < numFrames; ++i)
+  {
+    for (auto channel = 0u; channel < numChannels; ++channel)
+    {
+      samples[i * numChannels + channel] = static_cast<int16_t>(
+        20000. * std::sin(0.01 * (channel + 1) * static_cast<double>(i)));
+    }
+  }
+  return samples;
+}
+
+// Encodes the input into at most maxNumBytes and decodes it again. The number of encoded
+// bytes is zero if the input doesn't fit.
+template <typename Encode, typename Decode>
+Samples roundtrip(const Samples& input,
+                  const uint32_t numChannels,
+                  const size_t maxNumBytes,
+                  Encode encode,
+                  Decode decode,
+                  size_t* pNumBytes)
+{
+  const auto numFrames = static_cast<uint32_t>(input.size() / numChannels);
+  auto bytes = std::vector<uint8_t>(maxNumBytes);
+  const auto end =
+    encode(input.data(), numFrames, numChannels, bytes.data(), bytes.data() + maxNumBytes);
+  *pNumBytes = end ? static_cast<size_t>(end - bytes.data()) : 0;
+
+  auto output = Samples(input.size());
+  if (end)
+  {
+    decode(bytes.data(), end, numFrames, numChannels, output.data());
+  }
+  return output;
+}
+
+struct Sender
+{
+  void operator()(const AudioBuffer& buffer) { buffers.push_back(buffer); }
+
+  std::vector<AudioBuffer> buffers;
+};
+
+struct Successor
+{
+  void operator()(BufferCallbackHandle<Buffer<int16_t>> handle)
+  {
+    const auto numSamples = handle.mBuffer.mNumFrames * handle.mBuffer.mNumChannels;
+    samples.insert(samples.end(), handle.mpSamples, handle.mpSamples + numSamples);
+    counts.push_back(handle.mBuffer.mCount);
+    beginBeats.push_back(handle.mBuffer.mBeginBeats);
+  }
+
+  Samples samples;
+  std::vector<uint64_t> counts;
+  std::vector<Beats> beginBeats;
+};
+
+} // namespace test
+} // namespace link_audio
+} // namespace ableton
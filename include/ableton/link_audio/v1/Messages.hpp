@@ -39,6 +39,13 @@ static constexpr std::size_t kMaxMessageSize = 1200;
 static constexpr std::size_t kHeaderSize = 24;
 static constexpr std::size_t kMaxPayloadSize = kMaxMessageSize - kHeaderSize;
 static constexpr std::size_t kMaxNameSize = 256;
+// Audio buffers carry all channels of a sink in one message. With this many channels
+// about eight frames fit into an audio buffer message of the maximum size.
+static constexpr std::size_t kMaxNumChannels = 64;
+// Audio buffer messages are limited to this size unless a sink is configured to use
+// larger messages or has many channels. We take RFC 791 as a reference: nodes must be
+// able to process IP messages of at least 576 bytes.
+static constexpr std::size_t kDefaultMaxAudioBufferMessageSize = 576;
 // Utility typedef for an array of bytes of maximum message size
 using MessageBuffer = std::array<uint8_t, v1::kMaxMessageSize>;
 
@@ -52,6 +59,7 @@ const MessageType kPong = 3;
 const MessageType kChannelRequest = 4;
 const MessageType kStopChannelRequest = 5;
 const MessageType kAudioBuffer = 6;
+const MessageType kAudioParity = 7;
 
 struct MessageHeader
 {
@@ -142,6 +150,12 @@ It audioBufferMessage(link::NodeId from, const Payload& payload, It out)
   return detail::encodeMessage(std::move(from), 0, kAudioBuffer, payload, std::move(out));
 }
 
+template <typename Payload, typename It>
+It audioParityMessage(link::NodeId from, const Payload& payload, It out)
+{
+  return detail::encodeMessage(std::move(from), 0, kAudioParity, payload, std::move(out));
+}
+
 template <typename It>
 std::pair<MessageHeader, It> parseMessageHeader(It bytesBegin, const It bytesEnd)
 {
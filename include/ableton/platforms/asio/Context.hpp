@@ -24,6 +24,7 @@
 #include <ableton/platforms/asio/LockFreeCallbackDispatcher.hpp>
 #include <ableton/platforms/asio/Socket.hpp>
 #include <memory>
+#include <string>
 #include <thread>
 #include <utility>
 
@@ -75,11 +76,17 @@ public:
 
   template <typename ExceptionHandler>
   explicit Context(ExceptionHandler exceptHandler)
+    : Context(std::move(exceptHandler), "Link Main")
+  {
+  }
+
+  template <typename ExceptionHandler>
+  Context(ExceptionHandler exceptHandler, std::string threadName)
     : mpService(new IoService())
     , mpWork(new Work(mpService->get_executor()))
   {
     mThread = ThreadFactoryT::makeThread(
-      "Link Main",
+      std::move(threadName),
       [](IoService& service, ExceptionHandler handler)
       {
         for (;;)
@@ -217,6 +224,38 @@ public:
     return socket;
   }
 
+  // Open a socket that receives from IPv4 multicast groups on the given port. Groups
+  // are joined on the socket afterwards.
+  template <std::size_t BufferSize>
+  Socket<BufferSize> openMulticastGroupSocket(const discovery::IpAddress& addr,
+                                              const uint16_t port)
+  {
+    if (!addr.is_v4())
+    {
+      throw(std::runtime_error("Multicast groups are only supported for IPv4"));
+    }
+
+    auto socket = Socket<BufferSize>{*mpService, ::LINK_ASIO_NAMESPACE::ip::udp::v4()};
+    socket.mpImpl->mSocket.set_option(
+      ::LINK_ASIO_NAMESPACE::ip::udp::socket::reuse_address(true));
+    socket.mpImpl->mSocket.set_option(
+      ::LINK_ASIO_NAMESPACE::ip::multicast::enable_loopback(addr.is_loopback()));
+#if defined(__linux__) && defined(IP_MULTICAST_ALL)
+    const int disableAll = 0;
+    if (::setsockopt(socket.mpImpl->mSocket.native_handle(),
+                     IPPROTO_IP,
+                     IP_MULTICAST_ALL,
+                     &disableAll,
+                     sizeof(disableAll))
+        != 0)
+    {
+      throw std::runtime_error("Failed to set IP_MULTICAST_ALL");
+    }
+#endif
+    socket.mpImpl->mSocket.bind({::LINK_ASIO_NAMESPACE::ip::address_v4::any(), port});
+    return socket;
+  }
+
   std::vector<discovery::IpAddress> scanNetworkInterfaces() { return mScanIpIfAddrs(); }
 
   Timer makeTimer() const { return {*mpService}; }
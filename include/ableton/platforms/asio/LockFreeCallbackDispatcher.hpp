@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <mutex>
 #include <thread>
 
 namespace ableton
@@ -36,7 +37,8 @@ namespace LINK_ASIO_NAMESPACE
 // A condition variable is used to notify a waiting thread, but only if the required
 // lock can be acquired immediately. If that fails, we fall back on signaling
 // after a timeout. This gives us a guaranteed minimum signaling rate which is defined
-// by the fallbackPeriod parameter.
+// by the fallbackPeriod parameter. Invocations are flagged before notifying, so one that
+// arrives while the callback runs is dispatched right after it instead of being lost.
 
 template <typename Callback, typename Duration, typename ThreadFactory>
 class LockFreeCallbackDispatcher
@@ -71,7 +73,15 @@ public:
     }
   }
 
-  void invoke() { mCondition.notify_one(); }
+  void invoke()
+  {
+    mIsInvoked = true;
+    if (mMutex.try_lock())
+    {
+      mCondition.notify_one();
+      mMutex.unlock();
+    }
+  }
 
 private:
   void run()
@@ -80,7 +90,10 @@ private:
     {
       {
         std::unique_lock<std::mutex> lock(mMutex);
-        mCondition.wait_for(lock, mFallbackPeriod);
+        mCondition.wait_for(lock,
+                            mFallbackPeriod,
+                            [this] { return mIsInvoked.load() || !mRunning.load(); });
+        mIsInvoked = false;
       }
 
       if (!mRunning.load())
@@ -95,6 +108,7 @@ private:
   Callback mCallback;
   Duration mFallbackPeriod;
   std::atomic<bool> mRunning;
+  std::atomic<bool> mIsInvoked{false};
   std::mutex mMutex;
   std::condition_variable mCondition;
   std::thread mThread;
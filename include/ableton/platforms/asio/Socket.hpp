@@ -21,8 +21,16 @@
 
 #include <ableton/discovery/AsioTypes.hpp>
 #include <ableton/util/SafeAsyncHandler.hpp>
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <functional>
+#include <memory>
+
+#if defined(LINK_PLATFORM_LINUX)
+#include <cerrno>
+#include <sys/socket.h>
+#endif
 
 namespace ableton
 {
@@ -55,20 +63,104 @@ struct Socket
     return mpImpl->mSocket.send_to(::LINK_ASIO_NAMESPACE::buffer(pData, numBytes), to);
   }
 
+  // Send several datagrams with as few system calls as possible. On Linux batches are
+  // passed to sendmmsg, on other platforms every datagram is sent with send_to.
+  // Datagrams that fail to send are skipped. Returns the number of datagrams sent.
+  std::size_t send(const discovery::UdpDatagram* pDatagrams, const size_t numDatagrams)
+  {
+    auto numSent = size_t{0};
+#if defined(LINK_PLATFORM_LINUX)
+    constexpr auto kMaxBatchSize = size_t{64};
+    std::array<::mmsghdr, kMaxBatchSize> messages;
+    std::array<::iovec, kMaxBatchSize> iovecs;
+
+    auto i = size_t{0};
+    while (i < numDatagrams)
+    {
+      const auto batchSize = std::min(numDatagrams - i, kMaxBatchSize);
+      for (auto j = size_t{0}; j < batchSize; ++j)
+      {
+        const auto& datagram = pDatagrams[i + j];
+        assert(datagram.numBytes <= MaxPacketSize);
+        iovecs[j].iov_base = const_cast<uint8_t*>(datagram.pData);
+        iovecs[j].iov_len = datagram.numBytes;
+        messages[j] = {};
+        messages[j].msg_hdr.msg_name = const_cast<::sockaddr*>(datagram.to.data());
+        messages[j].msg_hdr.msg_namelen = static_cast<::socklen_t>(datagram.to.size());
+        messages[j].msg_hdr.msg_iov = &iovecs[j];
+        messages[j].msg_hdr.msg_iovlen = 1;
+      }
+
+      const auto result = ::sendmmsg(mpImpl->mSocket.native_handle(),
+                                     messages.data(),
+                                     static_cast<unsigned int>(batchSize),
+                                     0);
+      if (result > 0)
+      {
+        numSent += static_cast<size_t>(result);
+        i += static_cast<size_t>(result);
+      }
+      else if (result < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      else
+      {
+        // Let asio deal with a full send buffer and with errors of the first datagram
+        numSent += mpImpl->sendOrSkip(pDatagrams[i]);
+        ++i;
+      }
+    }
+#else
+    for (auto i = size_t{0}; i < numDatagrams; ++i)
+    {
+      numSent += mpImpl->sendOrSkip(pDatagrams[i]);
+    }
+#endif
+    return numSent;
+  }
+
+  // Receive the next datagram. When it arrives, datagrams that are already queued in the
+  // socket are delivered in the same wakeup, as long as the handler keeps calling
+  // receive.
   template <typename Handler>
   void receive(Handler handler)
   {
     mpImpl->mHandler = std::move(handler);
-    mpImpl->mSocket.async_receive_from(
-      ::LINK_ASIO_NAMESPACE::buffer(mpImpl->mReceiveBuffer, MaxPacketSize),
-      mpImpl->mSenderEndpoint,
-      util::makeAsyncSafe(mpImpl));
+    if (mpImpl->mIsDraining)
+    {
+      mpImpl->mIsReceiveRequested = true;
+    }
+    else
+    {
+      mpImpl->asyncReceive();
+    }
   }
 
   discovery::UdpEndpoint endpoint() const { return mpImpl->mSocket.local_endpoint(); }
 
-  struct Impl
+  // Throws if the membership can't be changed
+  void joinMulticastGroup(const discovery::IpAddress& group,
+                          const discovery::IpAddress& interfaceAddr)
   {
+    mpImpl->mSocket.set_option(::LINK_ASIO_NAMESPACE::ip::multicast::join_group(
+      group.to_v4(), interfaceAddr.to_v4()));
+  }
+
+  void leaveMulticastGroup(const discovery::IpAddress& group,
+                           const discovery::IpAddress& interfaceAddr)
+  {
+    mpImpl->mSocket.set_option(::LINK_ASIO_NAMESPACE::ip::multicast::leave_group(
+      group.to_v4(), interfaceAddr.to_v4()));
+  }
+
+  struct Impl : std::enable_shared_from_this<Impl>
+  {
+    // Maximum number of queued datagrams read at once after a wakeup
+    static constexpr std::size_t kMaxBatchSize = 16;
+    // Maximum number of datagrams delivered per wakeup
+    static constexpr std::size_t kMaxNumDrainedDatagrams = 64;
+
     Impl(::LINK_ASIO_NAMESPACE::io_context& io, ::LINK_ASIO_NAMESPACE::ip::udp protocol)
       : mSocket(io, protocol)
     {
@@ -83,20 +175,148 @@ struct Socket
       mSocket.close(ec);
     }
 
+    std::size_t sendOrSkip(const discovery::UdpDatagram& datagram)
+    {
+      ::LINK_ASIO_NAMESPACE::error_code ec;
+      mSocket.send_to(::LINK_ASIO_NAMESPACE::buffer(datagram.pData, datagram.numBytes),
+                      datagram.to,
+                      0,
+                      ec);
+      return ec ? 0 : 1;
+    }
+
+    void asyncReceive()
+    {
+      mSocket.async_receive_from(
+        ::LINK_ASIO_NAMESPACE::buffer(mReceiveBuffer, MaxPacketSize),
+        mSenderEndpoint,
+        util::makeAsyncSafe(this->shared_from_this()));
+    }
+
     void operator()(const ::LINK_ASIO_NAMESPACE::error_code& error,
                     const std::size_t numBytes)
     {
       if (!error && numBytes > 0 && numBytes <= MaxPacketSize)
       {
-        const auto bufBegin = begin(mReceiveBuffer);
-        mHandler(mSenderEndpoint, bufBegin, bufBegin + static_cast<ptrdiff_t>(numBytes));
+        // Calls to receive from the handler are deferred until the queued datagrams
+        // have been delivered
+        mIsDraining = true;
+        mIsReceiveRequested = false;
+        try
+        {
+          const auto bufBegin = begin(mReceiveBuffer);
+          mHandler(
+            mSenderEndpoint, bufBegin, bufBegin + static_cast<ptrdiff_t>(numBytes));
+          drain();
+        }
+        catch (...)
+        {
+          mIsDraining = false;
+          throw;
+        }
+        mIsDraining = false;
+
+        if (mIsReceiveRequested)
+        {
+          mIsReceiveRequested = false;
+          asyncReceive();
+        }
+      }
+    }
+
+    void drain()
+    {
+      auto numDelivered = std::size_t{1};
+      while (mIsReceiveRequested && numDelivered < kMaxNumDrainedDatagrams)
+      {
+        const auto numReceived = receiveQueued();
+        if (numReceived == 0)
+        {
+          break;
+        }
+
+        // Datagrams that arrive after the handler stopped receiving are dropped
+        for (auto i = std::size_t{0}; i < numReceived && mIsReceiveRequested; ++i)
+        {
+          if (mBatchSizes[i] > 0)
+          {
+            mIsReceiveRequested = false;
+            const auto bufBegin = begin(mBatchBuffers[i]);
+            mHandler(mBatchEndpoints[i],
+                     bufBegin,
+                     bufBegin + static_cast<ptrdiff_t>(mBatchSizes[i]));
+          }
+        }
+        numDelivered += numReceived;
+      }
+    }
+
+    // Read datagrams that are queued in the socket without blocking. Truncated
+    // datagrams are reported with a size of zero.
+    std::size_t receiveQueued()
+    {
+#if defined(LINK_PLATFORM_LINUX)
+      std::array<::mmsghdr, kMaxBatchSize> messages;
+      std::array<::iovec, kMaxBatchSize> iovecs;
+      for (auto i = std::size_t{0}; i < kMaxBatchSize; ++i)
+      {
+        iovecs[i].iov_base = mBatchBuffers[i].data();
+        iovecs[i].iov_len = MaxPacketSize;
+        messages[i] = {};
+        messages[i].msg_hdr.msg_name = mBatchEndpoints[i].data();
+        messages[i].msg_hdr.msg_namelen =
+          static_cast<::socklen_t>(mBatchEndpoints[i].capacity());
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      const auto result = ::recvmmsg(mSocket.native_handle(),
+                                     messages.data(),
+                                     static_cast<unsigned int>(kMaxBatchSize),
+                                     MSG_DONTWAIT,
+                                     nullptr);
+      if (result <= 0)
+      {
+        return 0;
+      }
+
+      const auto numReceived = static_cast<std::size_t>(result);
+      for (auto i = std::size_t{0}; i < numReceived; ++i)
+      {
+        const auto& header = messages[i].msg_hdr;
+        mBatchEndpoints[i].resize(header.msg_namelen);
+        mBatchSizes[i] = (header.msg_flags & MSG_TRUNC) ? 0 : messages[i].msg_len;
+      }
+      return numReceived;
+#else
+      auto numReceived = std::size_t{0};
+      ::LINK_ASIO_NAMESPACE::error_code ec;
+      while (numReceived < kMaxBatchSize && mSocket.available(ec) > 0 && !ec)
+      {
+        mBatchSizes[numReceived] =
+          mSocket.receive_from(::LINK_ASIO_NAMESPACE::buffer(mBatchBuffers[numReceived]),
+                               mBatchEndpoints[numReceived],
+                               0,
+                               ec);
+        if (ec)
+        {
+          break;
+        }
+        ++numReceived;
       }
+      return numReceived;
+#endif
     }
 
     discovery::UdpSocket mSocket;
     discovery::UdpEndpoint mSenderEndpoint;
     using Buffer = std::array<uint8_t, MaxPacketSize>;
     Buffer mReceiveBuffer;
+    std::array<Buffer, kMaxBatchSize> mBatchBuffers;
+    std::array<discovery::UdpEndpoint, kMaxBatchSize> mBatchEndpoints;
+    std::array<std::size_t, kMaxBatchSize> mBatchSizes;
+    bool mIsDraining = false;
+    bool mIsReceiveRequested = false;
     using ByteIt = typename Buffer::const_iterator;
     std::function<void(const discovery::UdpEndpoint&, ByteIt, ByteIt)> mHandler;
   };
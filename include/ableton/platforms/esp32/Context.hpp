@@ -26,6 +26,7 @@
 #include <ableton/platforms/esp32/LockFreeCallbackDispatcher.hpp>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <string>
 
 namespace ableton
 {
@@ -108,6 +109,12 @@ public:
   {
   }
 
+  // All contexts share the same task, the name is ignored
+  template <typename ExceptionHandler>
+  Context(ExceptionHandler exceptHandler, std::string)
+  {
+  }
+
   Context(const Context&) = delete;
 
   Context(Context&& rhs)
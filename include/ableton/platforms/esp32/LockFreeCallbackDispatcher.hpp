@@ -36,7 +36,8 @@ namespace esp32
 // A condition variable is used to notify a waiting thread, but only if the required
 // lock can be acquired immediately. If that fails, we fall back on signaling
 // after a timeout. This gives us a guaranteed minimum signaling rate which is defined
-// by the fallbackPeriod parameter.
+// by the fallbackPeriod parameter. Invocations are flagged before notifying, so one that
+// arrives while the callback runs is dispatched right after it instead of being lost.
 
 template <typename Callback, typename Duration>
 class LockFreeCallbackDispatcher
@@ -67,6 +68,7 @@ public:
 
   void invoke()
   {
+    mIsInvoked = true;
     if (mMutex.try_lock())
     {
       mCondition.notify_one();
@@ -82,7 +84,12 @@ private:
     {
       {
         std::unique_lock<std::mutex> lock(dispatcher->mMutex);
-        dispatcher->mCondition.wait_for(lock, dispatcher->mFallbackPeriod);
+        dispatcher->mCondition.wait_for(
+          lock,
+          dispatcher->mFallbackPeriod,
+          [dispatcher]
+          { return dispatcher->mIsInvoked.load() || !dispatcher->mRunning.load(); });
+        dispatcher->mIsInvoked = false;
       }
 
       if (!dispatcher->mRunning.load())
@@ -98,6 +105,7 @@ private:
   Callback mCallback;
   Duration mFallbackPeriod;
   std::atomic<bool> mRunning;
+  std::atomic<bool> mIsInvoked{false};
   std::mutex mMutex;
   std::condition_variable mCondition;
   TaskHandle_t mTaskHandle;
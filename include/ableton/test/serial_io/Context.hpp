@@ -79,6 +79,24 @@ public:
 
   Timer makeTimer() { return {mNextTimerId++, mNow, mpScheduler}; }
 
+  // Invokes the callback synchronously, there is no fallback period
+  template <typename Callback, typename Duration>
+  struct LockFreeCallbackDispatcher
+  {
+    LockFreeCallbackDispatcher(Callback callback, Duration)
+      : mCallback(std::move(callback))
+    {
+    }
+
+    void start() {}
+
+    void stop() {}
+
+    void invoke() { mCallback(); }
+
+    Callback mCallback;
+  };
+
   using Log = util::NullLog;
 
   Log& log() { return mLog; }
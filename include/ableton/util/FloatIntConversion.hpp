@@ -20,10 +20,14 @@
 
 #pragma once
 
+#include <ableton/util/Simd.hpp>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
 
 namespace ableton
 {
@@ -50,5 +54,367 @@ T int16ToFloat(const int16_t src)
   return static_cast<T>(src) / kScale;
 }
 
+namespace detail
+{
+
+// The vectorized kernels convert as many samples as they can process in full vectors
+// and return that number. The remaining samples are converted by the scalar code. All
+// kernels produce the same results as the scalar conversions above: samples are clamped
+// and rounded half away from zero, which is what std::round does.
+
+#if defined(LINK_SIMD_AVX2)
+
+inline size_t floatToInt16Simd(const float* pSrc, int16_t* pDst, const size_t numSamples)
+{
+  const auto min = _mm256_set1_ps(-1.f);
+  const auto max = _mm256_set1_ps(1.f - 1.f / 32768.f);
+  const auto scale = _mm256_set1_ps(32768.f);
+  const auto half = _mm256_set1_ps(0.5f);
+  const auto minusHalf = _mm256_set1_ps(-0.5f);
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    const auto x =
+      _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(pSrc + i), min), max),
+                    scale);
+    auto truncated = _mm256_cvttps_epi32(x);
+    const auto fraction = _mm256_sub_ps(x, _mm256_cvtepi32_ps(truncated));
+    truncated = _mm256_sub_epi32(
+      truncated, _mm256_castps_si256(_mm256_cmp_ps(fraction, half, _CMP_GE_OQ)));
+    truncated = _mm256_add_epi32(
+      truncated, _mm256_castps_si256(_mm256_cmp_ps(fraction, minusHalf, _CMP_LE_OQ)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i),
+                     _mm_packs_epi32(_mm256_castsi256_si128(truncated),
+                                     _mm256_extracti128_si256(truncated, 1)));
+  }
+  return i;
+}
+
+inline size_t floatToInt16Simd(const double* pSrc, int16_t* pDst, const size_t numSamples)
+{
+  const auto min = _mm256_set1_pd(-1.);
+  const auto max = _mm256_set1_pd(1. - 1. / 32768.);
+  const auto scale = _mm256_set1_pd(32768.);
+  const auto half = _mm256_set1_pd(0.5);
+  const auto minusHalf = _mm256_set1_pd(-0.5);
+
+  auto convert = [&](const double* pIn)
+  {
+    const auto x = _mm256_mul_pd(
+      _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(pIn), min), max), scale);
+    auto truncated = _mm256_cvttpd_epi32(x);
+    const auto fraction = _mm256_sub_pd(x, _mm256_cvtepi32_pd(truncated));
+    const auto up = _mm256_castpd_si256(_mm256_cmp_pd(fraction, half, _CMP_GE_OQ));
+    const auto down =
+      _mm256_castpd_si256(_mm256_cmp_pd(fraction, minusHalf, _CMP_LE_OQ));
+    // Narrow the 64 bit comparison masks to 32 bit lanes
+    const auto shuffle = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    truncated = _mm_sub_epi32(
+      truncated, _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(up, shuffle)));
+    return _mm_add_epi32(
+      truncated, _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(down, shuffle)));
+  };
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i),
+                     _mm_packs_epi32(convert(pSrc + i), convert(pSrc + i + 4)));
+  }
+  return i;
+}
+
+#elif defined(LINK_SIMD_SSE2)
+
+inline size_t floatToInt16Simd(const float* pSrc, int16_t* pDst, const size_t numSamples)
+{
+  const auto min = _mm_set1_ps(-1.f);
+  const auto max = _mm_set1_ps(1.f - 1.f / 32768.f);
+  const auto scale = _mm_set1_ps(32768.f);
+  const auto half = _mm_set1_ps(0.5f);
+  const auto minusHalf = _mm_set1_ps(-0.5f);
+
+  auto convert = [&](const float* pIn)
+  {
+    const auto x = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pIn), min), max), scale);
+    auto truncated = _mm_cvttps_epi32(x);
+    const auto fraction = _mm_sub_ps(x, _mm_cvtepi32_ps(truncated));
+    truncated = _mm_sub_epi32(truncated, _mm_castps_si128(_mm_cmpge_ps(fraction, half)));
+    return _mm_add_epi32(
+      truncated, _mm_castps_si128(_mm_cmple_ps(fraction, minusHalf)));
+  };
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i),
+                     _mm_packs_epi32(convert(pSrc + i), convert(pSrc + i + 4)));
+  }
+  return i;
+}
+
+inline size_t floatToInt16Simd(const double* pSrc, int16_t* pDst, const size_t numSamples)
+{
+  const auto min = _mm_set1_pd(-1.);
+  const auto max = _mm_set1_pd(1. - 1. / 32768.);
+  const auto scale = _mm_set1_pd(32768.);
+  const auto half = _mm_set1_pd(0.5);
+  const auto minusHalf = _mm_set1_pd(-0.5);
+
+  // Converts two samples into the lower two 32 bit lanes
+  auto convert = [&](const double* pIn)
+  {
+    const auto x = _mm_mul_pd(_mm_min_pd(_mm_max_pd(_mm_loadu_pd(pIn), min), max), scale);
+    auto truncated = _mm_cvttpd_epi32(x);
+    const auto fraction = _mm_sub_pd(x, _mm_cvtepi32_pd(truncated));
+    // Narrow the 64 bit comparison masks to the lower two 32 bit lanes
+    const auto up = _mm_shuffle_epi32(_mm_castpd_si128(_mm_cmpge_pd(fraction, half)),
+                                      _MM_SHUFFLE(3, 3, 2, 0));
+    const auto down = _mm_shuffle_epi32(
+      _mm_castpd_si128(_mm_cmple_pd(fraction, minusHalf)), _MM_SHUFFLE(3, 3, 2, 0));
+    return _mm_add_epi32(_mm_sub_epi32(truncated, up), down);
+  };
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    const auto lo = _mm_unpacklo_epi64(convert(pSrc + i), convert(pSrc + i + 2));
+    const auto hi = _mm_unpacklo_epi64(convert(pSrc + i + 4), convert(pSrc + i + 6));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_packs_epi32(lo, hi));
+  }
+  return i;
+}
+
+#elif defined(LINK_SIMD_NEON)
+
+inline size_t floatToInt16Simd(const float* pSrc, int16_t* pDst, const size_t numSamples)
+{
+  const auto min = vdupq_n_f32(-1.f);
+  const auto max = vdupq_n_f32(1.f - 1.f / 32768.f);
+  const auto scale = vdupq_n_f32(32768.f);
+
+  // vcvtaq rounds to nearest with ties away from zero, just like std::round
+  auto convert = [&](const float* pIn)
+  {
+    return vqmovn_s32(
+      vcvtaq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(pIn), min), max), scale)));
+  };
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    vst1q_s16(pDst + i, vcombine_s16(convert(pSrc + i), convert(pSrc + i + 4)));
+  }
+  return i;
+}
+
+inline size_t floatToInt16Simd(const double* pSrc, int16_t* pDst, const size_t numSamples)
+{
+  const auto min = vdupq_n_f64(-1.);
+  const auto max = vdupq_n_f64(1. - 1. / 32768.);
+  const auto scale = vdupq_n_f64(32768.);
+
+  auto convert = [&](const double* pIn)
+  {
+    return vmovn_s64(
+      vcvtaq_s64_f64(vmulq_f64(vminq_f64(vmaxq_f64(vld1q_f64(pIn), min), max), scale)));
+  };
+
+  auto i = size_t{0};
+  for (; i + 4 <= numSamples; i += 4)
+  {
+    vst1_s16(pDst + i,
+             vqmovn_s32(vcombine_s32(convert(pSrc + i), convert(pSrc + i + 2))));
+  }
+  return i;
+}
+
+#else
+
+template <typename T>
+size_t floatToInt16Simd(const T*, int16_t*, size_t)
+{
+  return 0;
+}
+
+#endif
+
+#if defined(LINK_SIMD_SSE2)
+
+inline size_t int16ToFloatSimd(const int16_t* pSrc, float* pDst, const size_t numSamples)
+{
+  const auto scale = _mm_set1_ps(1.f / 32768.f);
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+    // Sign extend by moving each sample to the upper half of a 32 bit lane
+    const auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+    const auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+    _mm_storeu_ps(pDst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(pDst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  return i;
+}
+
+inline size_t int16ToFloatSimd(const int16_t* pSrc, double* pDst, const size_t numSamples)
+{
+  const auto scale = _mm_set1_pd(1. / 32768.);
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+    const auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+    const auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+    _mm_storeu_pd(pDst + i, _mm_mul_pd(_mm_cvtepi32_pd(lo), scale));
+    _mm_storeu_pd(pDst + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(lo, 8)), scale));
+    _mm_storeu_pd(pDst + i + 4, _mm_mul_pd(_mm_cvtepi32_pd(hi), scale));
+    _mm_storeu_pd(pDst + i + 6, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(hi, 8)), scale));
+  }
+  return i;
+}
+
+#elif defined(LINK_SIMD_NEON)
+
+inline size_t int16ToFloatSimd(const int16_t* pSrc, float* pDst, const size_t numSamples)
+{
+  const auto scale = vdupq_n_f32(1.f / 32768.f);
+
+  auto i = size_t{0};
+  for (; i + 8 <= numSamples; i += 8)
+  {
+    const auto x = vld1q_s16(pSrc + i);
+    vst1q_f32(pDst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), scale));
+    vst1q_f32(pDst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), scale));
+  }
+  return i;
+}
+
+inline size_t int16ToFloatSimd(const int16_t* pSrc, double* pDst, const size_t numSamples)
+{
+  const auto scale = vdupq_n_f64(1. / 32768.);
+
+  auto i = size_t{0};
+  for (; i + 4 <= numSamples; i += 4)
+  {
+    const auto x = vmovl_s16(vld1_s16(pSrc + i));
+    vst1q_f64(pDst + i, vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(x))), scale));
+    vst1q_f64(pDst + i + 2, vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(x))), scale));
+  }
+  return i;
+}
+
+#else
+
+template <typename T>
+size_t int16ToFloatSimd(const int16_t*, T*, size_t)
+{
+  return 0;
+}
+
+#endif
+
+} // namespace detail
+
+// Convert a contiguous range of samples. The result is identical to converting every
+// sample with floatToInt16, but uses vector instructions where available.
+template <typename T>
+void floatToInt16(const T* pSrc, int16_t* pDst, const size_t numSamples)
+{
+  static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value);
+
+  for (auto i = detail::floatToInt16Simd(pSrc, pDst, numSamples); i < numSamples; ++i)
+  {
+    pDst[i] = floatToInt16(pSrc[i]);
+  }
+}
+
+// Convert a contiguous range of samples. The result is identical to converting every
+// sample with int16ToFloat, but uses vector instructions where available.
+template <typename T>
+void int16ToFloat(const int16_t* pSrc, T* pDst, const size_t numSamples)
+{
+  static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value);
+
+  for (auto i = detail::int16ToFloatSimd(pSrc, pDst, numSamples); i < numSamples; ++i)
+  {
+    pDst[i] = int16ToFloat<T>(pSrc[i]);
+  }
+}
+
+// Convert numChannels separate channel buffers holding numFrames samples each to
+// interleaved 16-bit samples. Channels are converted in blocks on the stack, so this
+// does not allocate.
+template <typename T>
+void planarFloatToInterleavedInt16(const T* const* ppSrc,
+                                   int16_t* pDst,
+                                   const size_t numFrames,
+                                   const size_t numChannels)
+{
+  if (numChannels == 1)
+  {
+    floatToInt16(ppSrc[0], pDst, numFrames);
+    return;
+  }
+
+  constexpr auto kBlockSize = size_t{128};
+  auto block = std::array<int16_t, kBlockSize>{};
+
+  for (auto channel = size_t{0}; channel < numChannels; ++channel)
+  {
+    for (auto frame = size_t{0}; frame < numFrames; frame += kBlockSize)
+    {
+      const auto blockSize = std::min(kBlockSize, numFrames - frame);
+      floatToInt16(ppSrc[channel] + frame, block.data(), blockSize);
+      auto pOut = pDst + frame * numChannels + channel;
+      for (auto i = size_t{0}; i < blockSize; ++i, pOut += numChannels)
+      {
+        *pOut = block[i];
+      }
+    }
+  }
+}
+
+// Convert numChannels channels of numFrames interleaved 16-bit samples with
+// numSourceChannels channels each to separate channel buffers. pChannels holds the
+// source channel of each output channel. If it is null the first numChannels source
+// channels are converted. Channels are converted in blocks on the stack, so this does
+// not allocate.
+template <typename T>
+void interleavedInt16ToPlanarFloat(const int16_t* pSrc,
+                                   T* const* ppDst,
+                                   const size_t numFrames,
+                                   const size_t numSourceChannels,
+                                   const size_t* pChannels,
+                                   const size_t numChannels)
+{
+  constexpr auto kBlockSize = size_t{128};
+  auto block = std::array<int16_t, kBlockSize>{};
+
+  for (auto channel = size_t{0}; channel < numChannels; ++channel)
+  {
+    const auto sourceChannel = pChannels ? pChannels[channel] : channel;
+    if (numSourceChannels == 1)
+    {
+      int16ToFloat(pSrc, ppDst[channel], numFrames);
+      continue;
+    }
+
+    for (auto frame = size_t{0}; frame < numFrames; frame += kBlockSize)
+    {
+      const auto blockSize = std::min(kBlockSize, numFrames - frame);
+      auto pIn = pSrc + frame * numSourceChannels + sourceChannel;
+      for (auto i = size_t{0}; i < blockSize; ++i, pIn += numSourceChannels)
+      {
+        block[i] = *pIn;
+      }
+      int16ToFloat(block.data(), ppDst[channel] + frame, blockSize);
+    }
+  }
+}
+
 } // namespace util
 } // namespace ableton
@@ -0,0 +1,94 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ableton
+{
+namespace util
+{
+
+// Holds a value that is read often and replaced rarely (read-copy-update). Readers
+// never lock or allocate: they announce themselves in a counter of the current epoch
+// and use the value in place. Writers publish a new value and wait until all readers
+// that might still see the old one are done before destroying it, so once write()
+// returns the old value is no longer in use. Readers must not write to the same slot.
+template <typename T>
+class RcuSlot
+{
+public:
+  explicit RcuSlot(T value)
+    : mpValue(new T(std::move(value)))
+  {
+  }
+
+  RcuSlot(const RcuSlot&) = delete;
+  RcuSlot& operator=(const RcuSlot&) = delete;
+
+  ~RcuSlot() { delete mpValue.load(); }
+
+  template <typename Handler>
+  void read(Handler handler) const
+  {
+    auto& numReaders = mNumReaders[mEpoch.load() & 1u].value;
+    numReaders.fetch_add(1);
+    handler(*mpValue.load());
+    numReaders.fetch_sub(1);
+  }
+
+  void write(T value)
+  {
+    auto pValue = std::make_unique<T>(std::move(value));
+
+    std::lock_guard lock(mWriteMutex);
+    pValue.reset(mpValue.exchange(pValue.release()));
+
+    // A reader may have picked its counter just before an epoch change, so both
+    // counters have to drain once after the exchange
+    for (auto i = 0; i < 2; ++i)
+    {
+      const auto epoch = mEpoch.fetch_add(1);
+      while (mNumReaders[epoch & 1u].value.load() != 0)
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+private:
+  struct alignas(64) Counter
+  {
+    std::atomic<uint32_t> value{0};
+  };
+
+  std::atomic<T*> mpValue;
+  alignas(64) std::atomic<uint32_t> mEpoch{0};
+  mutable std::array<Counter, 2> mNumReaders;
+  std::mutex mWriteMutex;
+};
+
+} // namespace util
+} // namespace ableton
@@ -0,0 +1,51 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#pragma once
+
+/*!
+ * \brief Compile time detection of the vector instruction sets used by Link
+ *
+ * Link is header-only, so the instruction set is chosen by the compiler flags of the
+ * including project. Define LINK_DISABLE_SIMD to force the scalar implementations.
+ */
+
+#if !defined(LINK_DISABLE_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LINK_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#define LINK_SIMD_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define LINK_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define LINK_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#endif
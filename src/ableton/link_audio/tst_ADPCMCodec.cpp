@@ -0,0 +1,203 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/ADPCMCodec.hpp>
+#include <ableton/link_audio/Decoder.hpp>
+#include <ableton/link_audio/test/Codec.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace
+{
+
+using test::Samples;
+using test::Sender;
+using test::sine;
+using test::Successor;
+
+// Signal to noise ratio of the decoded samples in dB
+double snr(const Samples& input, const Samples& output)
+{
+  auto signal = 0.;
+  auto noise = 0.;
+  for (auto i = size_t{0}; i < input.size(); ++i)
+  {
+    const auto x = static_cast<double>(input[i]);
+    const auto error = x - static_cast<double>(output[i]);
+    signal += x * x;
+    noise += error * error;
+  }
+  return 10. * std::log10(signal / std::max(noise, 1.));
+}
+
+Samples roundtrip(const Samples& input, const uint32_t numChannels, size_t* pNumBytes)
+{
+  const auto numBytes =
+    detail::adpcmSize(static_cast<uint32_t>(input.size() / numChannels), numChannels);
+  auto output = test::roundtrip(
+    input, numChannels, numBytes, detail::adpcmEncode, detail::adpcmDecode, pNumBytes);
+  REQUIRE(numBytes == *pNumBytes);
+  return output;
+}
+
+} // namespace
+
+TEST_CASE("ADPCMCodec | Roundtrip")
+{
+  auto numBytes = size_t{0};
+
+  SECTION("Sine")
+  {
+    const auto input = sine(513, 2);
+    const auto output = roundtrip(input, 2, &numBytes);
+    CHECK(input[0] == output[0]);
+    CHECK(input[1] == output[1]);
+    CHECK(snr(input, output) > 30.);
+    CHECK(2 * (4 + 512 / 2) == numBytes);
+  }
+
+  SECTION("Silence")
+  {
+    const auto input = Samples(64, 0);
+    const auto output = roundtrip(input, 1, &numBytes);
+    CHECK(input == output);
+  }
+
+  SECTION("PartialLastGroup")
+  {
+    for (auto numFrames = 1u; numFrames <= 2 * detail::kADPCMGroupSize; ++numFrames)
+    {
+      const auto input = sine(numFrames, 3);
+      const auto output = roundtrip(input, 3, &numBytes);
+      CHECK(detail::adpcmSize(numFrames, 3) == numBytes);
+      CHECK(input.size() == output.size());
+    }
+  }
+
+  SECTION("FullScaleSteps")
+  {
+    auto input = Samples(256);
+    for (auto i = 0u; i < input.size(); ++i)
+    {
+      input[i] = (i / 32) % 2 == 0 ? 32767 : -32768;
+    }
+    const auto output = roundtrip(input, 1, &numBytes);
+    CHECK(input.back() == output.back());
+  }
+}
+
+TEST_CASE("ADPCMCodec | Malformed input")
+{
+  const auto input = sine(65, 1);
+  auto bytes = std::vector<uint8_t>(detail::adpcmSize(65, 1));
+  const auto end =
+    detail::adpcmEncode(input.data(), 65, 1, bytes.data(), bytes.data() + bytes.size());
+  REQUIRE(end != nullptr);
+  auto output = Samples(input.size());
+
+  SECTION("Truncated")
+  {
+    CHECK_THROWS_AS(detail::adpcmDecode(bytes.data(), end - 1, 65, 1, output.data()),
+                    std::range_error);
+  }
+
+  SECTION("InvalidStepIndex")
+  {
+    bytes[2] = detail::kADPCMMaxStepIndex + 1;
+    CHECK_THROWS_AS(detail::adpcmDecode(bytes.data(), end, 65, 1, output.data()),
+                    std::range_error);
+  }
+
+  SECTION("OutputDoesntFit")
+  {
+    CHECK(detail::adpcmEncode(input.data(), 65, 1, bytes.data(), end - 1) == nullptr);
+  }
+}
+
+TEST_CASE("ADPCMEncoder")
+{
+  const auto numChannels = 2u;
+  const auto maxNumBytes = 520u;
+  const auto numFrames = maxNumBytes * ADPCMEncoder<Sender&>::kMaxExpansion
+                         / (numChannels * uint32_t{sizeof(int16_t)});
+
+  auto sender = Sender{};
+  auto encoder = ADPCMEncoder<Sender&>(util::injectRef(sender), {});
+  encoder.setMaxNumBytes(maxNumBytes);
+  auto successor = Successor{};
+  auto decoder = Decoder<Successor&>(util::injectRef(successor), 4096);
+
+  const auto input = sine(numFrames, numChannels);
+  const auto chunks =
+    AudioBuffer::Chunks{{1u, static_cast<uint16_t>(numFrames), Beats{4.}, Tempo{120.}}};
+  encoder(input.data(), chunks, numChannels, 48000, Id{});
+
+  // The header of each channel doesn't leave room for the padded last group
+  REQUIRE(2 == sender.buffers.size());
+  for (const auto& buffer : sender.buffers)
+  {
+    CHECK(Codec::kADPCM_i4 == buffer.codec);
+    CHECK(maxNumBytes >= buffer.numBytes);
+    decoder(buffer);
+  }
+  REQUIRE(input.size() == successor.samples.size());
+  CHECK(snr(input, successor.samples) > 30.);
+}
+
+TEST_CASE("ADPCMCodec | Benchmark", "[.benchmark]")
+{
+  const auto numFrames = uint32_t{AudioBuffer::kMaxAudioBytes / sizeof(int16_t)};
+  const auto samples = sine(numFrames, 1);
+  auto bytes = std::array<uint8_t, AudioBuffer::kMaxAudioBytes>{};
+  const auto end =
+    detail::adpcmEncode(samples.data(), numFrames, 1, bytes.data(), bytes.end());
+  auto output = Samples(samples.size());
+
+  // One channel of a full PCM packet, compared to the PCM path
+  BENCHMARK("Encode ADPCM")
+  {
+    return detail::adpcmEncode(samples.data(), numFrames, 1, bytes.data(), bytes.end());
+  };
+
+  BENCHMARK("Decode ADPCM")
+  {
+    detail::adpcmDecode(bytes.data(), end, numFrames, 1, output.data());
+    return output.back();
+  };
+
+  BENCHMARK("Encode PCM")
+  {
+    return detail::samplesToNetworkByteStream(samples.data(), numFrames, bytes.data());
+  };
+
+  BENCHMARK("Decode PCM")
+  {
+    detail::samplesFromNetworkByteStream(bytes.data(), numFrames, output.data());
+    return output.back();
+  };
+}
+
+} // namespace link_audio
+} // namespace ableton
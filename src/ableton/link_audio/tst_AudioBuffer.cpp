@@ -107,6 +107,21 @@ TEST_CASE("AudioBuffer")
       "Invalid audio buffer: no chunks.");
   }
 
+  SECTION("NonAudioBytes")
+  {
+    auto buffer =
+      AudioBuffer{Id::random<Random>(),
+                  Id::random<Random>(),
+                  std::vector<AudioBuffer::Chunk>{{1, 0, Beats{0.}, Tempo(120.)}},
+                  Codec::kPCM_i16,
+                  44100,
+                  1,
+                  0,
+                  {}};
+    CHECK(AudioBuffer::kNonAudioBytes == sizeInByteStream(buffer));
+    CHECK(v1::kMaxMessageSize
+          == v1::kHeaderSize + AudioBuffer::kNonAudioBytes + AudioBuffer::kMaxAudioBytes);
+  }
 
   SECTION("MultipleChunks")
   {
@@ -134,6 +149,78 @@ TEST_CASE("AudioBuffer")
     CHECK(bytes.end() == deserializedEnd);
     CHECK(buffer == deserialized);
   }
+
+  SECTION("ViewRefersToBytesInPlace")
+  {
+    auto buffer =
+      AudioBuffer{Id::random<Random>(),
+                  Id::random<Random>(),
+                  std::vector<AudioBuffer::Chunk>{{9977, 2, Beats{23.}, Tempo(120.)}},
+                  Codec::kPCM_i16,
+                  44100,
+                  2,
+                  8,
+                  {{1, 2, 3, 4, 5, 6, 7, 8}}};
+    auto bytes = std::vector<uint8_t>(sizeInByteStream(buffer));
+    toNetworkByteStream(buffer, bytes.begin());
+
+    auto view = AudioBufferView{};
+    const auto viewEnd = AudioBufferView::fromNetworkByteStream(
+      view, bytes.data(), bytes.data() + bytes.size());
+
+    CHECK(bytes.data() + bytes.size() == viewEnd);
+    CHECK(bytes.data() + bytes.size() - buffer.numBytes == view.pBytes);
+    CHECK(AudioBufferView{buffer} == view);
+
+    auto copy = AudioBuffer{};
+    copy.assign(view);
+    CHECK(buffer == copy);
+  }
+
+  SECTION("Timing")
+  {
+    auto buffer =
+      AudioBuffer{Id::random<Random>(),
+                  Id::random<Random>(),
+                  std::vector<AudioBuffer::Chunk>{{9977, 2, Beats{23.}, Tempo(120.)}},
+                  Codec::kPCM_i16,
+                  44100,
+                  2,
+                  8,
+                  {{1, 2, 3, 4, 5, 6, 7, 8}}};
+    const auto timing =
+      AudioBufferTiming{std::chrono::microseconds{-5}, std::chrono::microseconds{1234}};
+    const auto timed = TimedAudioBuffer{buffer, timing};
+    CHECK(sizeInByteStream(buffer) + AudioBufferTiming::kSize == sizeInByteStream(timed));
+
+    auto bytes = std::vector<uint8_t>(sizeInByteStream(timed));
+    CHECK(bytes.end() == toNetworkByteStream(timed, bytes.begin()));
+
+    auto view = AudioBufferView{};
+    const auto viewEnd = AudioBufferView::fromNetworkByteStream(
+      view, bytes.data(), bytes.data() + bytes.size());
+    CHECK(bytes.data() + bytes.size() == viewEnd);
+    CHECK(AudioBufferView{buffer} == view);
+    REQUIRE(view.timing.has_value());
+    CHECK(timing.commitTime == view.timing->commitTime);
+    CHECK(timing.sendTime == view.timing->sendTime);
+
+    // A copy serializes to the same bytes
+    auto copy = AudioBuffer{};
+    copy.assign(view);
+    auto copyBytes = std::vector<uint8_t>(sizeInByteStream(copy));
+    toNetworkByteStream(copy, copyBytes.begin());
+    CHECK(bytes == copyBytes);
+
+    SECTION("OtherTrailingBytesAreInvalid")
+    {
+      bytes.pop_back();
+      CHECK_THROWS(
+        AudioBufferView::fromNetworkByteStream(view, bytes.data(), bytes.data() + 50));
+      CHECK_THROWS(AudioBufferView::fromNetworkByteStream(
+        view, bytes.data(), bytes.data() + bytes.size()));
+    }
+  }
 }
 
 } // namespace link_audio
@@ -46,6 +46,35 @@ TEST_CASE("AudioChannels")
                .first);
   }
 
+  SECTION("MulticastGroupsRoundtrip")
+  {
+    auto groups = ChannelMulticastGroups{
+      {{foo.id, multicastGroup(foo.id)}, {bar.id, multicastGroup(bar.id)}}};
+    const auto size = sizeInByteStream(groups);
+    auto bytes = std::vector<uint8_t>(size);
+    auto serializedEnd = toNetworkByteStream(groups, bytes.begin());
+    CHECK(bytes.end() == serializedEnd);
+    CHECK(groups
+          == discovery::Deserialize<ChannelMulticastGroups>::fromNetworkByteStream(
+               bytes.begin(), bytes.end())
+               .first);
+  }
+
+  SECTION("EmptyMulticastGroupsAreNotSerialized")
+  {
+    CHECK(0 == sizeInByteStream(ChannelMulticastGroups{}));
+  }
+
+  SECTION("MulticastGroup")
+  {
+    const auto group = multicastGroup(foo.id);
+    CHECK(group == multicastGroup(foo.id));
+    CHECK(group.address().is_multicast());
+    CHECK(239 == group.address().to_v4().to_bytes()[0]);
+    CHECK(192 == group.address().to_v4().to_bytes()[1]);
+    CHECK(kMulticastGroupPort == group.port());
+  }
+
   SECTION("ByesRoundtrip")
   {
     auto channels = ChannelByes{{ChannelBye{foo.id}, ChannelBye{bar.id}}};
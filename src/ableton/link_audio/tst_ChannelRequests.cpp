@@ -17,6 +17,7 @@
  *  please contact <link-devs@ableton.com>.
  */
 
+#include <ableton/link_audio/ChannelAnnouncements.hpp>
 #include <ableton/link_audio/ChannelRequests.hpp>
 #include <ableton/platforms/stl/Random.hpp>
 #include <ableton/test/CatchWrapper.hpp>
@@ -42,6 +43,105 @@ TEST_CASE("ChannelRequest | RoundtripByteStreamEncoding", "[ChannelRequests]")
   CHECK(request == result);
 }
 
+TEST_CASE("ChannelRequest | RoundtripWithMulticastGroup", "[ChannelRequests]")
+{
+  using Random = ableton::platforms::stl::Random;
+
+  const auto channelId = Id::random<Random>();
+  const auto request =
+    ChannelRequest{Id::random<Random>(), channelId, multicastGroup(channelId)};
+
+  auto payload = toPayload(request);
+
+  std::vector<std::uint8_t> bytes(sizeInByteStream(payload));
+  const auto end = toNetworkByteStream(payload, begin(bytes));
+  CHECK(bytes.end() == end);
+
+  const auto result = ChannelRequest::fromPayload(request.peerId, bytes.begin(), end);
+  CHECK(request == result);
+}
+
+TEST_CASE("ChannelRequest | UnicastRequestHasNoMulticastGroup", "[ChannelRequests]")
+{
+  using Random = ableton::platforms::stl::Random;
+
+  const auto request = ChannelRequest{Id::random<Random>(), Id::random<Random>(), {}};
+
+  // Peers that don't support multicast see the same payload as before
+  CHECK(sizeInByteStream(discovery::makePayload(ChannelId{request.channelId}))
+        == sizeInByteStream(toPayload(request)));
+}
+
+TEST_CASE("ChannelRequest | RoundtripWithPreferredCodec", "[ChannelRequests]")
+{
+  using Random = ableton::platforms::stl::Random;
+
+  const auto request =
+    ChannelRequest{Id::random<Random>(), Id::random<Random>(), {}, Codec::kLPC_i16};
+
+  auto payload = toPayload(request);
+
+  std::vector<std::uint8_t> bytes(sizeInByteStream(payload));
+  const auto end = toNetworkByteStream(payload, begin(bytes));
+  CHECK(bytes.end() == end);
+
+  const auto result = ChannelRequest::fromPayload(request.peerId, bytes.begin(), end);
+  CHECK(request == result);
+}
+
+TEST_CASE("ChannelRequest | PCMRequestHasNoPreferredCodec", "[ChannelRequests]")
+{
+  using Random = ableton::platforms::stl::Random;
+
+  const auto request =
+    ChannelRequest{Id::random<Random>(), Id::random<Random>(), {}, Codec::kPCM_i16};
+
+  // Peers that don't support other codecs see the same payload as before
+  CHECK(sizeInByteStream(discovery::makePayload(ChannelId{request.channelId}))
+        == sizeInByteStream(toPayload(request)));
+}
+
+TEST_CASE("ChannelRequest | RoundtripWithAcceptsParity", "[ChannelRequests]")
+{
+  using Random = ableton::platforms::stl::Random;
+
+  const auto request = ChannelRequest{
+    Id::random<Random>(), Id::random<Random>(), {}, Codec::kPCM_i16, true};
+
+  auto payload = toPayload(request);
+
+  std::vector<std::uint8_t> bytes(sizeInByteStream(payload));
+  const auto end = toNetworkByteStream(payload, begin(bytes));
+  CHECK(bytes.end() == end);
+
+  const auto result = ChannelRequest::fromPayload(request.peerId, bytes.begin(), end);
+  CHECK(request == result);
+
+  // Requests without parity look the same as before
+  const auto withoutParity =
+    ChannelRequest{request.peerId, request.channelId, {}, Codec::kPCM_i16, false};
+  CHECK(sizeInByteStream(discovery::makePayload(ChannelId{request.channelId}))
+        == sizeInByteStream(toPayload(withoutParity)));
+}
+
+TEST_CASE("ChannelRequest | RoundtripWithAcceptsTiming", "[ChannelRequests]")
+{
+  using Random = ableton::platforms::stl::Random;
+
+  const auto request = ChannelRequest{
+    Id::random<Random>(), Id::random<Random>(), {}, Codec::kPCM_i16, false, true};
+
+  auto payload = toPayload(request);
+
+  std::vector<std::uint8_t> bytes(sizeInByteStream(payload));
+  const auto end = toNetworkByteStream(payload, begin(bytes));
+  CHECK(bytes.end() == end);
+
+  const auto result = ChannelRequest::fromPayload(request.peerId, bytes.begin(), end);
+  CHECK(request == result);
+  CHECK(result.acceptsTiming);
+}
+
 TEST_CASE("ChannelStopRequest | RoundtripByteStreamEncoding", "[ChannelRequests]")
 {
   using Random = ableton::platforms::stl::Random;
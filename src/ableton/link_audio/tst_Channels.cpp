@@ -22,6 +22,7 @@
 #include <ableton/link_audio/ChannelAnnouncements.hpp>
 #include <ableton/link_audio/Channels.hpp>
 #include <ableton/link_audio/Id.hpp>
+#include <ableton/link_audio/NetworkMetrics.hpp>
 #include <ableton/link_audio/PeerAnnouncement.hpp>
 #include <ableton/platforms/stl/Random.hpp>
 #include <ableton/test/CatchWrapper.hpp>
@@ -54,6 +55,7 @@ TEST_CASE("Channels")
     std::shared_ptr<int> pInterface;
     discovery::UdpEndpoint from;
     int ttl;
+    NetworkMetricsFilter::Stats networkStats;
   };
 
   using Random = ableton::platforms::stl::Random;
@@ -86,7 +88,10 @@ TEST_CASE("Channels")
                          100.,
                          {},
                          {discovery::makeAddress("1.1.1.1"), 1},
-                         2};
+                         2,
+                         {std::chrono::microseconds{400},
+                          std::chrono::microseconds{20},
+                          1}};
 
   const auto bar = Input{{Id::random<Random>(),
                           sessionId,
@@ -95,7 +100,8 @@ TEST_CASE("Channels")
                          {},
                          {},
                          {},
-                         5};
+                         5,
+                         {}};
 
   const auto gateway1 = discovery::makeAddress("123.123.123.123");
   const auto gateway2 = discovery::makeAddress("210.210.210.210");
@@ -117,7 +123,8 @@ TEST_CASE("Channels")
             100.,
             {},
             {discovery::makeAddress("2.2.2.2"), 2},
-            2};
+            2,
+            {}};
 
     auto observer = makeGatewayObserver(channels, gateway1);
     sawAnnouncement(observer, sourceOnlyPeer);
@@ -138,6 +145,7 @@ TEST_CASE("Channels")
       const auto prunedHandler =
         channels.peerSendHandler(sourceOnlyPeer.announcement.nodeId);
       CHECK(!prunedHandler.has_value());
+      CHECK(channels.peerNetworkStats().empty());
     }
   }
 
@@ -149,6 +157,30 @@ TEST_CASE("Channels")
 
     CHECK(1 == callback.mNumCalls);
 
+    SECTION("PeerNetworkStats")
+    {
+      const auto stats = channels.peerNetworkStats();
+      REQUIRE(1 == stats.size());
+      CHECK(foo.announcement.nodeId == stats[0].peerId);
+      CHECK(std::chrono::microseconds{400} == stats[0].roundTripTime);
+      CHECK(std::chrono::microseconds{20} == stats[0].jitter);
+
+      // Later announcements via the same connection update the stats
+      auto laterFoo = foo;
+      laterFoo.networkStats.roundTripTime = std::chrono::microseconds{500};
+      sawAnnouncement(observer, laterFoo);
+      CHECK(std::chrono::microseconds{500}
+            == channels.peerNetworkStats()[0].roundTripTime);
+
+      // The stats of a channel are the ones of its peer
+      const auto channelStats =
+        channels.channelNetworkStats(foo.announcement.channels.channels[0].id);
+      REQUIRE(channelStats.has_value());
+      CHECK(foo.announcement.nodeId == channelStats->peerId);
+      CHECK(std::chrono::microseconds{500} == channelStats->roundTripTime);
+      CHECK(!channels.channelNetworkStats(Id{}).has_value());
+    }
+
     SECTION("UniqueChannels")
     {
       const auto uniqueChannels =
@@ -41,6 +41,7 @@ TEST_CASE("Encoder")
   {
     void operator()(const AudioBuffer& buffer)
     {
+      messageSizes.push_back(v1::kHeaderSize + sizeInByteStream(buffer));
       std::copy(
         buffer.chunks.begin(), buffer.chunks.end(), std::back_inserter(sentChunks));
 
@@ -55,6 +56,7 @@ TEST_CASE("Encoder")
 
     Samples sent;
     std::vector<AudioBuffer::Chunk> sentChunks;
+    std::vector<size_t> messageSizes;
   };
 
   auto buildSamples = [](uint32_t frameSize, uint32_t audio)
@@ -156,6 +158,89 @@ TEST_CASE("Encoder")
 
     CHECK(samples == sender.sent);
   }
+
+  SECTION("FlushSendsPendingFrames")
+  {
+    auto encoder = TestEncoder(util::injectRef(sender), {});
+    const auto samples = buildSamples(64, 2);
+    encoder(buildInputBuffer(samples, kEngineSampleRate, 2, kBeginBeats, kTempo));
+    CHECK(sender.sent.empty());
+
+    encoder.flush();
+    REQUIRE(1 == sender.sentChunks.size());
+    CHECK(64 == sender.sentChunks.front().numFrames);
+    CHECK(samples == sender.sent);
+
+    // Nothing is pending anymore
+    encoder.flush();
+    CHECK(1 == sender.sentChunks.size());
+  }
+
+  SECTION("DefaultMessageSize")
+  {
+    process(sender, kMonoInputBuffer);
+
+    REQUIRE(1 == sender.messageSizes.size());
+    CHECK(v1::kDefaultMaxAudioBufferMessageSize == sender.messageSizes[0]);
+  }
+
+  SECTION("MaxMessageSize")
+  {
+    auto encoder = TestEncoder(util::injectRef(sender), {});
+    encoder.setMaxMessageSize(v1::kMaxMessageSize);
+    CHECK(v1::kMaxMessageSize == encoder.maxMessageSize());
+
+    const auto numFrames = 4 * AudioBuffer::kMaxAudioBytes;
+    const auto samples = buildSamples(numFrames, 2);
+    encoder(buildInputBuffer(samples, kEngineSampleRate, 2, kBeginBeats, kTempo));
+
+    // Every full packet holds as many frames as fit into the maximum message size
+    const auto bytesPerFrame = 2 * sizeof(SampleFormat);
+    const auto framesPerPacket = AudioBuffer::kMaxAudioBytes / bytesPerFrame;
+    REQUIRE(numFrames / framesPerPacket == sender.messageSizes.size());
+    for (const auto messageSize : sender.messageSizes)
+    {
+      CHECK(messageSize <= v1::kMaxMessageSize);
+      CHECK(messageSize + bytesPerFrame > v1::kMaxMessageSize);
+    }
+    CHECK(framesPerPacket == sender.sentChunks.front().numFrames);
+    CHECK(std::equal(sender.sent.begin(), sender.sent.end(), samples.begin()));
+  }
+
+  SECTION("MaxMessageSizeIsClamped")
+  {
+    auto encoder = TestEncoder(util::injectRef(sender), {});
+
+    encoder.setMaxMessageSize(0);
+    CHECK(TestEncoder::kMinMessageSize == encoder.maxMessageSize());
+
+    encoder.setMaxMessageSize(9000);
+    CHECK(v1::kMaxMessageSize == encoder.maxMessageSize());
+  }
+
+  SECTION("MultipleChunksFitIntoMaxMessageSize")
+  {
+    auto encoder = TestEncoder(util::injectRef(sender), {});
+    encoder.setMaxMessageSize(v1::kMaxMessageSize);
+
+    // Tempo changes combined with beat jumps start new chunks within a packet
+    const auto samples = buildSamples(64, 2);
+    for (auto i = 0u; i < 100; ++i)
+    {
+      encoder(buildInputBuffer(samples,
+                               kEngineSampleRate,
+                               2,
+                               Beats{static_cast<double>(i)},
+                               Tempo{100.0 + i}));
+    }
+
+    REQUIRE(!sender.messageSizes.empty());
+    CHECK(sender.sentChunks.size() > sender.messageSizes.size());
+    for (const auto messageSize : sender.messageSizes)
+    {
+      CHECK(messageSize <= v1::kMaxMessageSize);
+    }
+  }
 }
 
 } // namespace link_audio
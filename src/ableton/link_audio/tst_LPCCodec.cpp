@@ -0,0 +1,240 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/Decoder.hpp>
+#include <ableton/link_audio/LPCCodec.hpp>
+#include <ableton/link_audio/test/Codec.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <array>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace
+{
+
+using test::Samples;
+using test::Sender;
+using test::sine;
+using test::Successor;
+
+Samples noise(const size_t numSamples)
+{
+  auto gen = std::mt19937{};
+  auto dist = std::uniform_int_distribution<int>{std::numeric_limits<int16_t>::min(),
+                                                 std::numeric_limits<int16_t>::max()};
+  auto samples = Samples(numSamples);
+  std::generate(
+    samples.begin(), samples.end(), [&] { return static_cast<int16_t>(dist(gen)); });
+  return samples;
+}
+
+Samples roundtrip(const Samples& input, const uint32_t numChannels, size_t* pNumBytes)
+{
+  auto output = test::roundtrip(input,
+                                numChannels,
+                                input.size() * 4 + 64,
+                                detail::lpcEncode,
+                                detail::lpcDecode,
+                                pNumBytes);
+  REQUIRE(*pNumBytes > 0);
+  return output;
+}
+
+} // namespace
+
+TEST_CASE("LPCCodec | Roundtrip")
+{
+  auto numBytes = size_t{0};
+
+  SECTION("Sine")
+  {
+    const auto input = sine(512, 2);
+    CHECK(input == roundtrip(input, 2, &numBytes));
+    CHECK(numBytes < input.size() * sizeof(int16_t) / 2);
+  }
+
+  SECTION("Noise")
+  {
+    const auto input = noise(512);
+    CHECK(input == roundtrip(input, 1, &numBytes));
+  }
+
+  SECTION("FullScaleSquareWave")
+  {
+    auto input = Samples(256);
+    for (auto i = 0u; i < input.size(); ++i)
+    {
+      input[i] = (i / 3) % 2 == 0 ? std::numeric_limits<int16_t>::max()
+                                  : std::numeric_limits<int16_t>::min();
+    }
+    CHECK(input == roundtrip(input, 1, &numBytes));
+  }
+
+  SECTION("Silence")
+  {
+    const auto input = Samples(1024, 0);
+    CHECK(input == roundtrip(input, 4, &numBytes));
+    CHECK(numBytes < 4 * 1024 / 8 + 4);
+  }
+
+  SECTION("FewerFramesThanTheMaximumOrder")
+  {
+    for (auto numFrames = 1u; numFrames <= detail::kLPCMaxOrder; ++numFrames)
+    {
+      const auto input = noise(numFrames * 3);
+      CHECK(input == roundtrip(input, 3, &numBytes));
+    }
+  }
+}
+
+TEST_CASE("LPCCodec | Malformed input")
+{
+  const auto input = sine(128, 1);
+  auto bytes = std::array<uint8_t, 512>{};
+  const auto end =
+    detail::lpcEncode(input.data(), 128, 1, bytes.data(), bytes.data() + bytes.size());
+  REQUIRE(end != nullptr);
+  auto output = Samples(input.size());
+
+  SECTION("Truncated")
+  {
+    CHECK_THROWS_AS(detail::lpcDecode(bytes.data(), end - 4, 128, 1, output.data()),
+                    std::range_error);
+  }
+
+  SECTION("InvalidOrder")
+  {
+    bytes[0] = 0xff;
+    CHECK_THROWS_AS(detail::lpcDecode(bytes.data(), end, 128, 1, output.data()),
+                    std::range_error);
+  }
+
+  SECTION("OutputDoesntFit")
+  {
+    CHECK(detail::lpcEncode(input.data(), 128, 1, bytes.data(), bytes.data() + 8)
+          == nullptr);
+  }
+}
+
+TEST_CASE("LPCEncoder")
+{
+  const auto numChannels = 2u;
+  const auto maxNumBytes = 520u;
+  const auto tempo = Tempo{120.};
+  const auto numFrames = maxNumBytes * LPCEncoder<Sender&>::kMaxExpansion
+                         / (numChannels * uint32_t{sizeof(int16_t)});
+
+  auto sender = Sender{};
+  auto encoder = LPCEncoder<Sender&>(util::injectRef(sender), {});
+  encoder.setMaxNumBytes(maxNumBytes);
+  auto successor = Successor{};
+  auto decoder = Decoder<Successor&>(util::injectRef(successor), 4096);
+
+  SECTION("CompressiblePacketsAreSentAtOnce")
+  {
+    const auto input = sine(numFrames, numChannels);
+    const auto chunks = AudioBuffer::Chunks{
+      {1u, static_cast<uint16_t>(numFrames), Beats{4.}, tempo}};
+    encoder(input.data(), chunks, numChannels, 48000, Id{});
+
+    REQUIRE(1 == sender.buffers.size());
+    CHECK(Codec::kLPC_i16 == sender.buffers[0].codec);
+    CHECK(maxNumBytes >= sender.buffers[0].numBytes);
+
+    decoder(sender.buffers[0]);
+    CHECK(input == successor.samples);
+    CHECK(std::vector<Beats>{Beats{4.}} == successor.beginBeats);
+  }
+
+  SECTION("IncompressiblePacketsAreSplitAndSentAsPCM")
+  {
+    const auto input = noise(numFrames * numChannels);
+    const auto chunks = AudioBuffer::Chunks{
+      {1u, static_cast<uint16_t>(numFrames), Beats{4.}, tempo}};
+    encoder(input.data(), chunks, numChannels, 48000, Id{});
+
+    REQUIRE(2 == sender.buffers.size());
+    for (const auto& buffer : sender.buffers)
+    {
+      CHECK(Codec::kPCM_i16 == buffer.codec);
+      CHECK(maxNumBytes >= buffer.numBytes);
+      decoder(buffer);
+    }
+    CHECK(input == successor.samples);
+    CHECK(std::vector<uint64_t>{1, 2} == successor.counts);
+    const auto secondBeats =
+      Beats{4. + static_cast<double>(numFrames / 2) / 48000. * tempo.bpm() / 60.};
+    REQUIRE(2 == successor.beginBeats.size());
+    CHECK(secondBeats.microBeats() == successor.beginBeats[1].microBeats());
+  }
+
+  SECTION("ChunksAreSplitAtTheirFrame")
+  {
+    auto input = sine(numFrames, numChannels);
+    const auto noisy = noise(numFrames);
+    std::copy(noisy.begin(), noisy.end(), input.begin() + numFrames);
+    const auto numFirstFrames = static_cast<uint16_t>(numFrames / 4);
+    const auto chunks = AudioBuffer::Chunks{
+      {7u, numFirstFrames, Beats{4.}, tempo},
+      {8u, static_cast<uint16_t>(numFrames - numFirstFrames), Beats{8.}, tempo}};
+    encoder(input.data(), chunks, numChannels, 48000, Id{});
+
+    REQUIRE(2 <= sender.buffers.size());
+    for (const auto& buffer : sender.buffers)
+    {
+      decoder(buffer);
+    }
+    CHECK(input == successor.samples);
+    for (auto i = size_t{1}; i < successor.counts.size(); ++i)
+    {
+      CHECK(successor.counts[i - 1] + 1 == successor.counts[i]);
+    }
+  }
+}
+
+TEST_CASE("LPCCodec | Benchmark", "[.benchmark]")
+{
+  const auto numChannels = 2u;
+  const auto numFrames = uint32_t{AudioBuffer::kMaxAudioBytes / sizeof(int16_t)};
+  const auto samples = sine(numFrames, numChannels);
+  auto bytes = std::array<uint8_t, 4 * AudioBuffer::kMaxAudioBytes>{};
+  const auto end = detail::lpcEncode(
+    samples.data(), numFrames, numChannels, bytes.data(), bytes.data() + bytes.size());
+  auto output = Samples(samples.size());
+
+  BENCHMARK("Encode")
+  {
+    return detail::lpcEncode(
+      samples.data(), numFrames, numChannels, bytes.data(), bytes.data() + bytes.size());
+  };
+
+  BENCHMARK("Decode")
+  {
+    detail::lpcDecode(bytes.data(), end, numFrames, numChannels, output.data());
+    return output.back();
+  };
+}
+
+} // namespace link_audio
+} // namespace ableton
@@ -0,0 +1,118 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/Latency.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+TEST_CASE("LatencyHistogram")
+{
+  using std::chrono::microseconds;
+
+  auto histogram = LatencyHistogram{};
+
+  SECTION("BinLimitsDouble")
+  {
+    CHECK(microseconds{125} == LatencyHistogram::binLimit(0));
+    CHECK(microseconds{250} == LatencyHistogram::binLimit(1));
+    CHECK(microseconds{125 << 14} == LatencyHistogram::binLimit(14));
+    CHECK(microseconds::max() == LatencyHistogram::binLimit(15));
+  }
+
+  SECTION("Empty")
+  {
+    CHECK(LatencyHistogram::Counts{} == histogram.counts());
+  }
+
+  SECTION("LatenciesCountInTheirBin")
+  {
+    histogram.add(microseconds{-10});
+    histogram.add(microseconds{0});
+    histogram.add(microseconds{124});
+    histogram.add(microseconds{125});
+    histogram.add(microseconds{249});
+    histogram.add(microseconds{1000});
+    histogram.add(microseconds{125 << 14});
+    histogram.add(std::chrono::seconds{100});
+
+    auto expected = LatencyHistogram::Counts{};
+    expected[0] = 3;
+    expected[1] = 2;
+    expected[4] = 1;
+    expected[15] = 2;
+    CHECK(expected == histogram.counts());
+  }
+}
+
+TEST_CASE("DelayEstimator")
+{
+  using std::chrono::microseconds;
+
+  auto estimator = DelayEstimator{};
+  CHECK(0 == estimator.numSamples());
+  CHECK(microseconds{0} == estimator.playoutDelay());
+
+  SECTION("FirstDelayIsTakenAsIs")
+  {
+    estimator(microseconds{1000});
+    CHECK(1 == estimator.numSamples());
+    CHECK(microseconds{1000} == estimator.delay());
+    CHECK(microseconds{500} == estimator.jitter());
+    CHECK(microseconds{3000} == estimator.playoutDelay());
+  }
+
+  SECTION("ConstantDelayLosesItsJitter")
+  {
+    for (auto i = 0; i < 200; ++i)
+    {
+      estimator(microseconds{1000});
+    }
+    CHECK(microseconds{1000} == estimator.delay());
+    CHECK(microseconds{0} == estimator.jitter());
+    CHECK(microseconds{1000} == estimator.playoutDelay());
+  }
+
+  SECTION("AlternatingDelay")
+  {
+    for (auto i = 0; i < 400; ++i)
+    {
+      estimator(microseconds{i % 2 == 0 ? 1000 : 3000});
+    }
+    CHECK(std::abs(estimator.delay().count() - 2000) < 150);
+    CHECK(std::abs(estimator.jitter().count() - 1000) < 150);
+    CHECK(estimator.playoutDelay() > microseconds{5500});
+  }
+
+  SECTION("FollowsChanges")
+  {
+    estimator(microseconds{1000});
+    for (auto i = 0; i < 200; ++i)
+    {
+      estimator(microseconds{5000});
+    }
+    CHECK(microseconds{5000} == estimator.delay());
+  }
+}
+
+} // namespace link_audio
+} // namespace ableton
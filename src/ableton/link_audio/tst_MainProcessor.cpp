@@ -18,7 +18,9 @@
  */
 
 #include <ableton/link/NodeId.hpp>
+#include <ableton/link/Timeline.hpp>
 #include <ableton/link_audio/AudioBuffer.hpp>
+#include <ableton/link_audio/ChannelRequests.hpp>
 #include <ableton/link_audio/MainProcessor.hpp>
 #include <ableton/link_audio/Sink.hpp>
 #include <ableton/link_audio/Source.hpp>
@@ -26,6 +28,7 @@
 #include <ableton/test/CatchWrapper.hpp>
 #include <ableton/test/serial_io/Fixture.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <optional>
 #include <vector>
@@ -45,16 +48,34 @@ TEST_CASE("MainProcessor")
     size_t numCalls = 0;
   };
 
+  static size_t numSends = 0;
+  numSends = 0;
+  static std::vector<size_t> sentSizes;
+  sentSizes.clear();
+  static std::vector<ChannelRequest> sentRequests;
+  sentRequests.clear();
+
   struct TestGetSender
   {
     using SendHandler = std::function<void(const uint8_t*, size_t)>;
 
     std::optional<SendHandler> forChannel(const Id&)
     {
-      return SendHandler{[this](const uint8_t*, size_t) { ++numSends; }};
+      return SendHandler{[](const uint8_t* pBytes, const size_t numBytes)
+                         {
+                           ++numSends;
+                           sentSizes.push_back(numBytes);
+                           const auto [header, payloadBegin] =
+                             v1::parseMessageHeader(pBytes, pBytes + numBytes);
+                           if (header.messageType == v1::kChannelRequest)
+                           {
+                             sentRequests.push_back(ChannelRequest::fromPayload(
+                               header.ident, payloadBegin, pBytes + numBytes));
+                           }
+                         }};
     }
 
-    size_t numSends = 0;
+    std::optional<SendHandler> forPeer(const Id& id) { return forChannel(id); }
   };
 
   struct TestGetNodeId
@@ -99,7 +120,7 @@ TEST_CASE("MainProcessor")
 
 
     pSink->setName("New Name");
-    fixture.advanceTime(Processor::kProcessTimerPeriod);
+    fixture.advanceTime(Processor::kHousekeepingPeriod);
 
     CHECK(channelsChanged.numCalls >= 1);
   }
@@ -112,7 +133,7 @@ TEST_CASE("MainProcessor")
       pSink, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
 
     pSink->setName("New Name");
-    fixture.advanceTime(Processor::kProcessTimerPeriod);
+    fixture.advanceTime(Processor::kHousekeepingPeriod);
 
     CHECK(channelsChanged.numCalls >= 1);
   }
@@ -126,11 +147,112 @@ TEST_CASE("MainProcessor")
 
     // Release the shared_ptr to the source that would be held by the API
     pSink.reset();
-    fixture.advanceTime(Processor::kProcessTimerPeriod);
+    fixture.advanceTime(Processor::kHousekeepingPeriod);
 
     CHECK(channelsChanged.numCalls >= 1);
   }
 
+  SECTION("Committed buffers are processed without waiting for the timer")
+  {
+    auto sinkId = Id::random<platforms::stl::Random>();
+    auto pSink = std::make_shared<Sink>(
+      std::string{"sinkC"}, 256, sinkId, processor.commitCallback());
+    processor.addSink(
+      pSink, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
+    processor.receiveChannelRequest(
+      ChannelRequest{Id::random<platforms::stl::Random>(), sinkId}, 10);
+    fixture.flush();
+
+    auto* pBuffer = pSink->retainBuffer();
+    REQUIRE(pBuffer != nullptr);
+    const auto timeline = link::Timeline{
+      link::Tempo{120.}, link::Beats{0.}, std::chrono::microseconds{0}};
+    pSink->releaseAndCommitBuffer(
+      timeline, Id::random<platforms::stl::Random>(), 0., 4., 128, 2, 44100);
+
+    CHECK(numSends == 0);
+    fixture.flush();
+    CHECK(numSends > 0);
+  }
+
+  SECTION("Doorbell is restarted for sinks added after the last one was removed")
+  {
+    auto pFirstSink = std::make_shared<Sink>(
+      std::string{"sinkD"}, 256, Id::random<platforms::stl::Random>());
+    processor.addSink(
+      pFirstSink, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
+    pFirstSink.reset();
+    fixture.advanceTime(Processor::kHousekeepingPeriod);
+    REQUIRE(processor.channelAnnouncements().channels.empty());
+
+    auto sinkId = Id::random<platforms::stl::Random>();
+    auto pSink = std::make_shared<Sink>(
+      std::string{"sinkE"}, 256, sinkId, processor.commitCallback());
+    processor.addSink(
+      pSink, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
+    processor.receiveChannelRequest(
+      ChannelRequest{Id::random<platforms::stl::Random>(), sinkId}, 10);
+    fixture.flush();
+
+    REQUIRE(pSink->retainBuffer() != nullptr);
+    const auto timeline = link::Timeline{
+      link::Tempo{120.}, link::Beats{0.}, std::chrono::microseconds{0}};
+    pSink->releaseAndCommitBuffer(
+      timeline, Id::random<platforms::stl::Random>(), 0., 4., 128, 2, 44100);
+    fixture.flush();
+    CHECK(numSends > 0);
+  }
+
+  const auto sendTimedFrames = [&](const size_t fecGroupSize)
+  {
+    auto sinkId = Id::random<platforms::stl::Random>();
+    auto pSink = std::make_shared<Sink>(std::string{"sinkF"},
+                                        4096,
+                                        sinkId,
+                                        processor.commitCallback(),
+                                        kDefaultSinkQueueDepth,
+                                        [] { return std::chrono::microseconds{1000}; });
+    pSink->setFecGroupSize(fecGroupSize);
+    processor.addSink(
+      pSink, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
+    processor.receiveChannelRequest(ChannelRequest{Id::random<platforms::stl::Random>(),
+                                                   sinkId,
+                                                   std::nullopt,
+                                                   Codec::kPCM_i16,
+                                                   true,
+                                                   true},
+                                    10);
+    fixture.flush();
+
+    REQUIRE(pSink->retainBuffer() != nullptr);
+    const auto timeline = link::Timeline{
+      link::Tempo{120.}, link::Beats{0.}, std::chrono::microseconds{0}};
+    pSink->releaseAndCommitBuffer(
+      timeline, Id::random<platforms::stl::Random>(), 0., 4., 2048, 2, 48000);
+    fixture.flush();
+  };
+
+  SECTION("Timed messages fit into the default message size")
+  {
+    sendTimedFrames(0);
+
+    // The timing takes the place of audio
+    REQUIRE(!sentSizes.empty());
+    const auto maxSize = *std::max_element(sentSizes.begin(), sentSizes.end());
+    CHECK(v1::kDefaultMaxAudioBufferMessageSize >= maxSize);
+    CHECK(v1::kDefaultMaxAudioBufferMessageSize - AudioBufferTiming::kSize < maxSize);
+  }
+
+  SECTION("Parity messages fit into the default message size")
+  {
+    sendTimedFrames(AudioParity::kMaxGroupSize);
+
+    // Full audio buffer messages and parity messages
+    REQUIRE(sentSizes.size() > AudioParity::kMaxGroupSize);
+    CHECK(v1::kDefaultMaxAudioBufferMessageSize
+          >= *std::max_element(sentSizes.begin(), sentSizes.end()));
+  }
+
   SECTION("Source removed when API releases shared_ptr")
   {
     size_t numCallbacks = 0;
@@ -142,7 +264,7 @@ TEST_CASE("MainProcessor")
     processor.addSource(
       pSource, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
 
-    fixture.advanceTime(Processor::kProcessTimerPeriod);
+    fixture.advanceTime(Processor::kHousekeepingPeriod);
 
     // Attempt to deliver audio to that source id; callback should not run
     AudioBuffer audio;
@@ -165,13 +287,99 @@ TEST_CASE("MainProcessor")
 
     // Release the shared_ptr to the source that would be held by the API
     pSource.reset();
-    fixture.advanceTime(Processor::kProcessTimerPeriod);
+    fixture.advanceTime(Processor::kHousekeepingPeriod);
 
     processor.receiveAudioBuffer(payloadBegin, endIt);
 
     // Send calback has not been called again
     CHECK(numCallbacks == 1);
   }
+
+  SECTION("All sources of a channel receive its buffers")
+  {
+    auto numCallbacks = std::vector<size_t>(3);
+    const auto channelId = Id::random<platforms::stl::Random>();
+    auto pSources = std::vector<std::shared_ptr<Source>>{};
+    for (auto i = size_t{0}; i < numCallbacks.size(); ++i)
+    {
+      pSources.push_back(std::make_shared<Source>(
+        channelId, [&, i](BufferCallbackHandle<Buffer<int16_t>>) { ++numCallbacks[i]; }));
+      processor.addSource(pSources.back(),
+                          util::injectVal(TestGetSender{}),
+                          util::injectVal(TestGetNodeId{}));
+    }
+    auto pOtherSource = std::make_shared<Source>(
+      Id::random<platforms::stl::Random>(),
+      [&](BufferCallbackHandle<Buffer<int16_t>>) { ++numCallbacks[0]; });
+    processor.addSource(
+      pOtherSource, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
+
+    AudioBuffer audio;
+    audio.channelId = channelId;
+    audio.sessionId = Id::random<platforms::stl::Random>();
+    audio.codec = Codec::kPCM_i16;
+    audio.sampleRate = 44100;
+    audio.numChannels = 2;
+    audio.chunks = {AudioBuffer::Chunk{1, 4, link::Beats{0.0}, link::Tempo{120.0}}};
+    audio.numBytes =
+      static_cast<uint16_t>(audio.numFrames() * audio.numChannels * sizeof(int16_t));
+    v1::MessageBuffer message;
+    auto endIt =
+      v1::audioBufferMessage(TestGetNodeId{}.operator()(), audio, message.begin());
+    auto payloadBegin = v1::parseMessageHeader(message.begin(), endIt).second;
+    processor.receiveAudioBuffer(payloadBegin, endIt);
+
+    CHECK(numCallbacks == std::vector<size_t>{1, 1, 1});
+
+    // Removing one source renews the request of the others
+    sentRequests.clear();
+    pSources.pop_back();
+    fixture.advanceTime(Processor::kHousekeepingPeriod);
+    REQUIRE(sentRequests.size() == 1);
+    CHECK(channelId == sentRequests[0].channelId);
+
+    audio.chunks = {AudioBuffer::Chunk{2, 4, link::Beats{0.0}, link::Tempo{120.0}}};
+    endIt = v1::audioBufferMessage(TestGetNodeId{}.operator()(), audio, message.begin());
+    payloadBegin = v1::parseMessageHeader(message.begin(), endIt).second;
+    processor.receiveAudioBuffer(payloadBegin, endIt);
+
+    CHECK(numCallbacks == std::vector<size_t>{2, 2, 1});
+  }
+
+  SECTION("Sources of a channel share one request")
+  {
+    const auto channelId = Id::random<platforms::stl::Random>();
+    const auto addSource = [&]
+    {
+      auto pSource =
+        std::make_shared<Source>(channelId, [](BufferCallbackHandle<Buffer<int16_t>>) {});
+      processor.addSource(
+        pSource, util::injectVal(TestGetSender{}), util::injectVal(TestGetNodeId{}));
+      return pSource;
+    };
+    const auto lastCodec = [&]
+    {
+      fixture.advanceTime(Processor::kHousekeepingPeriod);
+      REQUIRE(!sentRequests.empty());
+      CHECK(channelId == sentRequests.back().channelId);
+      return sentRequests.back().codec;
+    };
+
+    auto pLowBandwidth = addSource();
+    pLowBandwidth->setLowBandwidthEnabled(true);
+    CHECK(Codec::kADPCM_i4 == lastCodec());
+
+    // The stream follows the source that asks for the most exact audio
+    auto pLossless = addSource();
+    pLossless->setLosslessCompressionEnabled(true);
+    CHECK(Codec::kLPC_i16 == lastCodec());
+
+    auto pPCM = addSource();
+    CHECK(Codec::kPCM_i16 == lastCodec());
+
+    pPCM.reset();
+    CHECK(Codec::kLPC_i16 == lastCodec());
+  }
 }
 
 } // namespace link_audio
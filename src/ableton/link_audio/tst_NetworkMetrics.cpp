@@ -0,0 +1,82 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/NetworkMetrics.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+TEST_CASE("NetworkMetricsFilter")
+{
+  using std::chrono::microseconds;
+
+  auto filter = NetworkMetricsFilter{};
+
+  SECTION("Empty")
+  {
+    const auto stats = filter.stats();
+    CHECK(0 == stats.numSamples);
+    CHECK(microseconds{0} == stats.roundTripTime);
+    CHECK(microseconds{0} == stats.jitter);
+    CHECK(0.0 == filter.quality());
+  }
+
+  SECTION("MeanAndDeviation")
+  {
+    filter(microseconds{100});
+    filter(microseconds{300});
+    const auto stats = filter.stats();
+    CHECK(2 == stats.numSamples);
+    CHECK(microseconds{200} == stats.roundTripTime);
+    CHECK(microseconds{100} == stats.jitter);
+  }
+
+  SECTION("OnlyTheLastTenTimesCount")
+  {
+    for (auto i = 0; i < 10; ++i)
+    {
+      filter(microseconds{100000});
+    }
+    for (auto i = 0; i < 10; ++i)
+    {
+      filter(i % 2 == 0 ? microseconds{400} : microseconds{600});
+    }
+    const auto stats = filter.stats();
+    CHECK(10 == stats.numSamples);
+    CHECK(microseconds{500} == stats.roundTripTime);
+    CHECK(microseconds{100} == stats.jitter);
+  }
+
+  SECTION("FasterIsBetter")
+  {
+    auto slower = NetworkMetricsFilter{};
+    for (auto i = 0; i < 10; ++i)
+    {
+      filter(microseconds{500});
+      slower(microseconds{1000});
+    }
+    CHECK(slower.quality() < filter.quality());
+  }
+}
+
+} // namespace link_audio
+} // namespace ableton
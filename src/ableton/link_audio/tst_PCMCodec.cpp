@@ -22,6 +22,7 @@
 #include <ableton/platforms/stl/Random.hpp>
 #include <ableton/test/CatchWrapper.hpp>
 #include <array>
+#include <vector>
 
 namespace ableton
 {
@@ -95,6 +96,77 @@ TEST_CASE("PCMCodec")
     CHECK(beginBeats == successor.beginBeats);
     CHECK(tempo == successor.tempo);
   }
+
+  SECTION("NetworkByteOrder")
+  {
+    // Use a sample count that is not a multiple of any vector width
+    const auto numSamples = 251u;
+    auto samples = Samples(numSamples);
+    std::generate(samples.begin(), samples.end(), [&] { return random(); });
+
+    auto sender = Sender{};
+    auto encoder = TestEncoder(util::injectRef(sender), {});
+    const AudioBuffer::Chunks chunks = {
+      AudioBuffer::Chunk{1u, numSamples, Beats{0.}, Tempo{120.}}};
+    encoder(samples.data(), chunks, 1, 48000, Id{});
+
+    auto expected = std::vector<uint8_t>(numSamples * sizeof(SampleFormat));
+    auto it = expected.begin();
+    for (const auto sample : samples)
+    {
+      it = discovery::toNetworkByteStream(sample, it);
+    }
+    CHECK(expected.size() == sender.buffer.numBytes);
+    CHECK(std::equal(expected.begin(), expected.end(), sender.buffer.bytes.begin()));
+
+    auto decoder = TestDecoder(util::injectRef(successor), 512);
+    decoder(sender.buffer);
+    CHECK(samples == successor.cache);
+  }
+}
+
+TEST_CASE("PCMCodec | Benchmark", "[.benchmark]")
+{
+  const auto numSamples = AudioBuffer::kMaxAudioBytes / sizeof(SampleFormat);
+  auto samples = Samples(numSamples);
+  platforms::stl::Random random;
+  std::generate(samples.begin(), samples.end(), [&] { return random(); });
+  auto bytes = std::array<uint8_t, AudioBuffer::kMaxAudioBytes>{};
+
+  BENCHMARK("Encode per sample")
+  {
+    auto it = bytes.begin();
+    for (const auto sample : samples)
+    {
+      it = discovery::toNetworkByteStream(sample, it);
+    }
+    return it;
+  };
+
+  BENCHMARK("Encode bulk")
+  {
+    return detail::samplesToNetworkByteStream(samples.data(), numSamples, bytes.data());
+  };
+
+  BENCHMARK("Decode per sample")
+  {
+    auto it = bytes.cbegin();
+    const auto end = bytes.cbegin() + numSamples * sizeof(SampleFormat);
+    for (auto i = 0u; it != end; ++i)
+    {
+      auto [sample, next] =
+        discovery::Deserialize<SampleFormat>::fromNetworkByteStream(it, end);
+      samples[i] = sample;
+      it = next;
+    }
+    return samples.back();
+  };
+
+  BENCHMARK("Decode bulk")
+  {
+    detail::samplesFromNetworkByteStream(bytes.data(), numSamples, samples.data());
+    return samples.back();
+  };
 }
 
 } // namespace link_audio
@@ -0,0 +1,181 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/Parity.hpp>
+#include <ableton/platforms/stl/Random.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace
+{
+
+using Random = ableton::platforms::stl::Random;
+
+// Buffers of different sizes, so the parity has to cover the largest one
+std::vector<AudioBuffer> makeBuffers(const Id& channelId, const size_t numBuffers)
+{
+  auto buffers = std::vector<AudioBuffer>{};
+  auto random = Random{};
+  for (auto i = size_t{0}; i < numBuffers; ++i)
+  {
+    auto buffer = AudioBuffer{};
+    buffer.channelId = channelId;
+    buffer.chunks = {
+      {100 + i, static_cast<uint16_t>(10 + i), Beats{double(i)}, Tempo{120.}}};
+    buffer.codec = Codec::kPCM_i16;
+    buffer.sampleRate = 48000;
+    buffer.numChannels = 1;
+    buffer.numBytes = static_cast<uint16_t>(2 * (10 + i));
+    std::generate(buffer.bytes.begin(), buffer.bytes.end(), [&] { return random(); });
+    buffers.push_back(buffer);
+  }
+  return buffers;
+}
+
+AudioParity encode(const std::vector<AudioBuffer>& buffers)
+{
+  auto encoder = ParityEncoder{};
+  encoder.setGroupSize(static_cast<uint32_t>(buffers.size()));
+  auto bytes = std::array<uint8_t, v1::kMaxPayloadSize>{};
+  for (auto i = size_t{0}; i < buffers.size(); ++i)
+  {
+    const auto end = toNetworkByteStream(buffers[i], bytes.begin());
+    const auto isComplete = encoder.add(
+      buffers[i], bytes.data(), static_cast<size_t>(std::distance(bytes.begin(), end)));
+    CHECK((i + 1 == buffers.size()) == isComplete);
+  }
+  return encoder.parity();
+}
+
+} // namespace
+
+TEST_CASE("AudioParity | RoundtripByteStreamEncoding")
+{
+  const auto parity = encode(makeBuffers(Id::random<Random>(), 4));
+  CHECK(AudioParity::overhead(4) + parity.numBytes == sizeInByteStream(parity));
+
+  auto bytes = std::vector<uint8_t>(sizeInByteStream(parity));
+  CHECK(bytes.end() == toNetworkByteStream(parity, bytes.begin()));
+
+  auto deserialized = AudioParity{};
+  CHECK(bytes.end()
+        == AudioParity::fromNetworkByteStream(deserialized, bytes.begin(), bytes.end()));
+  CHECK(parity.channelId == deserialized.channelId);
+  CHECK(parity.counts == deserialized.counts);
+  CHECK(parity.sizeParity == deserialized.sizeParity);
+  CHECK(parity.numBytes == deserialized.numBytes);
+  CHECK(std::equal(parity.bytes.begin(),
+                   parity.bytes.begin() + parity.numBytes,
+                   deserialized.bytes.begin()));
+
+  SECTION("Truncated")
+  {
+    CHECK_THROWS_AS(
+      AudioParity::fromNetworkByteStream(deserialized, bytes.begin(), bytes.end() - 1),
+      std::range_error);
+  }
+}
+
+TEST_CASE("ParityDecoder")
+{
+  const auto channelId = Id::random<Random>();
+  const auto buffers = makeBuffers(channelId, 5);
+  const auto parity = encode(buffers);
+  auto decoder = ParityDecoder{};
+
+  // Buffers are only remembered once the stream is known to carry parity
+  const auto receiveParity = [&]
+  {
+    decoder.reset();
+    CHECK(0 == decoder.groupSize());
+    CHECK(decoder.recover(parity) == nullptr);
+    CHECK(5 == decoder.groupSize());
+  };
+
+  SECTION("SingleLostBufferIsRebuilt")
+  {
+    for (auto lost = size_t{0}; lost < buffers.size(); ++lost)
+    {
+      receiveParity();
+      for (auto i = size_t{0}; i < buffers.size(); ++i)
+      {
+        if (i != lost)
+        {
+          decoder.receive(buffers[i]);
+        }
+      }
+
+      const auto pRecovered = decoder.recover(parity);
+      REQUIRE(pRecovered != nullptr);
+      CHECK(buffers[lost] == *pRecovered);
+    }
+  }
+
+  SECTION("NothingIsRebuiltWithoutLosses")
+  {
+    receiveParity();
+    for (const auto& buffer : buffers)
+    {
+      decoder.receive(buffer);
+    }
+    CHECK(decoder.recover(parity) == nullptr);
+  }
+
+  SECTION("NothingIsRebuiltWithTwoLosses")
+  {
+    receiveParity();
+    for (auto i = size_t{2}; i < buffers.size(); ++i)
+    {
+      decoder.receive(buffers[i]);
+    }
+    CHECK(decoder.recover(parity) == nullptr);
+  }
+
+  SECTION("NothingIsRememberedWithoutParity")
+  {
+    for (auto i = size_t{1}; i < buffers.size(); ++i)
+    {
+      decoder.receive(buffers[i]);
+    }
+    CHECK(decoder.recover(parity) == nullptr);
+  }
+}
+
+TEST_CASE("ParityEncoder | Disabled")
+{
+  auto encoder = ParityEncoder{};
+  const auto buffers = makeBuffers(Id::random<Random>(), 3);
+  auto bytes = std::array<uint8_t, v1::kMaxPayloadSize>{};
+
+  encoder.setGroupSize(1);
+  CHECK(0 == encoder.groupSize());
+  for (const auto& buffer : buffers)
+  {
+    const auto end = toNetworkByteStream(buffer, bytes.begin());
+    CHECK(!encoder.add(
+      buffer, bytes.data(), static_cast<size_t>(std::distance(bytes.begin(), end))));
+  }
+}
+
+} // namespace link_audio
+} // namespace ableton
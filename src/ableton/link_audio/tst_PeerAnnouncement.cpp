@@ -78,6 +78,34 @@ TEST_CASE("PeerAnnouncement")
     CHECK(deserialized.peerInfo == peerInfo);
     CHECK(deserialized.channels == channels);
   }
+
+  SECTION("RoundtripWithMulticastGroups")
+  {
+    using Random = ableton::platforms::stl::Random;
+
+    const auto nodeId = link::NodeId::random<Random>();
+    const auto sessionId = link::SessionId::random<Random>();
+    const auto channelId1 = Id::random<Random>();
+    const auto channelId2 = Id::random<Random>();
+    const auto channels = ChannelAnnouncements{
+      {ChannelAnnouncement{"Channel1", channelId1, multicastGroup(channelId1)},
+       ChannelAnnouncement{"Channel2", channelId2, std::nullopt}}};
+
+    const auto announcement =
+      PeerAnnouncement{nodeId, sessionId, PeerInfo{"TestPeer"}, channels};
+
+    auto payload = toPayload(announcement);
+    std::vector<uint8_t> byteStream(sizeInByteStream(payload));
+    const auto end = toNetworkByteStream(payload, byteStream.begin());
+    CHECK(byteStream.end() == end);
+
+    const auto deserialized =
+      PeerAnnouncement::fromPayload(nodeId, byteStream.begin(), byteStream.end());
+
+    CHECK(announcement == deserialized);
+    CHECK(multicastGroup(channelId1) == deserialized.channels.channels[0].multicastGroup);
+    CHECK(!deserialized.channels.channels[1].multicastGroup);
+  }
 }
 
 } // namespace link_audio
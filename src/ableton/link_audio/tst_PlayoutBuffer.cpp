@@ -0,0 +1,236 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/PlayoutBuffer.hpp>
+#include <ableton/platforms/stl/Random.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace
+{
+
+// At 60 bpm and 50 kHz a frame lasts exactly 20 micro beats
+constexpr auto kSampleRate = uint32_t{50000};
+constexpr auto kNumFrames = uint32_t{100};
+
+link::Beats beatsAtFrame(const int64_t frame)
+{
+  return link::Beats{int64_t{20} * frame};
+}
+
+// Mono chunks of a ramp that increases by 10 per frame
+struct Writer
+{
+  Writer()
+    : buffer(kNumFrames)
+  {
+    buffer.mSampleRate = kSampleRate;
+    buffer.mNumChannels = 1;
+    buffer.mNumFrames = kNumFrames;
+    buffer.mTempo = link::Tempo{60.};
+    buffer.mSessionId = sessionId;
+  }
+
+  bool operator()(PlayoutBuffer& playoutBuffer)
+  {
+    for (auto i = size_t{0}; i < kNumFrames; ++i)
+    {
+      buffer.mSamples[i] = static_cast<int16_t>((frame + i) * 10 % 32768);
+    }
+    buffer.mBeginBeats = beatsAtFrame(static_cast<int64_t>(frame));
+    buffer.mCount = frame / kNumFrames;
+    frame += kNumFrames;
+    return playoutBuffer.write({buffer, buffer.mSamples.data()});
+  }
+
+  Id sessionId;
+  Buffer<int16_t> buffer;
+  size_t frame = 0;
+};
+
+float rampAt(const double frame)
+{
+  return static_cast<float>(frame * 10. / 32768.);
+}
+
+} // namespace
+
+TEST_CASE("PlayoutBuffer")
+{
+  auto pPlayoutBuffer = std::make_unique<PlayoutBuffer>();
+  auto& playoutBuffer = *pPlayoutBuffer;
+  auto write = Writer{};
+  for (auto i = 0; i < 10; ++i)
+  {
+    CHECK(write(playoutBuffer));
+  }
+
+  auto output = std::vector<float>(400);
+
+  SECTION("ReadsTheBeatRange")
+  {
+    // Continuous reads across chunk boundaries
+    for (auto begin = int64_t{250}; begin < 650; begin += 80)
+    {
+      REQUIRE(playoutBuffer.read(write.sessionId,
+                                 beatsAtFrame(begin),
+                                 beatsAtFrame(begin + 80),
+                                 80,
+                                 1,
+                                 output.data()));
+      for (auto i = 0; i < 80; ++i)
+      {
+        CHECK(rampAt(double(begin + i)) == Approx(output[size_t(i)]));
+      }
+    }
+    CHECK(std::chrono::microseconds{(1000 - 650) * 20} == playoutBuffer.bufferedTime());
+  }
+
+  SECTION("CopiesMonoToAllChannels")
+  {
+    REQUIRE(playoutBuffer.read(
+      write.sessionId, beatsAtFrame(100), beatsAtFrame(200), 100, 2, output.data()));
+    for (auto i = 0; i < 100; ++i)
+    {
+      CHECK(rampAt(100. + i) == Approx(output[size_t(2 * i)]));
+      CHECK(output[size_t(2 * i)] == output[size_t(2 * i + 1)]);
+    }
+  }
+
+  SECTION("Resamples")
+  {
+    // Twice as many output frames as there are frames in the range
+    REQUIRE(playoutBuffer.read(
+      write.sessionId, beatsAtFrame(300), beatsAtFrame(450), 300, 1, output.data()));
+    for (auto i = 0; i < 300; ++i)
+    {
+      CHECK(rampAt(300. + 0.5 * i) == Approx(output[size_t(i)]));
+    }
+  }
+
+  SECTION("SilenceWhenNotBuffered")
+  {
+    std::fill(output.begin(), output.end(), 1.f);
+    CHECK(!playoutBuffer.read(
+      write.sessionId, beatsAtFrame(950), beatsAtFrame(1050), 100, 1, output.data()));
+    CHECK(std::all_of(output.begin(),
+                      output.begin() + 100,
+                      [](const float sample) { return sample == 0.f; }));
+
+    // Once written, the range can be read
+    CHECK(write(playoutBuffer));
+    CHECK(playoutBuffer.read(
+      write.sessionId, beatsAtFrame(950), beatsAtFrame(1050), 100, 1, output.data()));
+    CHECK(rampAt(950.) == Approx(output[0]));
+  }
+
+  SECTION("SilenceForOtherSessions")
+  {
+    CHECK(!playoutBuffer.read(Id::random<platforms::stl::Random>(),
+                              beatsAtFrame(100),
+                              beatsAtFrame(200),
+                              100,
+                              1,
+                              output.data()));
+  }
+
+  SECTION("DropsChunksWhenFull")
+  {
+    auto numWritten = size_t{10};
+    while (write(playoutBuffer))
+    {
+      ++numWritten;
+    }
+    CHECK(PlayoutBuffer::kNumSegments == numWritten);
+
+    // Reading far ahead releases all chunks before the range
+    const auto end = static_cast<int64_t>(numWritten * kNumFrames);
+    CHECK(playoutBuffer.read(write.sessionId,
+                             beatsAtFrame(end - 100),
+                             beatsAtFrame(end),
+                             100,
+                             1,
+                             output.data()));
+    write.frame = numWritten * kNumFrames;
+    CHECK(write(playoutBuffer));
+  }
+}
+
+TEST_CASE("PlayoutBuffer | Multichannel")
+{
+  // Four channels of the ramp, offset by 1000 per channel
+  constexpr auto kNumChannels = uint32_t{4};
+  auto buffer = Buffer<int16_t>(kNumFrames * kNumChannels);
+  buffer.mSampleRate = kSampleRate;
+  buffer.mNumChannels = kNumChannels;
+  buffer.mNumFrames = kNumFrames;
+  buffer.mTempo = link::Tempo{60.};
+  buffer.mSessionId = Id::random<platforms::stl::Random>();
+  for (auto i = size_t{0}; i < kNumFrames * kNumChannels; ++i)
+  {
+    buffer.mSamples[i] =
+      static_cast<int16_t>(i / kNumChannels * 10 + i % kNumChannels * 1000);
+  }
+
+  auto pPlayoutBuffer = std::make_unique<PlayoutBuffer>();
+  REQUIRE(pPlayoutBuffer->write({buffer, buffer.mSamples.data()}));
+
+  const auto expected = [](const size_t frame, const size_t channel)
+  { return rampAt(double(frame)) + rampAt(double(channel * 100)); };
+
+  SECTION("Interleaved")
+  {
+    auto output = std::vector<float>(kNumFrames * kNumChannels);
+    REQUIRE(pPlayoutBuffer->read(buffer.mSessionId,
+                                 beatsAtFrame(0),
+                                 beatsAtFrame(kNumFrames),
+                                 kNumFrames,
+                                 kNumChannels,
+                                 output.data()));
+    for (auto i = size_t{0}; i < output.size(); ++i)
+    {
+      CHECK(expected(i / kNumChannels, i % kNumChannels) == Approx(output[i]));
+    }
+  }
+
+  SECTION("PlanarChannelSubset")
+  {
+    const auto channels = std::array<size_t, 2>{{3, 1}};
+    auto left = std::vector<float>(kNumFrames);
+    auto right = std::vector<float>(kNumFrames);
+    const auto ppOut = std::array<float*, 2>{{left.data(), right.data()}};
+    REQUIRE(pPlayoutBuffer->read(buffer.mSessionId,
+                                 beatsAtFrame(0),
+                                 beatsAtFrame(kNumFrames),
+                                 kNumFrames,
+                                 {2, nullptr, ppOut.data(), channels.data()}));
+    for (auto frame = size_t{0}; frame < kNumFrames; ++frame)
+    {
+      CHECK(expected(frame, 3) == Approx(left[frame]));
+      CHECK(expected(frame, 1) == Approx(right[frame]));
+    }
+  }
+}
+
+} // namespace link_audio
+} // namespace ableton
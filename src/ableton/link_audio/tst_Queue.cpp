@@ -255,5 +255,81 @@ TEST_CASE("Queue")
   }
 }
 
+TEST_CASE("Queue | Benchmark", "[.benchmark]")
+{
+  // Items are handed from one thread to another, which the scheduler usually puts on
+  // different cores
+  constexpr auto kNumItems = size_t{1} << 16;
+
+  const auto push = [](Queue<size_t>::Writer& writer, const size_t value)
+  {
+    while (!writer.retainSlot())
+    {
+      std::this_thread::yield();
+    }
+    *writer[0] = value;
+    writer.releaseSlot();
+  };
+
+  const auto pop = [](Queue<size_t>::Reader& reader)
+  {
+    while (!reader.retainSlot())
+    {
+      std::this_thread::yield();
+    }
+    const auto value = *reader[0];
+    reader.releaseSlot();
+    return value;
+  };
+
+  BENCHMARK("Throughput of 65536 items")
+  {
+    auto queue = Queue<size_t>(128, {});
+    auto writerThread = std::thread(
+      [&, writer = queue.writer()]() mutable
+      {
+        for (auto i = size_t{0}; i < kNumItems; ++i)
+        {
+          push(writer, i);
+        }
+      });
+
+    auto reader = queue.reader();
+    auto sum = size_t{0};
+    for (auto i = size_t{0}; i < kNumItems; ++i)
+    {
+      sum += pop(reader);
+    }
+    writerThread.join();
+    return sum;
+  };
+
+  BENCHMARK("Latency of 4096 round trips")
+  {
+    constexpr auto kNumRoundTrips = size_t{4096};
+    auto requests = Queue<size_t>(1, {});
+    auto responses = Queue<size_t>(1, {});
+    auto echoThread = std::thread(
+      [&, reader = requests.reader(), writer = responses.writer()]() mutable
+      {
+        for (auto i = size_t{0}; i < kNumRoundTrips; ++i)
+        {
+          push(writer, pop(reader));
+        }
+      });
+
+    auto writer = requests.writer();
+    auto reader = responses.reader();
+    auto sum = size_t{0};
+    for (auto i = size_t{0}; i < kNumRoundTrips; ++i)
+    {
+      push(writer, i);
+      sum += pop(reader);
+    }
+    echoThread.join();
+    return sum;
+  };
+}
+
 } // namespace link_audio
 } // namespace ableton
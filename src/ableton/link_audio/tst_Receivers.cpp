@@ -17,10 +17,16 @@
  *  please contact <link-devs@ableton.com>.
  */
 
+#include <ableton/link_audio/ChannelAnnouncements.hpp>
 #include <ableton/link_audio/Receivers.hpp>
 #include <ableton/test/CatchWrapper.hpp>
 #include <ableton/test/serial_io/Fixture.hpp>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace ableton
 {
@@ -111,5 +117,278 @@ TEST_CASE("Receivers")
   }
 }
 
+TEST_CASE("Receivers | Batched")
+{
+  auto id = Id{{{0, 0, 0, 0, 0, 0, 0, 0}}};
+  auto id1 = Id{{{0, 0, 0, 0, 0, 0, 0, 1}}};
+  auto id2 = Id{{{0, 0, 0, 0, 0, 0, 0, 2}}};
+  auto id3 = Id{{{0, 0, 0, 0, 0, 0, 0, 3}}};
+
+  struct Interface
+  {
+    std::size_t send(const discovery::UdpDatagram* pDatagrams, const size_t numDatagrams)
+    {
+      batches.emplace_back(pDatagrams, pDatagrams + numDatagrams);
+      return numDatagrams;
+    }
+
+    std::vector<std::vector<discovery::UdpDatagram>> batches;
+  };
+
+  struct SendHandler
+  {
+    std::size_t operator()(const uint8_t*, size_t) { return 0; }
+
+    discovery::UdpEndpoint endpoint() const { return mEndpoint; }
+
+    std::shared_ptr<Interface> interface() const { return mpInterface; }
+
+    discovery::UdpEndpoint mEndpoint;
+    std::shared_ptr<Interface> mpInterface;
+  };
+
+  struct GetSender
+  {
+    std::optional<SendHandler> forPeer(const Id& id) { return mSendHandlers.at(id); }
+
+    std::optional<SendHandler> forChannel(const Id& id) { return mSendHandlers.at(id); }
+
+    std::map<Id, SendHandler> mSendHandlers;
+  };
+
+  const auto endpoint1 = discovery::UdpEndpoint{discovery::makeAddress("1.1.1.1"), 1};
+  const auto endpoint2 = discovery::UdpEndpoint{discovery::makeAddress("2.2.2.2"), 2};
+  const auto endpoint3 = discovery::UdpEndpoint{discovery::makeAddress("3.3.3.3"), 3};
+  auto pInterfaceA = std::make_shared<Interface>();
+  auto pInterfaceB = std::make_shared<Interface>();
+
+  auto getSender = GetSender{};
+  getSender.mSendHandlers[id1] = SendHandler{endpoint1, pInterfaceA};
+  getSender.mSendHandlers[id2] = SendHandler{endpoint2, pInterfaceB};
+  getSender.mSendHandlers[id3] = SendHandler{endpoint3, pInterfaceA};
+
+  test::serial_io::Fixture io;
+
+  auto receivers = Receivers<GetSender&, test::serial_io::Context>(
+    util::injectVal(io.makeIoContext()), util::injectRef(getSender));
+  receivers.receiveChannelRequest(ChannelRequest{id1, id}, 10);
+  receivers.receiveChannelRequest(ChannelRequest{id2, id}, 10);
+  receivers.receiveChannelRequest(ChannelRequest{id3, id}, 10);
+
+  const auto data = std::array<uint8_t, 3>{{1, 2, 3}};
+  using Packet = Receivers<GetSender&, test::serial_io::Context>::Packet;
+  const auto packets = std::array<Packet, 2>{{{data.data(), 1}, {data.data(), 3}}};
+  receivers.send(packets.data(), packets.size());
+
+  // Every interface sends all of its datagrams at once, in packet order
+  REQUIRE(1 == pInterfaceA->batches.size());
+  const auto& batchA = pInterfaceA->batches[0];
+  REQUIRE(4 == batchA.size());
+  CHECK(endpoint1 == batchA[0].to);
+  CHECK(1 == batchA[0].numBytes);
+  CHECK(endpoint3 == batchA[1].to);
+  CHECK(1 == batchA[1].numBytes);
+  CHECK(endpoint1 == batchA[2].to);
+  CHECK(3 == batchA[2].numBytes);
+  CHECK(endpoint3 == batchA[3].to);
+  CHECK(3 == batchA[3].numBytes);
+
+  REQUIRE(1 == pInterfaceB->batches.size());
+  const auto& batchB = pInterfaceB->batches[0];
+  REQUIRE(2 == batchB.size());
+  CHECK(endpoint2 == batchB[0].to);
+  CHECK(endpoint2 == batchB[1].to);
+  CHECK(data.data() == batchB[1].pData);
+}
+
+TEST_CASE("Receivers | Multicast")
+{
+  auto id = Id{{{0, 0, 0, 0, 0, 0, 0, 0}}};
+  auto id1 = Id{{{0, 0, 0, 0, 0, 0, 0, 1}}};
+  auto id2 = Id{{{0, 0, 0, 0, 0, 0, 0, 2}}};
+  auto id3 = Id{{{0, 0, 0, 0, 0, 0, 0, 3}}};
+
+  struct Interface
+  {
+    std::size_t send(const discovery::UdpDatagram* pDatagrams, const size_t numDatagrams)
+    {
+      batches.emplace_back(pDatagrams, pDatagrams + numDatagrams);
+      return numDatagrams;
+    }
+
+    std::vector<std::vector<discovery::UdpDatagram>> batches;
+  };
+
+  struct SendHandler
+  {
+    std::size_t operator()(const uint8_t*, size_t) { return 0; }
+
+    discovery::UdpEndpoint endpoint() const { return mEndpoint; }
+
+    std::shared_ptr<Interface> interface() const { return mpInterface; }
+
+    discovery::UdpEndpoint mEndpoint;
+    std::shared_ptr<Interface> mpInterface;
+  };
+
+  struct GetSender
+  {
+    std::optional<SendHandler> forPeer(const Id& id) { return mSendHandlers.at(id); }
+
+    std::optional<SendHandler> forChannel(const Id& id) { return mSendHandlers.at(id); }
+
+    std::map<Id, SendHandler> mSendHandlers;
+  };
+
+  const auto endpoint1 = discovery::UdpEndpoint{discovery::makeAddress("1.1.1.1"), 1};
+  const auto endpoint2 = discovery::UdpEndpoint{discovery::makeAddress("2.2.2.2"), 2};
+  const auto endpoint3 = discovery::UdpEndpoint{discovery::makeAddress("3.3.3.3"), 3};
+  const auto group = multicastGroup(id);
+  auto pInterface = std::make_shared<Interface>();
+
+  auto getSender = GetSender{};
+  getSender.mSendHandlers[id1] = SendHandler{endpoint1, pInterface};
+  getSender.mSendHandlers[id2] = SendHandler{endpoint2, pInterface};
+  getSender.mSendHandlers[id3] = SendHandler{endpoint3, pInterface};
+
+  test::serial_io::Fixture io;
+
+  auto receivers = Receivers<GetSender&, test::serial_io::Context>(
+    util::injectVal(io.makeIoContext()), util::injectRef(getSender));
+  receivers.receiveChannelRequest(ChannelRequest{id1, id, group}, 10);
+  receivers.receiveChannelRequest(ChannelRequest{id2, id, group}, 10);
+  receivers.receiveChannelRequest(ChannelRequest{id3, id, std::nullopt}, 10);
+
+  const auto data = std::array<uint8_t, 3>{{1, 2, 3}};
+  using Packet = Receivers<GetSender&, test::serial_io::Context>::Packet;
+  const auto packets = std::array<Packet, 2>{{{data.data(), 1}, {data.data(), 3}}};
+
+  SECTION("MulticastReceiversShareOneDatagram")
+  {
+    receivers.setMulticastGroup(group);
+    const auto result = receivers.send(packets.data(), packets.size());
+    CHECK(4 == result.numPackets);
+    CHECK(8 == result.numBytes);
+    CHECK(3 == receivers.numReceivers());
+    CHECK(2 == receivers.numMulticastReceivers());
+
+    REQUIRE(1 == pInterface->batches.size());
+    const auto& batch = pInterface->batches[0];
+    REQUIRE(4 == batch.size());
+    CHECK(group == batch[0].to);
+    CHECK(1 == batch[0].numBytes);
+    CHECK(endpoint3 == batch[1].to);
+    CHECK(1 == batch[1].numBytes);
+    CHECK(group == batch[2].to);
+    CHECK(3 == batch[2].numBytes);
+    CHECK(endpoint3 == batch[3].to);
+    CHECK(3 == batch[3].numBytes);
+  }
+
+  SECTION("UnicastWithoutMulticastGroup")
+  {
+    const auto result = receivers.send(packets.data(), packets.size());
+    CHECK(6 == result.numPackets);
+    CHECK(12 == result.numBytes);
+    CHECK(0 == receivers.numMulticastReceivers());
+
+    REQUIRE(1 == pInterface->batches.size());
+    const auto& batch = pInterface->batches[0];
+    REQUIRE(6 == batch.size());
+    CHECK(std::none_of(
+      batch.begin(), batch.end(), [&](const auto& d) { return d.to == group; }));
+  }
+
+  SECTION("ReceiversGetTheirPreferredCodec")
+  {
+    receivers.receiveChannelRequest(
+      ChannelRequest{id3, id, std::nullopt, Codec::kLPC_i16}, 10);
+    receivers.setMulticastGroup(group);
+    CHECK(receivers.hasReceivers(Codec::kPCM_i16));
+    CHECK(receivers.hasReceivers(Codec::kLPC_i16));
+
+    receivers.send(packets.data(), packets.size(), Codec::kLPC_i16);
+    REQUIRE(1 == pInterface->batches.size());
+    REQUIRE(2 == pInterface->batches[0].size());
+    CHECK(endpoint3 == pInterface->batches[0][0].to);
+    CHECK(endpoint3 == pInterface->batches[0][1].to);
+
+    receivers.send(packets.data(), packets.size(), Codec::kPCM_i16);
+    REQUIRE(2 == pInterface->batches.size());
+    REQUIRE(2 == pInterface->batches[1].size());
+    CHECK(group == pInterface->batches[1][0].to);
+    CHECK(group == pInterface->batches[1][1].to);
+  }
+
+  SECTION("ParityOnlyForReceiversThatAcceptIt")
+  {
+    receivers.receiveChannelRequest(
+      ChannelRequest{id3, id, std::nullopt, Codec::kPCM_i16, true}, 10);
+    receivers.receiveChannelRequest(ChannelRequest{id1, id, std::nullopt}, 10);
+    receivers.setMulticastGroup(group);
+
+    const auto parityPackets =
+      std::array<Packet, 2>{{{data.data(), 1}, {data.data(), 3, true}}};
+    receivers.send(parityPackets.data(), parityPackets.size());
+
+    // id2 receives via the group, where parity is always sent
+    REQUIRE(1 == pInterface->batches.size());
+    const auto& batch = pInterface->batches[0];
+    REQUIRE(5 == batch.size());
+    CHECK(3 == std::count_if(batch.begin(),
+                             batch.end(),
+                             [](const auto& d) { return d.numBytes == 1; }));
+    CHECK(group == batch[3].to);
+    CHECK(endpoint3 == batch[4].to);
+  }
+
+  SECTION("MulticastReceiversShareTheirCodec")
+  {
+    receivers.receiveChannelRequest(ChannelRequest{id1, id, group, Codec::kLPC_i16}, 10);
+    receivers.setMulticastGroup(group);
+
+    // One of the multicast receivers only supports PCM
+    CHECK(!receivers.hasReceivers(Codec::kLPC_i16));
+
+    receivers.receiveChannelRequest(ChannelRequest{id2, id, group, Codec::kLPC_i16}, 10);
+    CHECK(receivers.hasReceivers(Codec::kLPC_i16));
+
+    receivers.send(packets.data(), packets.size(), Codec::kLPC_i16);
+    REQUIRE(1 == pInterface->batches.size());
+    REQUIRE(2 == pInterface->batches[0].size());
+    CHECK(group == pInterface->batches[0][0].to);
+    CHECK(group == pInterface->batches[0][1].to);
+  }
+
+  SECTION("TimingOnlyIfAllReceiversOfTheCodecAcceptIt")
+  {
+    receivers.setMulticastGroup(group);
+    CHECK(!receivers.acceptsTiming(Codec::kPCM_i16));
+
+    receivers.receiveChannelRequest(
+      ChannelRequest{id3, id, std::nullopt, Codec::kLPC_i16, false, true}, 10);
+    CHECK(receivers.acceptsTiming(Codec::kLPC_i16));
+    CHECK(!receivers.acceptsTiming(Codec::kPCM_i16));
+    CHECK(!receivers.acceptsTiming(Codec::kADPCM_i4));
+
+    receivers.receiveChannelRequest(
+      ChannelRequest{id1, id, group, Codec::kPCM_i16, false, true}, 10);
+    CHECK(!receivers.acceptsTiming(Codec::kPCM_i16));
+
+    receivers.receiveChannelRequest(
+      ChannelRequest{id2, id, group, Codec::kPCM_i16, false, true}, 10);
+    CHECK(receivers.acceptsTiming(Codec::kPCM_i16));
+  }
+
+  SECTION("UnicastForOtherGroups")
+  {
+    receivers.setMulticastGroup(multicastGroup(id1));
+    receivers.send(packets.data(), packets.size());
+
+    REQUIRE(1 == pInterface->batches.size());
+    CHECK(6 == pInterface->batches[0].size());
+  }
+}
+
 } // namespace link_audio
 } // namespace ableton
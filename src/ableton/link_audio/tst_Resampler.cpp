@@ -0,0 +1,210 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/Resampler.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace
+{
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::vector<float> sine(const double frequency,
+                        const double sampleRate,
+                        const size_t numFrames,
+                        const size_t numChannels)
+{
+  auto samples = std::vector<float>(numFrames * numChannels);
+  for (auto frame = size_t{0}; frame < numFrames; ++frame)
+  {
+    for (auto channel = size_t{0}; channel < numChannels; ++channel)
+    {
+      samples[frame * numChannels + channel] = static_cast<float>(
+        0.5 * std::sin(2. * kPi * frequency * static_cast<double>(frame) / sampleRate));
+    }
+  }
+  return samples;
+}
+
+std::vector<float> resample(Resampler& resampler,
+                            const std::vector<float>& input,
+                            const size_t numChannels,
+                            const size_t blockSize)
+{
+  auto output = std::vector<float>(
+    static_cast<size_t>(static_cast<double>(input.size()) / resampler.ratio()) + 64);
+  auto numInputFrames = size_t{0};
+  auto numOutputFrames = size_t{0};
+  const auto totalInputFrames = input.size() / numChannels;
+  const auto totalOutputFrames = output.size() / numChannels;
+  auto result = Resampler::Result{1, 1};
+  while (result.numInputFrames + result.numOutputFrames > 0)
+  {
+    result =
+      resampler.process(input.data() + numInputFrames * numChannels,
+                        std::min(blockSize, totalInputFrames - numInputFrames),
+                        output.data() + numOutputFrames * numChannels,
+                        std::min(blockSize, totalOutputFrames - numOutputFrames));
+    numInputFrames += result.numInputFrames;
+    numOutputFrames += result.numOutputFrames;
+  }
+  output.resize(numOutputFrames * numChannels);
+  return output;
+}
+
+// Signal to noise ratio of a resampled sine, leaving out the filter's settling time
+double sineSnr(const ResamplerQuality quality,
+               const double inputRate,
+               const double outputRate,
+               const double frequency)
+{
+  auto resampler = Resampler(1, quality, inputRate / outputRate);
+  const auto input = sine(frequency, inputRate, size_t(inputRate / 2), 1);
+  const auto output = resample(resampler, input, 1, 256);
+  const auto expected = sine(frequency, outputRate, output.size(), 1);
+
+  auto signal = 0.;
+  auto noise = 0.;
+  for (auto i = size_t(outputRate / 100); i < output.size(); ++i)
+  {
+    signal += double(expected[i]) * expected[i];
+    noise += (double(output[i]) - expected[i]) * (double(output[i]) - expected[i]);
+  }
+  return 10. * std::log10(signal / noise);
+}
+
+} // namespace
+
+TEST_CASE("Resampler | SineQuality")
+{
+  const auto rates = std::vector<double>{44100., 48000., 96000.};
+  const auto presets = {std::make_tuple(ResamplerQuality::kLow, 60., 0.),
+                        std::make_tuple(ResamplerQuality::kMedium, 70., 70.),
+                        std::make_tuple(ResamplerQuality::kHigh, 95., 95.)};
+  for (const auto& [quality, minSnr, minHighSnr] : presets)
+  {
+    for (const auto inputRate : rates)
+    {
+      for (const auto outputRate : rates)
+      {
+        INFO(int(quality) << ": " << inputRate << " -> " << outputRate);
+        CHECK(sineSnr(quality, inputRate, outputRate, 1000.) > minSnr);
+        CHECK(sineSnr(quality, inputRate, outputRate, 15000.) > minHighSnr);
+      }
+    }
+  }
+}
+
+TEST_CASE("Resampler | RejectsAliases")
+{
+  // 30 kHz can't be represented at 48 kHz
+  auto resampler = Resampler(1, ResamplerQuality::kMedium, 2.);
+  const auto output = resample(resampler, sine(30000., 96000., 48000, 1), 1, 256);
+
+  auto power = 0.;
+  for (auto i = size_t{480}; i < output.size(); ++i)
+  {
+    power += double(output[i]) * output[i];
+  }
+  const auto rms = std::sqrt(power / static_cast<double>(output.size() - 480));
+  CHECK(20. * std::log10(rms / (0.5 / std::sqrt(2.))) < -60.);
+}
+
+TEST_CASE("Resampler | Streaming")
+{
+  const auto input = sine(440., 44100., 10000, 2);
+  auto resampler = Resampler(2, ResamplerQuality::kMedium, 44100. / 48000.);
+  const auto expected = resample(resampler, input, 2, 100000);
+  CHECK(expected.size() / 2 + resampler.latency() >= 10000 * 48000 / 44100 - 1);
+
+  // Block sizes don't change the result
+  for (const auto blockSize : {1u, 7u, 64u, 1000u})
+  {
+    resampler.reset();
+    CHECK(expected == resample(resampler, input, 2, blockSize));
+  }
+}
+
+TEST_CASE("Resampler | ContinuousRatioChanges")
+{
+  // Following a drifting clock doesn't interrupt the signal
+  const auto input = sine(440., 48000., 48000, 1);
+  auto resampler = Resampler(1, ResamplerQuality::kMedium, 1.);
+  auto output = std::vector<float>(48000);
+  auto numInputFrames = size_t{0};
+  auto numOutputFrames = size_t{0};
+  auto inputPos = 0.;
+  auto maxError = 0.;
+  while (numOutputFrames + 64 <= output.size() && numInputFrames + 64 <= input.size())
+  {
+    const auto drift = std::sin(static_cast<double>(numOutputFrames) / 1000.);
+    resampler.setRatio(1. + 0.001 * drift);
+    const auto result = resampler.process(
+      input.data() + numInputFrames, 64, output.data() + numOutputFrames, 64);
+    for (auto i = numOutputFrames; i < numOutputFrames + result.numOutputFrames; ++i)
+    {
+      const auto expected = 0.5 * std::sin(2. * kPi * 440. * inputPos / 48000.);
+      if (i > resampler.latency())
+      {
+        maxError = std::max(maxError, std::abs(expected - output[i]));
+      }
+      inputPos += resampler.ratio();
+    }
+    numInputFrames += result.numInputFrames;
+    numOutputFrames += result.numOutputFrames;
+  }
+  CHECK(maxError < 1e-3);
+}
+
+TEST_CASE("Resampler | Benchmark", "[.benchmark]")
+{
+  const auto numFrames = size_t{512};
+  const auto input = sine(1000., 48000., numFrames, 2);
+  auto output = std::vector<float>(numFrames * 2 * 3);
+
+  for (const auto& [name, quality] :
+       {std::make_pair("low", ResamplerQuality::kLow),
+        std::make_pair("medium", ResamplerQuality::kMedium),
+        std::make_pair("high", ResamplerQuality::kHigh)})
+  {
+    for (const auto& [inputRate, outputRate] : {std::make_pair(44100., 48000.),
+                                                std::make_pair(48000., 44100.),
+                                                std::make_pair(48000., 96000.),
+                                                std::make_pair(96000., 48000.)})
+    {
+      auto resampler = Resampler(2, quality, inputRate / outputRate);
+      BENCHMARK(std::string{name} + " " + std::to_string(int(inputRate)) + " -> "
+                + std::to_string(int(outputRate)) + ", 512 stereo input frames")
+      {
+        return resampler.process(input.data(), numFrames, output.data(), numFrames * 3)
+          .numOutputFrames;
+      };
+    }
+  }
+}
+
+} // namespace link_audio
+} // namespace ableton
@@ -23,6 +23,8 @@
 #include <ableton/util/Injected.hpp>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -43,10 +45,11 @@ struct Successor
   void operator()(const SampleFormat* samples,
                   const AudioBuffer::Chunks& chunks,
                   const uint32_t numChannels,
-                  const uint32_t /*sampleRate*/,
-                  const Id /*sessionId*/)
+                  const uint32_t sampleRate,
+                  const Id sessionId)
 
   {
+    packets.emplace_back(chunks.size(), numChannels, sampleRate, sessionId);
     auto samplesBegin = samples;
     for (const auto& chunk : chunks)
     {
@@ -96,6 +99,8 @@ struct Successor
 
   Samples receivedSamples;
   AudioBuffer::Chunks receivedChunks;
+  // Number of chunks, number of channels, sample rate and session id of each packet
+  std::vector<std::tuple<size_t, uint32_t, uint32_t, Id>> packets;
 };
 
 } // namespace
@@ -267,6 +272,210 @@ TEST_CASE("Resizer")
       }
     }
   }
+
+  SECTION("EdgeCases")
+  {
+    // 32 bytes hold 16 mono or 8 stereo frames
+    constexpr auto kMaxNumBytes = 16 * sizeof(SampleFormat);
+    const auto tempo = link::Tempo{60.0 * sampleRate}; // 1 beat per frame
+    const auto sessionId = Id::random<platforms::stl::Random>();
+
+    auto samples = Samples(64);
+    std::iota(samples.begin(), samples.end(), SampleFormat{0});
+
+    SECTION("ExactMultipleOfPacketSize")
+    {
+      auto successor = Successor<1>{};
+      auto resizer =
+        Resizer<SampleFormat, Successor<1>&, kMaxNumBytes>(util::injectRef(successor));
+
+      resizer(samples.data(), 16, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data() + 16, 32, 1, sampleRate, link::Beats{16.}, tempo, sessionId);
+
+      CHECK(3 == successor.packets.size());
+      CHECK(Samples(samples.begin(), samples.begin() + 48) == successor.receivedSamples);
+      successor.checkMonotonic();
+
+      // Nothing is cached, so a format change must not produce another packet
+      resizer(samples.data(), 0, 2, sampleRate, link::Beats{48.}, tempo, sessionId);
+      CHECK(3 == successor.packets.size());
+    }
+
+    SECTION("SingleFrames")
+    {
+      auto successor = Successor<2>{};
+      auto resizer =
+        Resizer<SampleFormat, Successor<2>&, kMaxNumBytes>(util::injectRef(successor));
+
+      for (auto frame = 0u; frame < 32; ++frame)
+      {
+        resizer(samples.data() + 2 * frame,
+                1,
+                2,
+                sampleRate,
+                link::Beats{static_cast<double>(frame)},
+                tempo,
+                sessionId);
+      }
+
+      CHECK(4 == successor.packets.size());
+      CHECK(samples == successor.receivedSamples);
+      successor.checkMonotonic();
+    }
+
+    SECTION("ZeroFrames")
+    {
+      auto successor = Successor<1>{};
+      auto resizer =
+        Resizer<SampleFormat, Successor<1>&, kMaxNumBytes>(util::injectRef(successor));
+
+      resizer(samples.data(), 0, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data(), 4, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data(), 0, 1, sampleRate, link::Beats{4.}, tempo, sessionId);
+      resizer(samples.data() + 4, 12, 1, sampleRate, link::Beats{4.}, tempo, sessionId);
+
+      REQUIRE(1 == successor.packets.size());
+      CHECK(1 == std::get<0>(successor.packets[0]));
+      CHECK(16 == successor.receivedChunks[0].numFrames);
+      CHECK(Samples(samples.begin(), samples.begin() + 16) == successor.receivedSamples);
+    }
+
+    SECTION("FormatChangesFlush")
+    {
+      auto successor = Successor<1>{};
+      auto resizer =
+        Resizer<SampleFormat, Successor<1>&, kMaxNumBytes>(util::injectRef(successor));
+      const auto otherSessionId = Id::random<platforms::stl::Random>();
+
+      resizer(samples.data(), 4, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data() + 4, 2, 2, sampleRate, link::Beats{4.}, tempo, sessionId);
+      resizer(samples.data() + 8,
+              4,
+              2,
+              2 * sampleRate,
+              link::Beats{6.},
+              tempo,
+              sessionId);
+      resizer(samples.data() + 16,
+              4,
+              2,
+              2 * sampleRate,
+              link::Beats{0.},
+              tempo,
+              otherSessionId);
+      resizer(samples.data(), 0, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+
+      using Packet = std::tuple<size_t, uint32_t, uint32_t, Id>;
+      CHECK(std::vector<Packet>{{1, 1, sampleRate, sessionId},
+                                {1, 2, sampleRate, sessionId},
+                                {1, 2, 2 * sampleRate, sessionId},
+                                {1, 2, 2 * sampleRate, otherSessionId}}
+            == successor.packets);
+      CHECK(Samples(samples.begin(), samples.begin() + 24) == successor.receivedSamples);
+    }
+
+    SECTION("TempoChangeWithBeatJumpStartsChunk")
+    {
+      // Leave room for a second chunk in addition to 16 frames
+      constexpr auto kChunkBytes = 26u;
+      REQUIRE(kChunkBytes == sizeInByteStream(AudioBuffer::Chunk{}));
+
+      auto successor = Successor<1>{};
+      auto resizer = Resizer<SampleFormat, Successor<1>&, kMaxNumBytes + kChunkBytes>(
+        util::injectRef(successor));
+      const auto otherTempo = link::Tempo{tempo.bpm() / 2};
+
+      resizer(samples.data(), 4, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data() + 4,
+              4,
+              1,
+              sampleRate,
+              link::Beats{10.},
+              otherTempo,
+              sessionId);
+      resizer(samples.data() + 8,
+              8,
+              1,
+              sampleRate,
+              link::Beats{12.},
+              otherTempo,
+              sessionId);
+
+      REQUIRE(1 == successor.packets.size());
+      REQUIRE(2 == successor.receivedChunks.size());
+      CHECK(4 == successor.receivedChunks[0].numFrames);
+      CHECK(tempo == successor.receivedChunks[0].tempo);
+      CHECK(link::Beats{0.} == successor.receivedChunks[0].beginBeats);
+      CHECK(12 == successor.receivedChunks[1].numFrames);
+      CHECK(otherTempo == successor.receivedChunks[1].tempo);
+      CHECK(link::Beats{10.} == successor.receivedChunks[1].beginBeats);
+      CHECK(successor.receivedChunks[0].count < successor.receivedChunks[1].count);
+    }
+
+    SECTION("ChunkWithoutRoomStartsPacket")
+    {
+      auto successor = Successor<1>{};
+      auto resizer =
+        Resizer<SampleFormat, Successor<1>&, kMaxNumBytes>(util::injectRef(successor));
+      const auto otherTempo = link::Tempo{tempo.bpm() / 2};
+
+      // A second chunk would leave less room than the four frames already cached
+      resizer(samples.data(), 4, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data() + 4,
+              16,
+              1,
+              sampleRate,
+              link::Beats{10.},
+              otherTempo,
+              sessionId);
+
+      using Packet = std::tuple<size_t, uint32_t, uint32_t, Id>;
+      CHECK(std::vector<Packet>{{1, 1, sampleRate, sessionId},
+                                {1, 1, sampleRate, sessionId}}
+            == successor.packets);
+      REQUIRE(2 == successor.receivedChunks.size());
+      CHECK(4 == successor.receivedChunks[0].numFrames);
+      CHECK(16 == successor.receivedChunks[1].numFrames);
+      CHECK(otherTempo == successor.receivedChunks[1].tempo);
+      CHECK(Samples(samples.begin(), samples.begin() + 20) == successor.receivedSamples);
+    }
+
+    SECTION("ContinuousTempoChangeKeepsChunk")
+    {
+      auto successor = Successor<1>{};
+      auto resizer =
+        Resizer<SampleFormat, Successor<1>&, kMaxNumBytes>(util::injectRef(successor));
+      const auto otherTempo = link::Tempo{tempo.bpm() / 2};
+
+      resizer(samples.data(), 4, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data() + 4,
+              12,
+              1,
+              sampleRate,
+              link::Beats{4.},
+              otherTempo,
+              sessionId);
+
+      REQUIRE(1 == successor.packets.size());
+      REQUIRE(1 == successor.receivedChunks.size());
+      CHECK(16 == successor.receivedChunks[0].numFrames);
+      CHECK(tempo == successor.receivedChunks[0].tempo);
+    }
+
+    SECTION("ChunkContinuesAcrossPackets")
+    {
+      auto successor = Successor<1>{};
+      auto resizer =
+        Resizer<SampleFormat, Successor<1>&, kMaxNumBytes>(util::injectRef(successor));
+
+      resizer(samples.data(), 10, 1, sampleRate, link::Beats{0.}, tempo, sessionId);
+      resizer(samples.data() + 10, 22, 1, sampleRate, link::Beats{10.}, tempo, sessionId);
+
+      REQUIRE(2 == successor.receivedChunks.size());
+      CHECK(link::Beats{16.} == successor.receivedChunks[1].beginBeats);
+      CHECK(successor.receivedChunks[0].count + 1 == successor.receivedChunks[1].count);
+    }
+  }
 }
 
 } // namespace link_audio
@@ -0,0 +1,242 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/Sequencer.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace ableton
+{
+namespace link_audio
+{
+namespace
+{
+
+constexpr double kPi = 3.14159265358979323846;
+
+struct Chunk
+{
+  uint64_t count;
+  link::Beats beginBeats;
+  bool isConcealed;
+  std::vector<int16_t> samples;
+};
+
+struct MockSuccessor
+{
+  void operator()(BufferCallbackHandle<Buffer<int16_t>> handle)
+  {
+    const auto& buffer = handle.mBuffer;
+    chunks.push_back({buffer.mCount,
+                      buffer.mBeginBeats,
+                      buffer.mIsConcealed,
+                      {handle.mpSamples,
+                       handle.mpSamples + buffer.mNumFrames * buffer.mNumChannels}});
+  }
+
+  void lost(const uint64_t numBuffers) { numLost += numBuffers; }
+
+  std::vector<uint64_t> counts() const
+  {
+    auto result = std::vector<uint64_t>{};
+    for (const auto& chunk : chunks)
+    {
+      result.push_back(chunk.count);
+    }
+    return result;
+  }
+
+  std::vector<Chunk> chunks;
+  uint64_t numLost = 0;
+};
+
+// A stereo sine stream at 120 bpm, where chunk n starts at frame n * kNumFrames
+struct Stream
+{
+  static constexpr auto kNumFrames = uint32_t{128};
+  static constexpr auto kSampleRate = uint32_t{48000};
+  static constexpr auto kPeriod = 100.;
+
+  static int16_t sample(const size_t frame)
+  {
+    return static_cast<int16_t>(
+      std::lround(10000. * std::sin(2. * kPi * static_cast<double>(frame) / kPeriod)));
+  }
+
+  Stream()
+    : buffer(kNumFrames * 2)
+  {
+    buffer.mSampleRate = kSampleRate;
+    buffer.mNumChannels = 2;
+    buffer.mNumFrames = kNumFrames;
+    buffer.mTempo = link::Tempo{120.};
+    buffer.mSessionId = Id{};
+  }
+
+  BufferCallbackHandle<Buffer<int16_t>> operator()(const uint64_t count)
+  {
+    for (auto frame = size_t{0}; frame < kNumFrames; ++frame)
+    {
+      buffer.mSamples[2 * frame] = sample(count * kNumFrames + frame);
+      buffer.mSamples[2 * frame + 1] = sample(count * kNumFrames + frame);
+    }
+    buffer.mCount = count;
+    buffer.mBeginBeats = beginBeats(count);
+    return {buffer, buffer.mSamples.data()};
+  }
+
+  static link::Beats beginBeats(const uint64_t count)
+  {
+    return link::Beats{static_cast<double>(count * kNumFrames) / kSampleRate * 2.};
+  }
+
+  Buffer<int16_t> buffer;
+};
+
+} // namespace
+
+TEST_CASE("Sequencer")
+{
+  auto successor = MockSuccessor{};
+  auto sequencer = Sequencer<MockSuccessor&>(util::injectRef(successor), 4096);
+  auto stream = Stream{};
+
+  const auto send = [&](const std::vector<uint64_t>& counts)
+  {
+    for (const auto count : counts)
+    {
+      sequencer(stream(count));
+    }
+  };
+
+  SECTION("InOrder")
+  {
+    send({10, 11, 12});
+    CHECK(std::vector<uint64_t>{10, 11, 12} == successor.counts());
+    CHECK(0 == successor.numLost);
+  }
+
+  SECTION("Reordered")
+  {
+    send({10, 12, 13, 11, 14});
+    CHECK(std::vector<uint64_t>{10, 11, 12, 13, 14} == successor.counts());
+    CHECK(0 == successor.numLost);
+  }
+
+  SECTION("Duplicates")
+  {
+    send({10, 11, 11, 10, 13, 13, 12});
+    CHECK(std::vector<uint64_t>{10, 11, 12, 13} == successor.counts());
+    CHECK(3 == sequencer.numDroppedBuffers());
+  }
+
+  SECTION("LossWithoutConcealment")
+  {
+    auto counts = std::vector<uint64_t>{10};
+    for (auto count = uint64_t{12}; count < 12 + Sequencer<MockSuccessor&>::kWindowSize;
+         ++count)
+    {
+      counts.push_back(count);
+    }
+    send(counts);
+
+    // The window is full, so 11 is given up on
+    CHECK(1 == successor.numLost);
+    CHECK(1 == sequencer.numLostBuffers());
+    CHECK(counts == successor.counts());
+
+    // And dropped if it arrives after all
+    send({11});
+    CHECK(counts == successor.counts());
+  }
+
+  SECTION("LossAfterTheHoldTime")
+  {
+    // One chunk may be held back
+    sequencer.setMaxHoldTime(std::chrono::microseconds{
+      int64_t{Stream::kNumFrames} * 1000000 / Stream::kSampleRate});
+
+    send({10, 12, 11, 14});
+    CHECK(std::vector<uint64_t>{10, 11, 12} == successor.counts());
+
+    send({15});
+    CHECK(std::vector<uint64_t>{10, 11, 12, 14, 15} == successor.counts());
+    CHECK(1 == successor.numLost);
+  }
+
+  SECTION("Flush")
+  {
+    send({10, 12, 13, 15});
+    CHECK(std::vector<uint64_t>{10} == successor.counts());
+
+    sequencer.flush();
+    CHECK(std::vector<uint64_t>{10, 12, 13, 15} == successor.counts());
+    CHECK(2 == successor.numLost);
+
+    send({16});
+    CHECK(std::vector<uint64_t>{10, 12, 13, 15, 16} == successor.counts());
+  }
+
+  SECTION("Concealment")
+  {
+    sequencer.setConcealmentEnabled(true);
+    for (auto count = uint64_t{0}; count < 40; ++count)
+    {
+      if (count != 20 && count != 21)
+      {
+        send({count});
+      }
+    }
+
+    CHECK(2 == successor.numLost);
+    REQUIRE(40 == successor.chunks.size());
+    for (auto i = size_t{0}; i < successor.chunks.size(); ++i)
+    {
+      const auto& chunk = successor.chunks[i];
+      CHECK(i == chunk.count);
+      CHECK((i == 20 || i == 21) == chunk.isConcealed);
+    }
+
+    // The concealed chunks fill the gap in time and continue the sine
+    for (const auto count : {uint64_t{20}, uint64_t{21}})
+    {
+      const auto& chunk = successor.chunks[count];
+      CHECK(std::abs((Stream::beginBeats(count) - chunk.beginBeats).microBeats()) <= 2);
+      REQUIRE(2 * Stream::kNumFrames == chunk.samples.size());
+      for (auto frame = size_t{0}; frame < Stream::kNumFrames; ++frame)
+      {
+        const auto expected = Stream::sample(count * Stream::kNumFrames + frame);
+        CHECK(std::abs(expected - chunk.samples[2 * frame]) < 500);
+        CHECK(chunk.samples[2 * frame] == chunk.samples[2 * frame + 1]);
+      }
+    }
+  }
+
+  SECTION("NewStream")
+  {
+    send({10, 11, 5000, 5001, 12});
+    CHECK(std::vector<uint64_t>{10, 11, 5000, 5001, 12} == successor.counts());
+    CHECK(0 == successor.numLost);
+  }
+}
+
+} // namespace link_audio
+} // namespace ableton
@@ -0,0 +1,184 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/link_audio/Sink.hpp>
+#include <ableton/platforms/stl/Random.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+
+namespace ableton
+{
+namespace link_audio
+{
+
+TEST_CASE("Sink")
+{
+  using Random = platforms::stl::Random;
+
+  auto numCommits = size_t{0};
+  auto sink = Sink{"sink", 256, Id::random<Random>(), [&] { ++numCommits; }, 16};
+  CHECK(16 == sink.queueDepth());
+
+  SECTION("NoMemoryWithoutReceivers")
+  {
+    CHECK(0 == sink.arenaSize());
+    CHECK(nullptr == sink.retainBuffer());
+  }
+
+  SECTION("BuffersShareOneArena")
+  {
+    sink.setIsConnected(true);
+    CHECK(256 * 16 == sink.arenaSize());
+
+    auto pFirst = sink.retainBuffer();
+    REQUIRE(pFirst != nullptr);
+    CHECK(256 == pFirst->mSamples.size());
+    sink.releaseBuffer();
+
+    auto pSecond = sink.retainBuffer();
+    REQUIRE(pSecond != nullptr);
+    CHECK(pFirst->mSamples.data() + 256 == pSecond->mSamples.data());
+    sink.releaseBuffer();
+  }
+
+  SECTION("ArenaIsReleasedAfterTheAudioThreadLetGoOfIt")
+  {
+    sink.setIsConnected(true);
+    REQUIRE(sink.retainBuffer() != nullptr);
+
+    // The audio thread may still write to its buffer
+    sink.setIsConnected(false);
+    sink.releaseBuffer();
+    sink.setIsConnected(false);
+    CHECK(256 * 16 == sink.arenaSize());
+
+    CHECK(nullptr == sink.retainBuffer());
+    CHECK(1 == numCommits);
+    sink.setIsConnected(false);
+    CHECK(0 == sink.arenaSize());
+  }
+
+  SECTION("ReconnectingKeepsTheArena")
+  {
+    sink.setIsConnected(true);
+    sink.setIsConnected(false);
+    sink.setIsConnected(true);
+
+    CHECK(sink.retainBuffer() != nullptr);
+    CHECK(0 == numCommits);
+  }
+
+  SECTION("ArenaFollowsTheRequestedBufferSize")
+  {
+    sink.setIsConnected(true);
+    sink.requestMaxNumSamples(512);
+    sink.setIsConnected(true);
+
+    CHECK(nullptr == sink.retainBuffer());
+    sink.setIsConnected(true);
+    CHECK(512 * 16 == sink.arenaSize());
+
+    auto pBuffer = sink.retainBuffer();
+    REQUIRE(pBuffer != nullptr);
+    CHECK(512 == pBuffer->mSamples.size());
+
+    // Smaller requests don't shrink the buffers
+    sink.requestMaxNumSamples(128);
+    CHECK(512 == sink.maxNumSamples());
+  }
+
+  SECTION("StatsCountCommittedAndDroppedBuffers")
+  {
+    const auto timeline =
+      link::Timeline{link::Tempo{120.}, link::Beats{0.}, std::chrono::microseconds{0}};
+    const auto sessionId = Id::random<Random>();
+    sink.setIsConnected(true);
+
+    for (auto i = 0; i < 16; ++i)
+    {
+      REQUIRE(sink.retainBuffer() != nullptr);
+      sink.releaseAndCommitBuffer(timeline, sessionId, 0., 4., 128, 2, 48000);
+    }
+
+    // The queue is full
+    CHECK(nullptr == sink.retainBuffer());
+
+    const auto stats = sink.stats();
+    CHECK(16 == stats.numCommittedBuffers);
+    CHECK(1 == stats.numDroppedBuffers);
+    CHECK(16 == stats.maxNumQueuedBuffers);
+  }
+
+  SECTION("WideSinksUseLargerMessagesByDefault")
+  {
+    const auto timeline =
+      link::Timeline{link::Tempo{120.}, link::Beats{0.}, std::chrono::microseconds{0}};
+    const auto sessionId = Id::random<Random>();
+    sink.setIsConnected(true);
+    CHECK(v1::kDefaultMaxAudioBufferMessageSize == sink.maxMessageSize());
+
+    REQUIRE(sink.retainBuffer() != nullptr);
+    sink.releaseAndCommitBuffer(timeline, sessionId, 0., 4., 16, 8, 48000);
+    CHECK(v1::kDefaultMaxAudioBufferMessageSize == sink.maxMessageSize());
+
+    REQUIRE(sink.retainBuffer() != nullptr);
+    sink.releaseAndCommitBuffer(timeline, sessionId, 0., 4., 4, 64, 48000);
+    CHECK(v1::kMaxMessageSize == sink.maxMessageSize());
+
+    // An explicit size applies to any number of channels
+    sink.setMaxMessageSize(800);
+    CHECK(800 == sink.maxMessageSize());
+  }
+
+  SECTION("CommitTimeIsTheGhostTimeIfMeasured")
+  {
+    const auto timeline =
+      link::Timeline{link::Tempo{120.}, link::Beats{0.}, std::chrono::microseconds{0}};
+    const auto sessionId = Id::random<Random>();
+    sink.setIsConnected(true);
+
+    CHECK(!sink.measuresLatency());
+    REQUIRE(sink.retainBuffer() != nullptr);
+    sink.releaseAndCommitBuffer(timeline, sessionId, 0., 4., 128, 2, 48000);
+
+    auto ghostTime = std::chrono::microseconds{1000};
+    auto timedSink = Sink{"timed",
+                          256,
+                          Id::random<Random>(),
+                          {},
+                          16,
+                          [&] { return ghostTime; }};
+    timedSink.setIsConnected(true);
+    CHECK(timedSink.measuresLatency());
+    REQUIRE(timedSink.retainBuffer() != nullptr);
+    timedSink.releaseAndCommitBuffer(timeline, sessionId, 0., 4., 128, 2, 48000);
+    ghostTime = std::chrono::microseconds{2000};
+
+    auto reader = sink.reader();
+    REQUIRE(reader.retainSlot());
+    CHECK(!reader[0]->mCommitTime);
+
+    auto timedReader = timedSink.reader();
+    REQUIRE(timedReader.retainSlot());
+    CHECK(std::chrono::microseconds{1000} == timedReader[0]->mCommitTime);
+    CHECK(std::chrono::microseconds{2000} == timedSink.ghostTime());
+  }
+}
+
+} // namespace link_audio
+} // namespace ableton
@@ -92,6 +92,11 @@ struct TestHandler
     ++audioBufferCallsCount;
   }
 
+  template <typename It>
+  void receiveAudioParity(It, It)
+  {
+  }
+
   std::vector<std::pair<ChannelRequest, uint8_t>> channelRequests;
   std::vector<std::pair<ChannelStopRequest, uint8_t>> channelStopRequests;
   size_t audioBufferCallsCount = 0u;
@@ -435,6 +440,11 @@ TEST_CASE("UdpMessenger")
     CHECK(2 == observer.announcements.size());
     CHECK(observer.announcements[0].networkQuality
           < observer.announcements[1].networkQuality);
+    CHECK(0 == observer.announcements[0].networkStats.numSamples);
+    CHECK(1 == observer.announcements[1].networkStats.numSamples);
+    CHECK(std::chrono::microseconds(0)
+          < observer.announcements[1].networkStats.roundTripTime);
+    CHECK(std::chrono::microseconds(0) == observer.announcements[1].networkStats.jitter);
   }
 
   SECTION("ReceiveAnnouncementFromKnownReceiver")
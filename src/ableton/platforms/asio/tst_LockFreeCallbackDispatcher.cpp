@@ -0,0 +1,110 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/platforms/asio/LockFreeCallbackDispatcher.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace ableton
+{
+namespace platforms
+{
+namespace LINK_ASIO_NAMESPACE
+{
+namespace
+{
+
+struct ThreadFactory
+{
+  template <typename Callable>
+  static std::thread makeThread(std::string, Callable&& f)
+  {
+    return std::thread(std::forward<Callable>(f));
+  }
+};
+
+using Dispatcher = LockFreeCallbackDispatcher<std::function<void()>,
+                                              std::chrono::milliseconds,
+                                              ThreadFactory>;
+
+// Far longer than the test waits for a dispatched callback
+constexpr auto kFallbackPeriod = std::chrono::seconds(60);
+constexpr auto kTimeout = std::chrono::seconds(10);
+
+} // namespace
+
+TEST_CASE("LockFreeCallbackDispatcher")
+{
+  std::mutex mutex;
+  std::condition_variable condition;
+  auto numCalls = 0;
+  auto isBlocked = false;
+
+  auto dispatcher = Dispatcher{[&]
+                               {
+                                 std::unique_lock<std::mutex> lock(mutex);
+                                 ++numCalls;
+                                 condition.notify_all();
+                                 condition.wait(lock, [&] { return !isBlocked; });
+                               },
+                               kFallbackPeriod};
+  dispatcher.start();
+
+  const auto waitForCalls = [&](const int n)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return condition.wait_for(lock, kTimeout, [&] { return numCalls >= n; });
+  };
+
+  SECTION("Invoke")
+  {
+    dispatcher.invoke();
+    CHECK(waitForCalls(1));
+  }
+
+  SECTION("InvokeWhileTheCallbackRuns")
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      isBlocked = true;
+    }
+    dispatcher.invoke();
+    REQUIRE(waitForCalls(1));
+
+    // The dispatcher thread is busy and can't be notified
+    dispatcher.invoke();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      isBlocked = false;
+    }
+    condition.notify_all();
+
+    CHECK(waitForCalls(2));
+  }
+
+  dispatcher.stop();
+}
+
+} // namespace LINK_ASIO_NAMESPACE
+} // namespace platforms
+} // namespace ableton
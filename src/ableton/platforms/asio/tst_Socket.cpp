@@ -0,0 +1,179 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+
+#include <ableton/platforms/asio/Socket.hpp>
+#include <ableton/test/CatchWrapper.hpp>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace ableton
+{
+namespace platforms
+{
+namespace LINK_ASIO_NAMESPACE
+{
+namespace
+{
+
+namespace net = ::LINK_ASIO_NAMESPACE;
+
+constexpr auto kMaxPacketSize = std::size_t{1200};
+using TestSocket = Socket<kMaxPacketSize>;
+
+TestSocket makeLoopbackSocket(net::io_context& io)
+{
+  auto socket = TestSocket{io, net::ip::udp::v4()};
+  socket.mpImpl->mSocket.bind({net::ip::address_v4::loopback(), 0});
+  return socket;
+}
+
+// Collects the sizes of the received datagrams and keeps receiving until the expected
+// number of datagrams has arrived
+struct Receiver
+{
+  void operator()(const discovery::UdpEndpoint&,
+                  const uint8_t* const begin,
+                  const uint8_t* const end)
+  {
+    pSizes->push_back(static_cast<std::size_t>(std::distance(begin, end)));
+    if (pSizes->size() < numExpected)
+    {
+      pSocket->receive(*this);
+    }
+  }
+
+  TestSocket* pSocket;
+  std::size_t numExpected;
+  std::vector<std::size_t>* pSizes;
+};
+
+std::vector<discovery::UdpDatagram> makeDatagrams(const std::vector<uint8_t>& data,
+                                                  const discovery::UdpEndpoint& to,
+                                                  const std::size_t numDatagrams)
+{
+  auto datagrams = std::vector<discovery::UdpDatagram>{};
+  for (auto i = std::size_t{0}; i < numDatagrams; ++i)
+  {
+    datagrams.push_back({data.data(), 1 + i % data.size(), to});
+  }
+  return datagrams;
+}
+
+} // namespace
+
+TEST_CASE("Socket")
+{
+  net::io_context io;
+  auto sender = makeLoopbackSocket(io);
+  auto receiver = makeLoopbackSocket(io);
+  const auto data = std::vector<uint8_t>(kMaxPacketSize, 42);
+
+  SECTION("BatchedSendAndReceive")
+  {
+    const auto numDatagrams = std::size_t{100};
+    const auto datagrams = makeDatagrams(data, receiver.endpoint(), numDatagrams);
+    CHECK(numDatagrams == sender.send(datagrams.data(), datagrams.size()));
+
+    auto sizes = std::vector<std::size_t>{};
+    receiver.receive(Receiver{&receiver, numDatagrams, &sizes});
+    io.run_for(std::chrono::seconds(5));
+
+    REQUIRE(numDatagrams == sizes.size());
+    for (auto i = std::size_t{0}; i < numDatagrams; ++i)
+    {
+      CHECK(datagrams[i].numBytes == sizes[i]);
+    }
+  }
+
+  SECTION("StopReceiving")
+  {
+    const auto datagrams = makeDatagrams(data, receiver.endpoint(), 10);
+    sender.send(datagrams.data(), datagrams.size());
+
+    auto sizes = std::vector<std::size_t>{};
+    receiver.receive(Receiver{&receiver, 1, &sizes});
+    io.run_for(std::chrono::milliseconds(200));
+
+    CHECK(1 == sizes.size());
+  }
+}
+
+TEST_CASE("Socket | Benchmark", "[.benchmark]")
+{
+  // Small datagrams make sure a whole round fits into the socket's receive buffer
+  constexpr auto kNumDatagrams = std::size_t{128};
+  const auto data = std::vector<uint8_t>(64, 42);
+
+  net::io_context io;
+  auto sender = makeLoopbackSocket(io);
+
+  BENCHMARK_ADVANCED("One datagram per wakeup")(Catch::Benchmark::Chronometer meter)
+  {
+    auto socket = net::ip::udp::socket{io, {net::ip::address_v4::loopback(), 0}};
+    const auto datagrams = makeDatagrams(data, socket.local_endpoint(), kNumDatagrams);
+    auto buffer = std::array<uint8_t, kMaxPacketSize>{};
+    auto from = net::ip::udp::endpoint{};
+    auto numReceived = std::size_t{0};
+
+    std::function<void(const net::error_code&, std::size_t)> onReceive =
+      [&](const net::error_code& error, std::size_t)
+    {
+      if (!error && ++numReceived < kNumDatagrams)
+      {
+        socket.async_receive_from(net::buffer(buffer), from, onReceive);
+      }
+    };
+
+    meter.measure(
+      [&]
+      {
+        sender.send(datagrams.data(), datagrams.size());
+        numReceived = 0;
+        socket.async_receive_from(net::buffer(buffer), from, onReceive);
+        io.restart();
+        io.run();
+        return numReceived;
+      });
+  };
+
+  BENCHMARK_ADVANCED("Drain queued datagrams")(Catch::Benchmark::Chronometer meter)
+  {
+    auto receiver = makeLoopbackSocket(io);
+    const auto datagrams = makeDatagrams(data, receiver.endpoint(), kNumDatagrams);
+    auto sizes = std::vector<std::size_t>{};
+
+    meter.measure(
+      [&]
+      {
+        sender.send(datagrams.data(), datagrams.size());
+        sizes.clear();
+        receiver.receive(Receiver{&receiver, kNumDatagrams, &sizes});
+        io.restart();
+        io.run();
+        return sizes.size();
+      });
+  };
+}
+
+} // namespace LINK_ASIO_NAMESPACE
+} // namespace platforms
+} // namespace ableton
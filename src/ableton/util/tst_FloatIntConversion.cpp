@@ -20,6 +20,8 @@
 
 #include <ableton/test/CatchWrapper.hpp>
 #include <ableton/util/FloatIntConversion.hpp>
+#include <random>
+#include <vector>
 
 namespace ableton
 {
@@ -66,5 +68,200 @@ TEST_CASE("IntToDouble")
   REQUIRE(Approx(-1.0) == int16ToFloat<double>(std::numeric_limits<int16_t>::min()));
 }
 
+namespace
+{
+
+template <typename T>
+std::vector<T> testSignal(const size_t numSamples)
+{
+  auto rng = std::mt19937{42};
+  auto dist = std::uniform_real_distribution<T>{T{-1.5}, T{1.5}};
+  auto signal = std::vector<T>(numSamples);
+  std::generate(signal.begin(), signal.end(), [&] { return dist(rng); });
+
+  // Values exactly between two steps, at the limits and beyond
+  const auto edges = std::vector<T>{T{0},
+                                    T{-0},
+                                    T{0.5} / 32768,
+                                    T{-0.5} / 32768,
+                                    T{1.5} / 32768,
+                                    T{-1.5} / 32768,
+                                    T{32766.5} / 32768,
+                                    T{-32767.5} / 32768,
+                                    T{1},
+                                    T{-1},
+                                    T{2},
+                                    T{-2}};
+  std::copy(edges.begin(), edges.end(), signal.begin());
+  return signal;
+}
+
+template <typename T>
+void testBulkFloatToInt16()
+{
+  // Use a length that is not a multiple of any vector width to cover the scalar tail
+  const auto signal = testSignal<T>(1003);
+  auto result = std::vector<int16_t>(signal.size());
+  floatToInt16(signal.data(), result.data(), signal.size());
+  for (auto i = 0u; i < signal.size(); ++i)
+  {
+    CHECK(floatToInt16(signal[i]) == result[i]);
+  }
+}
+
+template <typename T>
+void testBulkInt16ToFloat()
+{
+  auto signal = std::vector<int16_t>(65536 + 5);
+  for (auto i = 0u; i < signal.size(); ++i)
+  {
+    signal[i] = int16_t(i);
+  }
+  auto result = std::vector<T>(signal.size());
+  int16ToFloat(signal.data(), result.data(), signal.size());
+  for (auto i = 0u; i < signal.size(); ++i)
+  {
+    CHECK(int16ToFloat<T>(signal[i]) == result[i]);
+  }
+}
+
+template <typename T>
+void testPlanarFloatToInterleavedInt16(const size_t numChannels)
+{
+  const auto numFrames = size_t{301};
+  auto channels = std::vector<std::vector<T>>{};
+  auto pChannels = std::vector<const T*>{};
+  for (auto channel = 0u; channel < numChannels; ++channel)
+  {
+    channels.push_back(testSignal<T>(numFrames));
+    std::reverse(channels.back().begin(), channels.back().begin() + channel * 3);
+    pChannels.push_back(channels.back().data());
+  }
+
+  auto result = std::vector<int16_t>(numFrames * numChannels);
+  planarFloatToInterleavedInt16(pChannels.data(), result.data(), numFrames, numChannels);
+  for (auto frame = 0u; frame < numFrames; ++frame)
+  {
+    for (auto channel = 0u; channel < numChannels; ++channel)
+    {
+      CHECK(floatToInt16(channels[channel][frame])
+            == result[frame * numChannels + channel]);
+    }
+  }
+}
+
+template <typename T>
+void testInterleavedInt16ToPlanarFloat(const size_t numSourceChannels,
+                                       const std::vector<size_t>& channels)
+{
+  const auto numFrames = size_t{301};
+  auto interleaved = std::vector<int16_t>(numFrames * numSourceChannels);
+  for (auto i = 0u; i < interleaved.size(); ++i)
+  {
+    interleaved[i] = int16_t(i * 7);
+  }
+
+  auto result = std::vector<std::vector<T>>(channels.size(), std::vector<T>(numFrames));
+  auto pResult = std::vector<T*>{};
+  for (auto& channel : result)
+  {
+    pResult.push_back(channel.data());
+  }
+
+  interleavedInt16ToPlanarFloat(interleaved.data(),
+                                pResult.data(),
+                                numFrames,
+                                numSourceChannels,
+                                channels.data(),
+                                channels.size());
+  for (auto channel = 0u; channel < channels.size(); ++channel)
+  {
+    for (auto frame = 0u; frame < numFrames; ++frame)
+    {
+      CHECK(int16ToFloat<T>(interleaved[frame * numSourceChannels + channels[channel]])
+            == result[channel][frame]);
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("BulkFloatToInt")
+{
+  testBulkFloatToInt16<float>();
+}
+
+TEST_CASE("BulkDoubleToInt")
+{
+  testBulkFloatToInt16<double>();
+}
+
+TEST_CASE("BulkIntToFloat")
+{
+  testBulkInt16ToFloat<float>();
+}
+
+TEST_CASE("BulkIntToDouble")
+{
+  testBulkInt16ToFloat<double>();
+}
+
+TEST_CASE("PlanarFloatToInterleavedInt")
+{
+  SECTION("Mono")
+  {
+    testPlanarFloatToInterleavedInt16<float>(1);
+  }
+
+  SECTION("Stereo")
+  {
+    testPlanarFloatToInterleavedInt16<float>(2);
+  }
+
+  SECTION("Multichannel")
+  {
+    testPlanarFloatToInterleavedInt16<double>(5);
+  }
+}
+
+TEST_CASE("InterleavedIntToPlanarFloat")
+{
+  SECTION("Mono")
+  {
+    testInterleavedInt16ToPlanarFloat<float>(1, {0});
+  }
+
+  SECTION("Multichannel")
+  {
+    testInterleavedInt16ToPlanarFloat<double>(5, {0, 1, 2, 3, 4});
+  }
+
+  SECTION("ChannelSubset")
+  {
+    testInterleavedInt16ToPlanarFloat<float>(16, {15, 3, 3});
+  }
+}
+
+TEST_CASE("FloatIntConversion | Benchmark", "[.benchmark]")
+{
+  const auto signal = testSignal<float>(4096);
+  auto result = std::vector<int16_t>(signal.size());
+
+  BENCHMARK("Scalar")
+  {
+    for (auto i = 0u; i < signal.size(); ++i)
+    {
+      result[i] = floatToInt16(signal[i]);
+    }
+    return result.back();
+  };
+
+  BENCHMARK("Bulk")
+  {
+    floatToInt16(signal.data(), result.data(), signal.size());
+    return result.back();
+  };
+}
+
 } // namespace util
 } // namespace ableton
@@ -0,0 +1,191 @@
+/* Copyright 2025, Ableton AG, Berlin. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  If you would like to incorporate Link into a proprietary software application,
+ *  please contact <link-devs@ableton.com>.
+ */
+
+#include <ableton/test/CatchWrapper.hpp>
+#include <ableton/util/Locked.hpp>
+#include <ableton/util/RcuSlot.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ableton
+{
+namespace util
+{
+namespace
+{
+
+constexpr auto kNumTestOps = 1u << 16u;
+
+// Marks itself as destroyed, so readers can tell if they use a dead value
+struct Tracked
+{
+  explicit Tracked(const uint32_t s)
+    : seed{s}
+    , pIsAlive{std::make_shared<std::atomic<bool>>(true)}
+  {
+  }
+
+  Tracked(Tracked&&) = default;
+
+  ~Tracked()
+  {
+    if (pIsAlive)
+    {
+      *pIsAlive = false;
+    }
+  }
+
+  uint32_t seed;
+  std::shared_ptr<std::atomic<bool>> pIsAlive;
+};
+
+} // namespace
+
+TEST_CASE("RcuSlot")
+{
+  SECTION("ReadsInitialValue")
+  {
+    RcuSlot<int> slot{42};
+
+    auto value = 0;
+    slot.read([&](const int v) { value = v; });
+    CHECK(42 == value);
+  }
+
+  SECTION("ReadsLastWrittenValue")
+  {
+    RcuSlot<int> slot{42};
+
+    auto value = 0;
+    slot.write(43);
+    slot.read([&](const int v) { value = v; });
+    CHECK(43 == value);
+
+    slot.write(44);
+    slot.write(45);
+    slot.read([&](const int v) { value = v; });
+    CHECK(45 == value);
+  }
+
+  SECTION("OldValueIsDestroyedWhenWriteReturns")
+  {
+    RcuSlot<Tracked> slot{Tracked{0}};
+
+    auto pIsAlive = std::shared_ptr<std::atomic<bool>>{};
+    slot.read([&](const Tracked& t) { pIsAlive = t.pIsAlive; });
+    slot.write(Tracked{1});
+    CHECK(!*pIsAlive);
+  }
+
+  SECTION("ConcurrentReadsNeverSeeDestroyedValues")
+  {
+    RcuSlot<Tracked> slot{Tracked{0}};
+
+    auto writer = std::thread(
+      [&]()
+      {
+        for (auto i = 1u; i < kNumTestOps; ++i)
+        {
+          slot.write(Tracked{i});
+        }
+      });
+
+    auto prevSeed = 0u;
+    auto numDeadReads = 0u;
+    auto numOutOfOrderReads = 0u;
+    for (auto i = 0u; i < kNumTestOps; ++i)
+    {
+      slot.read(
+        [&](const Tracked& t)
+        {
+          numDeadReads += *t.pIsAlive ? 0u : 1u;
+          numOutOfOrderReads += t.seed < prevSeed ? 1u : 0u;
+          prevSeed = t.seed;
+        });
+    }
+    writer.join();
+
+    CHECK(0 == numDeadReads);
+    CHECK(0 == numOutOfOrderReads);
+  }
+}
+
+TEST_CASE("RcuSlot | Benchmark", "[.benchmark]")
+{
+  // Readers calling a callback while another thread keeps replacing it
+  using Callback = std::function<void(uint32_t&)>;
+
+  auto counter = 0u;
+  const auto increment = Callback{[](uint32_t& c) { ++c; }};
+
+  RcuSlot<Callback> rcuSlot{increment};
+  Locked<Callback> locked{increment};
+
+  BENCHMARK("RcuSlot uncontended")
+  {
+    rcuSlot.read([&](const Callback& callback) { callback(counter); });
+    return counter;
+  };
+
+  BENCHMARK("Locked uncontended")
+  {
+    locked.update([&](const Callback& callback) { callback(counter); });
+    return counter;
+  };
+
+  auto isRunning = std::atomic<bool>{true};
+  auto writers = std::vector<std::thread>{};
+  for (auto i = 0; i < 2; ++i)
+  {
+    writers.emplace_back(
+      [&]()
+      {
+        while (isRunning)
+        {
+          rcuSlot.write(increment);
+          locked.update([&](Callback& callback) { callback = increment; });
+        }
+      });
+  }
+
+  BENCHMARK("RcuSlot contended")
+  {
+    rcuSlot.read([&](const Callback& callback) { callback(counter); });
+    return counter;
+  };
+
+  BENCHMARK("Locked contended")
+  {
+    locked.update([&](const Callback& callback) { callback(counter); });
+    return counter;
+  };
+
+  isRunning = false;
+  for (auto& writer : writers)
+  {
+    writer.join();
+  }
+}
+
+} // namespace util
+} // namespace ableton